@@ -0,0 +1,54 @@
+# author     Dubsky Tomas
+
+# Compares 2 and 3 frames in flight by running the same benchmark
+# against a build with each setting:
+# Syntax:
+#     cmake -D BUILD_DIR=<directory>
+#           [ -D GENERATOR=<generator> ]
+#           [ -D BENCHMARK_ARGS=<RenderBenchmarks arguments> ]
+#           -P CompareFramesInFlight.cmake
+# The builds are placed in frames_in_flight_2 and frames_in_flight_3 subdirectories
+# of BUILD_DIR and are reused by later comparisons.
+# BENCHMARK_ARGS is a list that defaults to "sprites;--headless".
+# Both benchmarks run on the default Vulkan device, set VK_ICD_FILENAMES
+# to run them on a specific driver (e.g. lavapipe).
+
+if(NOT DEFINED BUILD_DIR)
+    message(FATAL_ERROR "BUILD_DIR has to be defined")
+endif()
+if(NOT DEFINED BENCHMARK_ARGS)
+    set(BENCHMARK_ARGS "sprites;--headless")
+endif()
+if(DEFINED GENERATOR)
+    set(generator_args "-G" "${GENERATOR}")
+endif()
+get_filename_component(source_dir "${CMAKE_CURRENT_LIST_DIR}/../.." ABSOLUTE)
+
+foreach(frames_in_flight IN ITEMS 2 3)
+    set(build_dir "${BUILD_DIR}/frames_in_flight_${frames_in_flight}")
+    execute_process(
+        COMMAND "${CMAKE_COMMAND}" -S "${source_dir}" -B "${build_dir}" ${generator_args}
+                -D CMAKE_BUILD_TYPE=Release
+                -D REALENGINE_FRAMES_IN_FLIGHT=${frames_in_flight}
+        COMMAND_ERROR_IS_FATAL ANY
+    )
+    execute_process(
+        COMMAND "${CMAKE_COMMAND}" --build "${build_dir}"
+                --config Release --target RenderBenchmarks
+        COMMAND_ERROR_IS_FATAL ANY
+    )
+    find_program(benchmark_${frames_in_flight} RenderBenchmarks
+        PATHS "${build_dir}" "${build_dir}/Release"
+        NO_DEFAULT_PATH
+        REQUIRED
+    )
+endforeach()
+
+# Run the benchmarks after both builds so that they do not compete with compilation
+foreach(frames_in_flight IN ITEMS 2 3)
+    message(STATUS "Running with ${frames_in_flight} frames in flight")
+    execute_process(
+        COMMAND "${benchmark_${frames_in_flight}}" ${BENCHMARK_ARGS}
+        COMMAND_ERROR_IS_FATAL ANY
+    )
+endforeach()
@@ -6,14 +6,23 @@
 #        TARGET <target>
 #        PACKAGE_DIR <directory_name>
 #        [ INDEX_FILE <file_path> ]
+#        [ FORMAT <native|7z> ]
+#        [ TEXTURES <png|container|mips> ]
 #        INPUT_DIRS <directory_name>...
 #     )
 # The index is a C++ header file containing re::ResourceIDs of the packaged files.
+# The package is composed in the engine-native memory-mappable format by default.
+# FORMAT 7z selects the legacy compressed and 'encrypted' 7z archive instead.
+# PNGs are packaged as they are by default. TEXTURES container transcodes them
+# to GPU-ready texture containers, TEXTURES mips also generates mip chains.
+# Only transcode PNGs if all of them are loaded as textures (not as data).
+# Font atlases described by <font>.atlases.json files are precomputed
+# into the font_atlases subdirectory of the package directory.
 # The target will be named <target>_PackageResources.
 # The packaging will be done in non-debug builds only as debug build of RealEngine
 # reads the unpackaged data.
 function(real_target_package_resources)
-    set(one_value_args TARGET PACKAGE_DIR INDEX_FILE)
+    set(one_value_args TARGET PACKAGE_DIR INDEX_FILE FORMAT TEXTURES)
     set(multi_value_args INPUT_DIRS)
     cmake_parse_arguments(ARG "" "${one_value_args}" "${multi_value_args}" ${ARGN})
 
@@ -21,6 +30,12 @@ function(real_target_package_resources)
         get_target_property(base_dir ${ARG_TARGET} realproject_base_dir_rel)
         set(ARG_INDEX_FILE "${CMAKE_CURRENT_BINARY_DIR}/${base_dir}/${ARG_TARGET}/ResourceIndex.gen.hpp")
     endif()
+    if(NOT DEFINED ARG_FORMAT)
+        set(ARG_FORMAT "native")
+    endif()
+    if(NOT DEFINED ARG_TEXTURES)
+        set(ARG_TEXTURES "png")
+    endif()
     set(output_package "${ARG_PACKAGE_DIR}/package.dat")
     get_target_property(realengine_source_dir RealEngine HEADER_DIRS_realproject_public_headers)
 
@@ -40,6 +55,8 @@ function(real_target_package_resources)
                     "$<LIST:TRANSFORM,${ARG_INPUT_DIRS},PREPEND,--in=>"
                     -o ${ARG_PACKAGE_DIR}
                     --index ${ARG_INDEX_FILE}
+                    --format ${ARG_FORMAT}
+                    --textures ${ARG_TEXTURES}
         DEPENDS ResourcePackager
         BYPRODUCTS ${ARG_INDEX_FILE}
         COMMENT "Packaging resources for ${ARG_TARGET}..."
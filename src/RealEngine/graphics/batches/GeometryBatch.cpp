@@ -4,7 +4,7 @@
 #include <RealEngine/graphics/batches/GeometryBatch.hpp>
 #include <RealEngine/graphics/batches/shaders/AllShaders.gen.hpp>
 #include <RealEngine/graphics/commands/CommandBuffer.hpp>
-#include <RealEngine/graphics/synchronization/DoubleBuffered.hpp>
+#include <RealEngine/graphics/synchronization/MultiBuffered.hpp>
 
 using enum vk::BufferUsageFlagBits;
 using enum vk::MemoryPropertyFlagBits;
@@ -64,7 +64,7 @@ GeometryBatch::GeometryBatch(const GeometryBatchCreateInfo& createInfo)
 }
 
 void GeometryBatch::begin() {
-    m_nextVertexIndex = m_maxVertices * FrameDoubleBufferingState::writeIndex();
+    m_nextVertexIndex = m_maxVertices * FrameMultiBufferingState::writeIndex();
 }
 
 void GeometryBatch::end() {
@@ -79,7 +79,7 @@ void GeometryBatch::addVertices(std::span<const VertexPoCo> vertices) {
     m_nextVertexIndex += vertices.size();
     assert(
         (m_nextVertexIndex -
-         m_maxVertices * FrameDoubleBufferingState::writeIndex()) <= m_maxVertices
+         m_maxVertices * FrameMultiBufferingState::writeIndex()) <= m_maxVertices
     );
 }
 
@@ -90,8 +90,8 @@ void GeometryBatch::draw(const CommandBuffer& cb, const glm::mat4& mvpMat) {
         *m_pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0u, mvpMat
     );
     cb->draw(
-        m_nextVertexIndex - m_maxVertices * FrameDoubleBufferingState::writeIndex(),
-        1u, m_maxVertices * FrameDoubleBufferingState::writeIndex(), 0u
+        m_nextVertexIndex - m_maxVertices * FrameMultiBufferingState::writeIndex(),
+        1u, m_maxVertices * FrameMultiBufferingState::writeIndex(), 0u
     );
 }
 
@@ -2,17 +2,60 @@
  *  @author    Dubsky Tomas
  */
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
 
 #include <glm/common.hpp>
 
 #include <RealEngine/graphics/batches/SpriteBatch.hpp>
 #include <RealEngine/graphics/batches/shaders/AllShaders.gen.hpp>
-#include <RealEngine/graphics/synchronization/DoubleBuffered.hpp>
-
-using enum vk::DescriptorBindingFlagBits;
+#include <RealEngine/graphics/synchronization/MultiBuffered.hpp>
+#include <RealEngine/jobs/JobSystem.hpp>
+#include <RealEngine/renderer/BindlessTextures.hpp>
 
 namespace re {
 
+namespace {
+
+PipelineGraphicsSources spriteSources(SpriteBatchBackend backend) {
+    switch (backend) {
+    case SpriteBatchBackend::Instanced:
+        return PipelineGraphicsSources{
+            .vert = glsl::spriteInstanced_vert, .frag = glsl::sprite_frag
+        };
+    case SpriteBatchBackend::Tessellation:
+    default:
+        return PipelineGraphicsSources{
+            .vert = glsl::sprite_vert,
+            .tesc = glsl::sprite_tesc,
+            .tese = glsl::sprite_tese,
+            .frag = glsl::sprite_frag
+        };
+    }
+}
+
+/**
+ * @brief Gets the slot of the texture in the bindless texture table
+ */
+uint32_t bindlessSlot(const Texture& tex) {
+    assert(
+        tex.bindlessSlot() != BindlessTextures::k_noSlot &&
+        "Textures of sprites must be sampled and have a sampler"
+    );
+    return tex.bindlessSlot();
+}
+
+constexpr uint32_t k_radixBits    = 8;
+constexpr uint32_t k_radixSize    = 1u << k_radixBits;
+constexpr size_t k_radixBlockSize = 16384; ///< Entries counted/scattered by a job
+static_assert(
+    BindlessTextures::k_maxCapacity <= (1u << 16),
+    "Texture slots must fit into the lower half of the sort key"
+);
+
+} // namespace
+
 SpriteBatch::SpriteBatch(const SpriteBatchCreateInfo& createInfo)
     : m_spritesBuf(BufferCreateInfo{
           .allocFlags = vma::AllocationCreateFlagBits::eMapped |
@@ -21,142 +64,294 @@ SpriteBatch::SpriteBatch(const SpriteBatchCreateInfo& createInfo)
           .usage = eVertexBuffer
       })
     , m_maxSprites(createInfo.maxSprites)
-    , m_maxTextures(createInfo.maxTextures)
-    , m_pipelineLayout(createPipelineLayout(createInfo.maxTextures))
+    , m_backend(createInfo.backend)
+    , m_order(createInfo.order)
+    , m_pipelineLayout(createPipelineLayout(createInfo))
     , m_pipeline(createPipeline(m_pipelineLayout, createInfo)) {
-    m_texToIndex.reserve(createInfo.maxTextures);
 }
 
 void SpriteBatch::clearAndBeginFirstBatch() {
-    m_nextSpriteIndex = m_maxSprites * FrameDoubleBufferingState::writeIndex();
-    m_textureIndexOffset = m_maxTextures * FrameDoubleBufferingState::writeIndex();
-    m_texToIndex.clear();
+    m_nextSpriteIndex = m_maxSprites * FrameMultiBufferingState::writeIndex();
     nextBatch();
 }
 
 void SpriteBatch::nextBatch() {
-    m_batchFirstSpriteIndex = m_nextSpriteIndex;
+    m_batchFirstSpriteIndex = m_nextSpriteIndex.load(std::memory_order_relaxed);
 }
 
 void SpriteBatch::drawBatch(const CommandBuffer& cb, const glm::mat4& mvpMat) {
+    if (m_order == SpriteOrder::LayerThenTexture) {
+        sortBatch();
+    }
     cb->bindPipeline(vk::PipelineBindPoint::eGraphics, *m_pipeline);
     cb->bindDescriptorSets(
-        vk::PipelineBindPoint::eGraphics, *m_pipelineLayout, 0u, *m_descSet, {}
+        vk::PipelineBindPoint::eGraphics, *m_pipelineLayout, 0u,
+        bindlessTextures().descriptorSet(), {}
     );
     cb->bindVertexBuffers(0u, m_spritesBuf.buffer(), vk::DeviceSize{0});
-    cb->pushConstants<glm::mat4>(
-        *m_pipelineLayout, vk::ShaderStageFlagBits::eTessellationEvaluation, 0u, mvpMat
-    );
-    cb->draw(
-        m_nextSpriteIndex - m_batchFirstSpriteIndex, 1u, m_batchFirstSpriteIndex, 0u
+    unsigned int spriteCount = m_nextSpriteIndex.load(std::memory_order_relaxed) -
+                               m_batchFirstSpriteIndex;
+    if (m_backend == SpriteBatchBackend::Instanced) {
+        cb->pushConstants<glm::mat4>(
+            *m_pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0u, mvpMat
+        );
+        cb->draw(4u, spriteCount, 0u, m_batchFirstSpriteIndex);
+    } else {
+        cb->pushConstants<glm::mat4>(
+            *m_pipelineLayout, vk::ShaderStageFlagBits::eTessellationEvaluation, 0u,
+            mvpMat
+        );
+        cb->draw(spriteCount, 1u, m_batchFirstSpriteIndex, 0u);
+    }
+}
+
+SpriteBatch::Range SpriteBatch::reserve(unsigned int count) {
+    unsigned int first = m_nextSpriteIndex.fetch_add(count, std::memory_order_relaxed);
+    assert(
+        first + count <= m_maxSprites * (FrameMultiBufferingState::writeIndex() + 1) &&
+        "Used too many different sprites"
     );
+    return Range{*this, first, count};
 }
 
 void SpriteBatch::add(
     const Texture& tex, const glm::vec4& posSizeRect,
-    const glm::vec4& uvsSizeRect, Color col /* = k_white*/
+    const glm::vec4& uvsSizeRect, Color col /* = k_white*/, uint16_t layer /* = 0*/
 ) {
-    m_spritesBuf[nextSpriteIndex()] = Sprite{
-        .pos = posSizeRect, .uvs = uvsSizeRect, .tex = texToIndex(tex), .col = col
-    };
+    m_spritesBuf[nextSpriteIndex()] =
+        makeSprite(tex, posSizeRect, uvsSizeRect, col, layer);
+}
+
+void SpriteBatch::addSprite(
+    const SpriteStatic& sprite, glm::vec2 pos, Color col /* = k_white*/,
+    uint16_t layer /* = 0*/
+) {
+    m_spritesBuf[nextSpriteIndex()] = makeSprite(sprite, pos, col, layer);
 }
 
 void SpriteBatch::addSprite(
-    const SpriteStatic& sprite, glm::vec2 pos, Color col /* = k_white*/
+    const SpriteComplex& sprite, glm::vec2 pos, Color col /* = k_white*/,
+    uint16_t layer /* = 0*/
+) {
+    m_spritesBuf[nextSpriteIndex()] = makeSprite(sprite, pos, col, layer);
+}
+
+void SpriteBatch::addSubimage(
+    const TextureShaped& tex, glm::vec2 pos, glm::vec2 subimgSpr,
+    Color col /* = k_white*/, uint16_t layer /* = 0*/
 ) {
-    const auto& tex                 = sprite.texture();
-    m_spritesBuf[nextSpriteIndex()] = Sprite{
-        .pos = glm::vec4(pos - tex.pivot(), tex.subimageDims()),
-        .uvs = glm::vec4(
+    m_spritesBuf[nextSpriteIndex()] = makeSubimage(tex, pos, subimgSpr, col, layer);
+}
+
+SpriteBatch::Sprite SpriteBatch::makeSprite(
+    const Texture& tex, const glm::vec4& posSizeRect,
+    const glm::vec4& uvsSizeRect, Color col, uint16_t layer
+) {
+    return Sprite{
+        .pos   = posSizeRect,
+        .uvs   = uvsSizeRect,
+        .tex   = bindlessSlot(tex),
+        .col   = col,
+        .layer = layer
+    };
+}
+
+SpriteBatch::Sprite SpriteBatch::makeSprite(
+    const SpriteStatic& sprite, glm::vec2 pos, Color col, uint16_t layer
+) {
+    const auto& tex = sprite.texture();
+    return Sprite{
+        .pos   = glm::vec4(pos - tex.pivot(), tex.subimageDims()),
+        .uvs   = glm::vec4(
             glm::floor(sprite.subimageSprite()) / tex.subimagesSpritesCount(),
             glm::vec2(1.0f, 1.0f) / tex.subimagesSpritesCount()
         ),
-        .tex = texToIndex(tex),
-        .col = col
+        .tex   = bindlessSlot(tex),
+        .col   = col,
+        .layer = layer
     };
 }
 
-void SpriteBatch::addSprite(
-    const SpriteComplex& sprite, glm::vec2 pos, Color col /* = k_white*/
+SpriteBatch::Sprite SpriteBatch::makeSprite(
+    const SpriteComplex& sprite, glm::vec2 pos, Color col, uint16_t layer
 ) {
-    const auto& tex                 = sprite.texture();
-    m_spritesBuf[nextSpriteIndex()] = Sprite{
-        .pos = glm::vec4(
+    const auto& tex = sprite.texture();
+    return Sprite{
+        .pos   = glm::vec4(
             pos - tex.pivot() * sprite.scale(), tex.subimageDims() * sprite.scale()
         ),
-        .uvs = glm::vec4(
+        .uvs   = glm::vec4(
             glm::floor(sprite.subimageSprite()) / tex.subimagesSpritesCount(),
             glm::vec2(1.0f, 1.0f) / tex.subimagesSpritesCount()
         ),
-        .tex = texToIndex(tex),
-        .col = col
+        .tex   = bindlessSlot(tex),
+        .col   = col,
+        .layer = layer
     };
 }
 
-void SpriteBatch::addSubimage(
-    const TextureShaped& tex, glm::vec2 pos, glm::vec2 subimgSpr,
-    Color col /* = k_white*/
+SpriteBatch::Sprite SpriteBatch::makeSubimage(
+    const TextureShaped& tex, glm::vec2 pos, glm::vec2 subimgSpr, Color col,
+    uint16_t layer
 ) {
-    m_spritesBuf[nextSpriteIndex()] = Sprite{
-        .pos = glm::vec4(pos - tex.pivot(), tex.subimageDims()),
-        .uvs = glm::vec4(
+    return Sprite{
+        .pos   = glm::vec4(pos - tex.pivot(), tex.subimageDims()),
+        .uvs   = glm::vec4(
             glm::floor(subimgSpr) / tex.subimagesSpritesCount(),
             glm::vec2(1.0f, 1.0f) / tex.subimagesSpritesCount()
         ),
-        .tex = texToIndex(tex),
-        .col = col
+        .tex   = bindlessSlot(tex),
+        .col   = col,
+        .layer = layer
     };
 }
 
 unsigned int SpriteBatch::nextSpriteIndex() {
-    unsigned int rval = m_nextSpriteIndex++;
+    unsigned int rval = m_nextSpriteIndex.fetch_add(1, std::memory_order_relaxed);
     assert(
-        rval < m_maxSprites * (FrameDoubleBufferingState::writeIndex() + 1) &&
+        rval < m_maxSprites * (FrameMultiBufferingState::writeIndex() + 1) &&
         "Used too many different sprites"
     );
     return rval;
 }
 
-unsigned int SpriteBatch::texToIndex(const Texture& tex) {
-    if (auto it = std::find(m_texToIndex.begin(), m_texToIndex.end(), &tex);
-        it != m_texToIndex.end()) {
-        return m_textureIndexOffset + (it - m_texToIndex.begin());
-    } else {
-        unsigned int newIndex = m_texToIndex.size() + m_textureIndexOffset;
-        assert(
-            m_texToIndex.size() < m_maxTextures &&
-            "Used too many different textures"
-        );
-        m_descSet.write(
-            vk::DescriptorType::eCombinedImageSampler, 0u, newIndex, tex,
-            vk::ImageLayout::eShaderReadOnlyOptimal
-        );
-        m_texToIndex.emplace_back(&tex);
-        return newIndex;
+void SpriteBatch::sortBatch() {
+    unsigned int first = m_batchFirstSpriteIndex;
+    unsigned int count = m_nextSpriteIndex.load(std::memory_order_relaxed) - first;
+    if (count < 2) {
+        return;
+    }
+
+    // Layer is the primary key, texture is the secondary
+    m_sortEntries.resize(count);
+    m_sortScratch.resize(count);
+    for (unsigned int i = 0; i < count; ++i) {
+        const Sprite& sprite = m_spritesBuf[first + i];
+        uint32_t key         = (sprite.layer << 16) | sprite.tex;
+        m_sortEntries[i]     = SortEntry{.key = key, .index = i};
+    }
+
+    // LSD radix sort, blocks of entries are counted and scattered in parallel
+    JobSystem& jobSystem = JobSystem::shared();
+    size_t blockCount    = (count + k_radixBlockSize - 1) / k_radixBlockSize;
+    std::vector<std::array<uint32_t, k_radixSize>> offsets(blockCount);
+    auto blockRange = [&](size_t block) {
+        size_t begin = block * k_radixBlockSize;
+        return std::pair{begin, std::min<size_t>(count, begin + k_radixBlockSize)};
+    };
+    for (uint32_t shift = 0; shift < 32; shift += k_radixBits) {
+        // Count the digits in each block
+        jobSystem.parallelFor(0, blockCount, 1, [&](size_t block, size_t) {
+            auto& counts = offsets[block];
+            counts.fill(0);
+            auto [begin, end] = blockRange(block);
+            for (size_t i = begin; i < end; ++i) {
+                counts[(m_sortEntries[i].key >> shift) & (k_radixSize - 1)]++;
+            }
+        });
+        // Skip the pass if all keys have the same digit
+        uint32_t firstDigit = (m_sortEntries[0].key >> shift) & (k_radixSize - 1);
+        uint32_t sameCount  = 0;
+        for (const auto& counts : offsets) { sameCount += counts[firstDigit]; }
+        if (sameCount == count) {
+            continue;
+        }
+        // Convert the counts to offsets, each digit holds its blocks in order
+        uint32_t offset = 0;
+        for (uint32_t digit = 0; digit < k_radixSize; ++digit) {
+            for (auto& counts : offsets) {
+                offset += std::exchange(counts[digit], offset);
+            }
+        }
+        // Scatter the entries, this keeps the sort stable
+        jobSystem.parallelFor(0, blockCount, 1, [&](size_t block, size_t) {
+            auto& dsts        = offsets[block];
+            auto [begin, end] = blockRange(block);
+            for (size_t i = begin; i < end; ++i) {
+                const SortEntry& entry = m_sortEntries[i];
+                m_sortScratch[dsts[(entry.key >> shift) & (k_radixSize - 1)]++] = entry;
+            }
+        });
+        m_sortEntries.swap(m_sortScratch);
+    }
+
+    // Reorder the sprites
+    m_sortedSprites.resize(count);
+    for (unsigned int i = 0; i < count; ++i) {
+        m_sortedSprites[i] = m_spritesBuf[first + m_sortEntries[i].index];
+    }
+    for (unsigned int i = 0; i < count; ++i) {
+        m_spritesBuf[first + i] = m_sortedSprites[i];
     }
 }
 
-PipelineLayout SpriteBatch::createPipelineLayout(unsigned int maxTextures) {
+SpriteBatch::Range::Range(SpriteBatch& batch, unsigned int first, unsigned int count)
+    : m_batch(&batch)
+    , m_next(first)
+    , m_end(first + count) {
+}
+
+SpriteBatch::Range::Range(Range&& other) noexcept
+    : m_batch(other.m_batch)
+    , m_next(other.m_next)
+    , m_end(other.m_end) {
+    other.m_next = other.m_end;
+}
+
+SpriteBatch::Range::~Range() {
+    // Unused slots become empty sprites which produce no fragments
+    for (; m_next < m_end; ++m_next) { m_batch->m_spritesBuf[m_next] = Sprite{}; }
+}
+
+void SpriteBatch::Range::add(
+    const Texture& tex, const glm::vec4& posSizeRect,
+    const glm::vec4& uvsSizeRect, Color col /* = k_white*/, uint16_t layer /* = 0*/
+) {
+    write(m_batch->makeSprite(tex, posSizeRect, uvsSizeRect, col, layer));
+}
+
+void SpriteBatch::Range::addSprite(
+    const SpriteStatic& sprite, glm::vec2 pos, Color col /* = k_white*/,
+    uint16_t layer /* = 0*/
+) {
+    write(m_batch->makeSprite(sprite, pos, col, layer));
+}
+
+void SpriteBatch::Range::addSprite(
+    const SpriteComplex& sprite, glm::vec2 pos, Color col /* = k_white*/,
+    uint16_t layer /* = 0*/
+) {
+    write(m_batch->makeSprite(sprite, pos, col, layer));
+}
+
+void SpriteBatch::Range::addSubimage(
+    const TextureShaped& tex, glm::vec2 pos, glm::vec2 subimgSpr,
+    Color col /* = k_white*/, uint16_t layer /* = 0*/
+) {
+    write(m_batch->makeSubimage(tex, pos, subimgSpr, col, layer));
+}
+
+void SpriteBatch::Range::write(const Sprite& sprite) {
+    assert(m_next < m_end && "Added more sprites than reserved");
+    m_batch->m_spritesBuf[m_next++] = sprite;
+}
+
+PipelineLayout SpriteBatch::createPipelineLayout(
+    const SpriteBatchCreateInfo& createInfo
+) {
     // Specialization constants
     static constexpr vk::SpecializationMapEntry specMapEntry{0u, 0u, 4ull};
-    unsigned int totalTextures = maxTextures * k_maxFramesInFlight;
-    static constexpr vk::DescriptorBindingFlags bindingFlags = {
-        eUpdateUnusedWhilePending | ePartiallyBound
-    };
-    auto bindingFlagsArray = vk::ArrayProxy<vk::DescriptorBindingFlags>(bindingFlags
-    );
+    uint32_t textureCount = bindlessTextures().capacity();
+    // Textures are sampled from the bindless texture table
+    vk::DescriptorSetLayout texturesLayout = bindlessTextures().descriptorSetLayout();
     return PipelineLayout{
         PipelineLayoutCreateInfo{
-            .descriptorBindingFlags = {bindingFlagsArray},
-            .specializationInfo =
-                vk::SpecializationInfo{1u, &specMapEntry, sizeof(totalTextures), &totalTextures}
+            .specializationInfo = vk::SpecializationInfo{
+                1u, &specMapEntry, sizeof(textureCount), &textureCount
+            },
+            .externalSetLayouts = texturesLayout
         },
-        PipelineGraphicsSources{
-            .vert = glsl::sprite_vert,
-            .tesc = glsl::sprite_tesc,
-            .tese = glsl::sprite_tese,
-            .frag = glsl::sprite_frag
-        }
+        spriteSources(createInfo.backend)
     };
 }
 
@@ -164,12 +359,12 @@ Pipeline SpriteBatch::createPipeline(
     const PipelineLayout& pipelineLayout, const SpriteBatchCreateInfo& createInfo
 ) {
     // Vertex input
-    static constexpr std::array k_bindings =
-        std::to_array<vk::VertexInputBindingDescription>({{
-            0u,                          // Binding index
-            sizeof(Sprite),              // Stride
-            vk::VertexInputRate::eVertex // Input rate
-        }});
+    bool instanced = createInfo.backend == SpriteBatchBackend::Instanced;
+    vk::VertexInputBindingDescription binding{
+        0u,             // Binding index
+        sizeof(Sprite), // Stride
+        instanced ? vk::VertexInputRate::eInstance : vk::VertexInputRate::eVertex
+    };
     static constexpr std::array k_attributes =
         std::to_array<vk::VertexInputAttributeDescription>(
             {{
@@ -197,28 +392,24 @@ Pipeline SpriteBatch::createPipeline(
                  offsetof(Sprite, col) // Relative offset
              }}
         );
-    vk::PipelineVertexInputStateCreateInfo vertexInput{{}, k_bindings, k_attributes};
+    vk::PipelineVertexInputStateCreateInfo vertexInput{{}, binding, k_attributes};
     // Specialization constants
     static constexpr vk::SpecializationMapEntry k_specMapEntry{0u, 0u, 4ull};
-    unsigned int totalTextures = createInfo.maxTextures * k_maxFramesInFlight;
+    uint32_t textureCount = bindlessTextures().capacity();
     vk::SpecializationInfo specInfo{
-        1u, &k_specMapEntry, sizeof(totalTextures), &totalTextures
+        1u, &k_specMapEntry, sizeof(textureCount), &textureCount
     };
     return Pipeline{
         PipelineGraphicsCreateInfo{
             .specializationInfo = &specInfo,
             .vertexInput        = &vertexInput,
-            .topology           = vk::PrimitiveTopology::ePatchList,
-            .patchControlPoints = 1u,
+            .topology           = instanced ? vk::PrimitiveTopology::eTriangleStrip
+                                            : vk::PrimitiveTopology::ePatchList,
+            .patchControlPoints = instanced ? 0u : 1u,
             .pipelineLayout     = *pipelineLayout,
             .renderPassSubpass  = createInfo.renderPassSubpass,
         },
-        PipelineGraphicsSources{
-            .vert = glsl::sprite_vert,
-            .tesc = glsl::sprite_tesc,
-            .tese = glsl::sprite_tese,
-            .frag = glsl::sprite_frag
-        }
+        spriteSources(createInfo.backend)
     };
 }
 
@@ -2,6 +2,8 @@
  *  @author    Dubsky Tomas
  */
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <vector>
 
 #include <glm/mat4x4.hpp>
@@ -10,12 +12,48 @@
 
 #include <RealEngine/graphics/batches/Sprite.hpp>
 #include <RealEngine/graphics/buffers/BufferMapped.hpp>
-#include <RealEngine/graphics/descriptors/DescriptorSet.hpp>
 #include <RealEngine/graphics/pipelines/Pipeline.hpp>
 #include <RealEngine/graphics/pipelines/PipelineLayout.hpp>
 
 namespace re {
 
+/**
+ * @brief Selects how SpriteBatch expands sprites into quads
+ */
+enum class SpriteBatchBackend {
+    /**
+     * @brief Each sprite is a patch that is expanded by tessellation shaders
+     * @note  Requires the tessellationShader feature of the device
+     */
+    Tessellation,
+    /**
+     * @brief Each sprite is an instance of a 4-vertex triangle strip
+     * @note  Does not use tessellation, which is slow or unavailable on some
+     *        GPUs and software rasterizers
+     */
+    Instanced
+};
+
+/**
+ * @brief Selects the order in which SpriteBatch draws sprites of a batch
+ */
+enum class SpriteOrder {
+    /**
+     * @brief Sprites are drawn in the order they were added in
+     */
+    Insertion,
+    /**
+     * @brief Sprites are drawn by their layers (lower first) and sprites in the
+     *        same layer are grouped by their textures
+     * @details The sort is stable so sprites with the same layer and texture
+     *          stay in the order they were added in. Grouping by textures
+     *          improves texture cache locality.
+     * @details The sprites are sorted by a radix sort on JobSystem::shared()
+     *          just before the batch is drawn.
+     */
+    LayerThenTexture
+};
+
 struct SpriteBatchCreateInfo {
     /**
      * @brief The renderpass that the batch will always draw in
@@ -26,23 +64,99 @@ struct SpriteBatchCreateInfo {
      */
     unsigned int maxSprites = 0u;
     /**
-     * @brief Maximum number of unique textures that the sprites
+     * @brief Selects how the sprites are expanded into quads
      */
-    unsigned int maxTextures = 0u;
+    SpriteBatchBackend backend = SpriteBatchBackend::Tessellation;
+    /**
+     * @brief Selects the order in which sprites of a batch are drawn
+     */
+    SpriteOrder order = SpriteOrder::Insertion;
 };
 
 /**
  * @brief   Draws 2D sprites efficiently
  * @details Can draw multiple batches per frame.
  *          Each batch has its own transformation matrix
+ * @details Textures of the sprites are sampled through the bindless texture
+ *          table, so any number of textures can be used and adding a sprite
+ *          only copies the slot of its texture.
+ * @details Sprites can be added from multiple threads at once, either directly
+ *          or into ranges reserved for each thread (see reserve()). Sprites
+ *          that are added concurrently are drawn in unspecified order.
+ *          Clearing, beginning and drawing of batches must not run
+ *          concurrently with adding of sprites.
  */
-class SpriteBatch {
+class SpriteBatch: public ObjectUsingVulkan {
+    struct Sprite;
+
 public:
+    constexpr static Color k_white{255, 255, 255, 255};
+
+    /**
+     * @brief   Is a range of sprites reserved for a single thread
+     * @details Reserving a range for many sprites at once avoids contention
+     *          on the shared cursor. Slots that have not been used when the
+     *          range is destroyed are filled with empty sprites that are
+     *          not drawn.
+     */
+    class Range {
+    public:
+        Range(const Range&)            = delete; ///< Noncopyable
+        Range& operator=(const Range&) = delete; ///< Noncopyable
+
+        Range(Range&& other) noexcept;           ///< Movable
+        Range& operator=(Range&&) = delete;      ///< Not move-assignable
+
+        ~Range();
+
+        void add(
+            const Texture& tex, const glm::vec4& posSizeRect,
+            const glm::vec4& uvsSizeRect, Color col = k_white, uint16_t layer = 0
+        );
+
+        void addSprite(
+            const SpriteStatic& sprite, glm::vec2 pos, Color col = k_white,
+            uint16_t layer = 0
+        );
+
+        void addSprite(
+            const SpriteComplex& sprite, glm::vec2 pos, Color col = k_white,
+            uint16_t layer = 0
+        );
+
+        void addSubimage(
+            const TextureShaped& tex, glm::vec2 pos, glm::vec2 subimgSpr,
+            Color col = k_white, uint16_t layer = 0
+        );
+
+        /**
+         * @brief Gets number of sprites that can still be added to the range
+         */
+        unsigned int remaining() const { return m_end - m_next; }
+
+    private:
+        friend class SpriteBatch;
+
+        Range(SpriteBatch& batch, unsigned int first, unsigned int count);
+
+        void write(const Sprite& sprite);
+
+        SpriteBatch* m_batch;
+        unsigned int m_next;
+        unsigned int m_end;
+    };
+
     /**
      * @brief Constructs a Spritebatch
      */
     explicit SpriteBatch(const SpriteBatchCreateInfo& createInfo);
 
+    SpriteBatch(const SpriteBatch&)            = delete; ///< Noncopyable
+    SpriteBatch& operator=(const SpriteBatch&) = delete; ///< Noncopyable
+
+    SpriteBatch(SpriteBatch&&)            = delete;      ///< Nonmovable
+    SpriteBatch& operator=(SpriteBatch&&) = delete;      ///< Nonmovable
+
     /**
      * @brief   Resets the sprite batch, also begins first batch
      * @details Call this at the beginning of each frame.
@@ -59,24 +173,50 @@ public:
     /**
      * @brief   Draws the last batch
      * @details Sprites of the batch are drawn in the order they were added in
+     *          (unless they were added concurrently) or sorted (see SpriteOrder)
      * @param cb Command buffer used for rendering
      * @param mvpMat Transformation matrix applied to the batch
      */
     void drawBatch(const CommandBuffer& cb, const glm::mat4& mvpMat);
 
-    constexpr static Color k_white{255, 255, 255, 255};
+    /**
+     * @brief   Reserves space for sprites in the current batch
+     * @details The returned range can be filled from any thread.
+     */
+    Range reserve(unsigned int count);
 
+    /**
+     * @brief Adds a sprite to the current batch
+     * @param layer Sprites in lower layers are drawn first if the batch
+     *              is sorted (see SpriteOrder), ignored otherwise
+     */
     void add(
         const Texture& tex, const glm::vec4& posSizeRect,
-        const glm::vec4& uvsSizeRect, Color col = k_white
+        const glm::vec4& uvsSizeRect, Color col = k_white, uint16_t layer = 0
     );
 
-    void addSprite(const SpriteStatic& sprite, glm::vec2 pos, Color col = k_white);
+    /**
+     * @copydoc add
+     */
+    void addSprite(
+        const SpriteStatic& sprite, glm::vec2 pos, Color col = k_white,
+        uint16_t layer = 0
+    );
 
-    void addSprite(const SpriteComplex& sprite, glm::vec2 pos, Color col = k_white);
+    /**
+     * @copydoc add
+     */
+    void addSprite(
+        const SpriteComplex& sprite, glm::vec2 pos, Color col = k_white,
+        uint16_t layer = 0
+    );
 
+    /**
+     * @copydoc add
+     */
     void addSubimage(
-        const TextureShaped& tex, glm::vec2 pos, glm::vec2 subimgSpr, Color col = k_white
+        const TextureShaped& tex, glm::vec2 pos, glm::vec2 subimgSpr,
+        Color col = k_white, uint16_t layer = 0
     );
 
     const Pipeline& pipeline() const { return m_pipeline; }
@@ -90,25 +230,53 @@ private:
         glm::vec4 uvs;
         glm::uint tex;
         Color col;
+        glm::uint layer; ///< Not read by the GPU, fits into the padding
+    };
+    static_assert(sizeof(Sprite) == 48);
+
+    /**
+     * @brief Is the key of a sprite in the radix sort and its original index
+     */
+    struct SortEntry {
+        uint32_t key;
+        uint32_t index;
     };
+
     BufferMapped<Sprite> m_spritesBuf;
-    std::vector<const Texture*> m_texToIndex;
     unsigned int m_maxSprites;
-    unsigned int m_maxTextures;
-    unsigned int m_nextSpriteIndex       = 0;
-    unsigned int m_batchFirstSpriteIndex = 0;
-    unsigned int m_textureIndexOffset    = 0;
+    std::atomic<unsigned int> m_nextSpriteIndex = 0;
+    unsigned int m_batchFirstSpriteIndex        = 0;
+    SpriteBatchBackend m_backend;
+    SpriteOrder m_order;
+
+    std::vector<SortEntry> m_sortEntries;
+    std::vector<SortEntry> m_sortScratch;
+    std::vector<Sprite> m_sortedSprites;
 
     unsigned int nextSpriteIndex();
-    unsigned int texToIndex(const Texture& tex);
+    void sortBatch();
+
+    Sprite makeSprite(
+        const Texture& tex, const glm::vec4& posSizeRect,
+        const glm::vec4& uvsSizeRect, Color col, uint16_t layer
+    );
+    Sprite makeSprite(
+        const SpriteStatic& sprite, glm::vec2 pos, Color col, uint16_t layer
+    );
+    Sprite makeSprite(
+        const SpriteComplex& sprite, glm::vec2 pos, Color col, uint16_t layer
+    );
+    Sprite makeSubimage(
+        const TextureShaped& tex, glm::vec2 pos, glm::vec2 subimgSpr, Color col,
+        uint16_t layer
+    );
 
     PipelineLayout m_pipelineLayout;
-    static PipelineLayout createPipelineLayout(unsigned int maxTextures);
+    static PipelineLayout createPipelineLayout(const SpriteBatchCreateInfo& createInfo);
     Pipeline m_pipeline;
     static Pipeline createPipeline(
         const PipelineLayout& pipelineLayout, const SpriteBatchCreateInfo& createInfo
     );
-    DescriptorSet m_descSet{{.layout = m_pipelineLayout.descriptorSetLayout(0)}};
 };
 
 } // namespace re
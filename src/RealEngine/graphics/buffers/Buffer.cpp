@@ -5,6 +5,7 @@
 
 #include <RealEngine/graphics/buffers/Buffer.hpp>
 #include <RealEngine/graphics/commands/CommandBuffer.hpp>
+#include <RealEngine/renderer/UploadQueue.hpp>
 #include <RealEngine/utility/Error.hpp>
 
 using enum vk::BufferUsageFlagBits;
@@ -22,39 +23,24 @@ Buffer::Buffer(const BufferCreateInfo& createInfo, void** pointerToMapped) {
     );
     // If initial data are provided but it cannot be copied directly to the main buffer
     if (!createInfo.initData.empty() && !(createInfo.allocFlags & k_hostAccess)) {
-        void* stageMapped = nullptr;
-        // Create temporary stage buffer
-        auto stage = allocateBuffer(
-            BufferCreateInfo{
-                .allocFlags  = eHostAccessSequentialWrite | eMapped,
-                .memoryUsage = eAutoPreferHost,
-                .sizeInBytes = createInfo.initData.size_bytes(),
-                .usage       = eTransferSrc
-            },
-            &stageMapped
-        );
         // Create the main buffer
         auto mainCreateInfo = createInfo;
         mainCreateInfo.usage |= eTransferDst;
         std::tie(m_buffer, m_allocation) =
             allocateBuffer(mainCreateInfo, pointerToMapped);
-        // Copy data to staging buffer
-        std::memcpy(
-            stageMapped, createInfo.initData.data(),
-            createInfo.initData.size_bytes()
+        // Stage the data and record copy from stage to main buffer
+        m_uploadTicket = uploadQueue().upload(
+            createInfo.initData,
+            [&](const CommandBuffer& cb, vk::Buffer stage, vk::DeviceSize offset) {
+                cb->copyBuffer(
+                    stage, m_buffer,
+                    vk::BufferCopy{
+                        offset, createInfo.initDataDstOffset,
+                        createInfo.initData.size_bytes()
+                    }
+                );
+            }
         );
-        // Copy from staging to main buffer
-        CommandBuffer::doOneTimeSubmit([&](const CommandBuffer& cb) {
-            cb->copyBuffer(
-                stage.first, m_buffer,
-                vk::BufferCopy{
-                    0u, createInfo.initDataDstOffset,
-                    createInfo.initData.size_bytes()
-                }
-            );
-        });
-        // Destroy the temporary stage
-        allocator().destroyBuffer(stage.first, stage.second);
     } else { // Stage is not required
         std::tie(m_buffer, m_allocation) = allocateBuffer(createInfo, pointerToMapped);
         if (!createInfo.initData.empty()) {
@@ -72,15 +58,29 @@ Buffer::Buffer(const BufferCreateInfo& createInfo, void** pointerToMapped) {
 
 Buffer::Buffer(Buffer&& other) noexcept
     : m_allocation(std::exchange(other.m_allocation, nullptr))
-    , m_buffer(std::exchange(other.m_buffer, nullptr)) {
+    , m_buffer(std::exchange(other.m_buffer, nullptr))
+    , m_uploadTicket(std::exchange(other.m_uploadTicket, 0)) {
 }
 
 Buffer& Buffer::operator=(Buffer&& other) noexcept {
     std::swap(m_allocation, other.m_allocation);
     std::swap(m_buffer, other.m_buffer);
+    std::swap(m_uploadTicket, other.m_uploadTicket);
     return *this;
 }
 
+bool Buffer::isUploaded() const {
+    return uploadQueue().isComplete(m_uploadTicket);
+}
+
+void Buffer::waitForUpload() const {
+    uploadQueue().wait(m_uploadTicket);
+}
+
+void Buffer::invalidateMapped() const {
+    allocator().invalidateAllocation(m_allocation, 0, vk::WholeSize);
+}
+
 Buffer::~Buffer() {
     deletionQueue().enqueueDeletion(m_buffer);
     deletionQueue().enqueueDeletion(m_allocation);
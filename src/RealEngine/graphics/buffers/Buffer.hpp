@@ -71,6 +71,26 @@ public:
 
     const vk::Buffer& buffer() const { return m_buffer; }
 
+    /**
+     * @brief Checks whether the initial data have been transferred to the buffer
+     * @details Initial data of device-local buffers are transferred
+     * asynchronously. Commands submitted after the creation of the buffer
+     * always observe the data, so this has to be checked only if the buffer
+     * is accessed in a different way.
+     */
+    bool isUploaded() const;
+
+    /**
+     * @brief Blocks until the initial data are transferred to the buffer
+     */
+    void waitForUpload() const;
+
+    /**
+     * @brief Makes writes of the device visible to reads of the mapped memory
+     * @details Does nothing if the memory is host-coherent.
+     */
+    void invalidateMapped() const;
+
 protected:
     /**
      * @param createInfo
@@ -87,6 +107,7 @@ private:
 
     vma::Allocation m_allocation{};
     vk::Buffer m_buffer{};
+    uint64_t m_uploadTicket = 0; ///< UploadQueue::Ticket of the initial data
 };
 
 } // namespace re
@@ -2,13 +2,16 @@
  *  @author    Dubsky Tomas
  */
 #include <RealEngine/graphics/commands/CommandBuffer.hpp>
+#include <RealEngine/renderer/GPUProfiler.hpp>
+#include <RealEngine/renderer/UploadQueue.hpp>
 
 namespace re {
 
 CommandBuffer::CommandBuffer(const CommandBufferCreateInfo& createInfo)
-    : m_cb(device()
+    : m_pool(createInfo.pool ? createInfo.pool : commandPool())
+    , m_cb(device()
                .allocateCommandBuffers(vk::CommandBufferAllocateInfo{
-                   commandPool(), createInfo.level, 1u
+                   m_pool, createInfo.level, 1u
                })
                .back()) {
 
@@ -16,28 +19,36 @@ CommandBuffer::CommandBuffer(const CommandBufferCreateInfo& createInfo)
 }
 
 CommandBuffer::CommandBuffer(CommandBuffer&& other) noexcept
-    : m_cb(std::exchange(other.m_cb, nullptr)) {
+    : m_pool(std::exchange(other.m_pool, nullptr))
+    , m_cb(std::exchange(other.m_cb, nullptr)) {
 }
 
 CommandBuffer& CommandBuffer::operator=(CommandBuffer&& other) noexcept {
+    std::swap(m_pool, other.m_pool);
     std::swap(m_cb, other.m_cb);
     return *this;
 }
 
 CommandBuffer::~CommandBuffer() {
-    device().freeCommandBuffers(commandPool(), m_cb);
+    if (m_cb) {
+        device().freeCommandBuffers(m_pool, m_cb);
+    }
 }
 
 void CommandBuffer::submitToGraphicsCompQueue(
     const vk::ArrayProxy<const vk::SubmitInfo2>& submits,
     const vk::Fence& signalFence /* = nullptr*/
 ) {
-    graphicsCompQueue().submit2(submits, signalFence);
+    uploadQueue().submitAfterUploads([&](const vk::Queue& queue) {
+        queue.submit2(submits, signalFence);
+    });
 }
 
 void CommandBuffer::submitToGraphicsCompQueue(const vk::Fence&
                                                   signalFence /* = nullptr*/) const {
-    graphicsCompQueue().submit(vk::SubmitInfo{{}, {}, m_cb}, signalFence);
+    uploadQueue().submitAfterUploads([&](const vk::Queue& queue) {
+        queue.submit(vk::SubmitInfo{{}, {}, m_cb}, signalFence);
+    });
 }
 
 void CommandBuffer::debugBarrier() const {
@@ -45,4 +56,23 @@ void CommandBuffer::debugBarrier() const {
     m_cb.pipelineBarrier2(vk::DependencyInfo{{}, barrier, {}, {}});
 }
 
+void CommandBuffer::beginDebugRegion(
+    const char* label, glm::vec4 color /* = {}*/
+) const {
+#if RE_BUILDING_FOR_DEBUG
+    m_cb.beginDebugUtilsLabelEXT(
+        vk::DebugUtilsLabelEXT{label, {color.r, color.g, color.b, color.a}},
+        dispatchLoaderDynamic()
+    );
+#endif // RE_BUILDING_FOR_DEBUG
+    gpuProfiler().beginZone(m_cb, label);
+}
+
+void CommandBuffer::endDebugRegion() const {
+    gpuProfiler().endZone(m_cb);
+#if RE_BUILDING_FOR_DEBUG
+    m_cb.endDebugUtilsLabelEXT(dispatchLoaderDynamic());
+#endif // RE_BUILDING_FOR_DEBUG
+}
+
 } // namespace re
@@ -18,6 +18,9 @@ struct CommandBufferCreateInfo {
     // Level
     vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary;
 
+    // Pool, the pool of the renderer is used if this is null
+    vk::CommandPool pool = nullptr;
+
     // Debug
     [[no_unique_address]] DebugString<> debugName;
 };
@@ -46,6 +49,7 @@ public:
 
     /**
      * @brief Records a command buffer and submits it
+     * @details Pending uploads of buffers and textures are submitted before it.
      * @warning Waits for device to become idle which is very expensive!
      *          Use only when performance is not critical (e.g. outside of main
      * loop)
@@ -56,13 +60,14 @@ public:
         });
         op(oneTimeSubmitCmdBuf());
         oneTimeSubmitCmdBuf()->end();
-        graphicsCompQueue().submit(vk::SubmitInfo{{}, {}, *oneTimeSubmitCmdBuf()});
+        oneTimeSubmitCmdBuf().submitToGraphicsCompQueue();
         device().waitIdle();
     }
 
     /**
      * @brief Submits the work to a queue which support graphics, compute and
      * transfer work
+     * @details Pending uploads of buffers and textures are submitted before it.
      */
     static void submitToGraphicsCompQueue(
         const vk::ArrayProxy<const vk::SubmitInfo2>& submits,
@@ -72,6 +77,7 @@ public:
     /**
      * @brief Submits the command buffer to a queue which support graphics,
      * compute and transfer work
+     * @details Pending uploads of buffers and textures are submitted before it.
      */
     void submitToGraphicsCompQueue(const vk::Fence& signalFence = nullptr) const;
 
@@ -87,26 +93,17 @@ public:
 
     /**
      * @brief Begins a labeled debug region in the command buffer
-     * @note  Does nothing in release build
+     * @details The label is emitted only in debug build. If this is the
+     *          command buffer of the frame and the Profiler is enabled, the
+     *          region is also timed on the GPU (in any build).
      */
-    void beginDebugRegion(const char* label, glm::vec4 color = {}) const {
-#if RE_BUILDING_FOR_DEBUG
-        m_cb.beginDebugUtilsLabelEXT(
-            vk::DebugUtilsLabelEXT{label, {color.r, color.g, color.b, color.a}},
-            dispatchLoaderDynamic()
-        );
-#endif // RE_BUILDING_FOR_DEBUG
-    }
+    void beginDebugRegion(const char* label, glm::vec4 color = {}) const;
 
     /**
      * @brief Ends a labeled debug region into the command buffer
-     * @note  Does nothing in release build
+     * @details See beginDebugRegion() for what is emitted.
      */
-    void endDebugRegion() const {
-#if RE_BUILDING_FOR_DEBUG
-        m_cb.endDebugUtilsLabelEXT(dispatchLoaderDynamic());
-#endif // RE_BUILDING_FOR_DEBUG
-    }
+    void endDebugRegion() const;
 
     /**
      * @brief Inserts a single debug label in the command buffer
@@ -123,7 +120,7 @@ public:
 
     /**
      * @brief Is a RAII wrapper of labelled debug regions
-     * @note  Effectively does nothing in release build
+     * @note  Effectively does nothing in release build unless profiling
      */
     class [[nodiscard]] DebugRegion {
     public:
@@ -156,6 +153,7 @@ public:
     const vk::CommandBuffer& commandBuffer() const { return m_cb; }
 
 private:
+    vk::CommandPool m_pool{};
     vk::CommandBuffer m_cb{};
 };
 
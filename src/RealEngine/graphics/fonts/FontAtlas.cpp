@@ -0,0 +1,360 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <thread>
+
+#include <SDL_ttf.h>
+
+#define STB_RECT_PACK_IMPLEMENTATION
+#define STBRP_STATIC
+#include <ImGui/imstb_rectpack.h>
+
+#include <RealEngine/graphics/fonts/FontAtlas.hpp>
+#include <RealEngine/jobs/JobSystem.hpp>
+#include <RealEngine/resources/FileIO.hpp>
+#include <RealEngine/resources/PackageFormat.hpp>
+#include <RealEngine/utility/Error.hpp>
+#include <RealEngine/utility/SIMD.hpp>
+#include <RealEngine/utility/UniqueCPtr.hpp>
+
+namespace re {
+
+using TTF_FontRAII    = UniqueCPtr<TTF_Font, TTF_CloseFont>;
+using SDL_SurfaceRAII = UniqueCPtr<SDL_Surface, SDL_FreeSurface>;
+
+namespace {
+
+constexpr int k_glyphPadding       = 1;  ///< Empty texels around each glyph
+constexpr size_t k_glyphsPerClaim  = 32; ///< Glyphs claimed at once by a job
+constexpr size_t k_minGlyphsPerJob = 128;
+
+struct RasterizedGlyph {
+    std::vector<unsigned char> alpha; ///< Tightly packed rows
+    glm::ivec2 dims{};
+    int advance{};
+    bool present = false; ///< False if the font has no glyph for the character
+};
+
+TTF_FontRAII openFont(const RasterizedFontCreateInfo& createInfo) {
+    TTF_FontRAII font{TTF_OpenFontIndexRW(
+        SDL_RWFromConstMem(
+            createInfo.ttfBytes.data(),
+            static_cast<int>(createInfo.ttfBytes.size_bytes())
+        ),
+        true, createInfo.pointSize, createInfo.faceIndex
+    )};
+    if (!font) {
+        throw Exception{std::format("Could not open font: {}", TTF_GetError())};
+    }
+    return font;
+}
+
+/**
+ * @brief Extracts alpha channel of a blended glyph
+ */
+void extractAlpha(const SDL_Surface& surf, unsigned char* dst) {
+    // Blended glyphs are ARGB8888, alpha is the most significant byte
+    assert(surf.format->format == SDL_PIXELFORMAT_ARGB8888);
+    for (int y = 0; y < surf.h; ++y, dst += surf.w) {
+        const auto* row = static_cast<const unsigned char*>(surf.pixels) + y * surf.pitch;
+        int x           = 0;
+#ifdef RE_SIMD_SSE2
+        for (; x + 16 <= surf.w; x += 16) {
+            const auto* src = reinterpret_cast<const __m128i*>(row + x * 4);
+            __m128i a0 = _mm_srli_epi32(_mm_loadu_si128(src + 0), 24);
+            __m128i a1 = _mm_srli_epi32(_mm_loadu_si128(src + 1), 24);
+            __m128i a2 = _mm_srli_epi32(_mm_loadu_si128(src + 2), 24);
+            __m128i a3 = _mm_srli_epi32(_mm_loadu_si128(src + 3), 24);
+            __m128i packed = _mm_packus_epi16(
+                _mm_packs_epi32(a0, a1), _mm_packs_epi32(a2, a3)
+            );
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), packed);
+        }
+#endif // RE_SIMD_SSE2
+        for (; x < surf.w; ++x) {
+            uint32_t pixel;
+            std::memcpy(&pixel, row + x * 4, sizeof(pixel));
+            dst[x] = static_cast<unsigned char>(pixel >> 24);
+        }
+    }
+}
+
+RasterizedGlyph rasterizeGlyph(TTF_Font* font, char32_t c) {
+    constexpr SDL_Color k_fgCol{.r = 255, .g = 255, .b = 255, .a = 255};
+    RasterizedGlyph glyph{};
+    SDL_SurfaceRAII surf{TTF_RenderGlyph32_Blended(font, c, k_fgCol)};
+    if (surf) { // If there is a glyph for the character
+        [[maybe_unused]] int dontCare{};
+        TTF_GlyphMetrics32(
+            font, c, &dontCare, &dontCare, &dontCare, &dontCare, &glyph.advance
+        );
+        glyph.dims    = {surf->w, surf->h};
+        glyph.present = true;
+        glyph.alpha.resize(static_cast<size_t>(surf->w) * surf->h);
+        extractAlpha(*surf, glyph.alpha.data());
+    }
+    return glyph;
+}
+
+/**
+ * @brief Rasterizes glyphs of the characters in parallel (using the job system)
+ * @details Each job uses its own instance of the font because
+ *          a font cannot be used by multiple threads at once.
+ */
+std::vector<RasterizedGlyph> rasterizeGlyphs(
+    const RasterizedFontCreateInfo& createInfo, TTF_Font* font,
+    std::span<const char32_t> chars
+) {
+    std::vector<RasterizedGlyph> glyphs(chars.size());
+    JobSystem& jobSystem = JobSystem::shared();
+    size_t jobCount      = std::clamp<size_t>(
+        chars.size() / k_minGlyphsPerJob, 1, jobSystem.concurrency()
+    );
+    // The fonts are opened (and closed) by this thread only
+    std::vector<TTF_FontRAII> workerFonts;
+    workerFonts.reserve(jobCount - 1);
+    for (size_t i = 1; i < jobCount; ++i) {
+        workerFonts.push_back(openFont(createInfo));
+    }
+
+    std::atomic<size_t> nextGlyph{0};
+    auto rasterize = [&](TTF_Font* font) {
+        while (true) {
+            size_t first = nextGlyph.fetch_add(k_glyphsPerClaim, std::memory_order_relaxed);
+            if (first >= chars.size()) {
+                return;
+            }
+            size_t last = std::min(first + k_glyphsPerClaim, chars.size());
+            for (size_t i = first; i < last; ++i) {
+                glyphs[i] = rasterizeGlyph(font, chars[i]);
+            }
+        }
+    };
+    jobSystem.parallelFor(0, jobCount, 1, [&](size_t job, size_t) {
+        rasterize(job == 0 ? font : workerFonts[job - 1].get());
+    });
+    return glyphs;
+}
+
+} // namespace
+
+uint64_t FontAtlas::key(const RasterizedFontCreateInfo& createInfo) {
+    auto bytesOf = [](const auto& range) {
+        auto bytes = std::as_bytes(std::span{range});
+        return std::span{
+            reinterpret_cast<const unsigned char*>(bytes.data()), bytes.size()
+        };
+    };
+    std::array<int, 3> params{
+        static_cast<int>(k_version), createInfo.pointSize, createInfo.faceIndex
+    };
+    uint64_t hash = package::hashContent(createInfo.ttfBytes);
+    hash          = package::hashContent(bytesOf(params), hash);
+    return package::hashContent(bytesOf(createInfo.ranges), hash);
+}
+
+std::filesystem::path FontAtlas::cachePath(std::string_view cacheDir, uint64_t key) {
+    return std::filesystem::path{cacheDir} / std::format("{:016x}{}", key, k_fileSuffix);
+}
+
+FontAtlas FontAtlas::rasterize(const RasterizedFontCreateInfo& createInfo) {
+    FontAtlas atlas{};
+    TTF_FontRAII font = openFont(createInfo);
+
+    // List the characters
+    std::vector<char32_t> chars;
+    chars.reserve(std::accumulate(
+        createInfo.ranges.begin(), createInfo.ranges.end(), size_t{0},
+        [](size_t c, UnicodeRange r) { return c + (r.lastChar - r.firstChar + 1); }
+    ));
+    atlas.m_offsets.reserve(createInfo.ranges.size());
+    for (const UnicodeRange& r : createInfo.ranges) {
+        assert(r.firstChar <= r.lastChar);
+        for (char32_t c = r.firstChar; c <= r.lastChar; ++c) { chars.push_back(c); }
+        atlas.m_offsets.emplace_back(r.lastChar, static_cast<int>(chars.size()) - 1);
+    }
+    atlas.m_ascentPx   = static_cast<float>(TTF_FontAscent(font.get()));
+    atlas.m_lineSkipPx = static_cast<float>(TTF_FontLineSkip(font.get()));
+
+    // Render and measure all glyphs
+    auto rasterized = rasterizeGlyphs(createInfo, font.get(), chars);
+
+    // Pack the glyphs, each has padding at its right and bottom side
+    std::vector<stbrp_rect> rects;
+    rects.reserve(rasterized.size());
+    int totalArea = 0, maxWidth = 0;
+    for (size_t i = 0; i < rasterized.size(); ++i) {
+        const auto& glyph = rasterized[i];
+        if (glyph.dims.x > 0 && glyph.dims.y > 0) {
+            stbrp_rect& rect = rects.emplace_back(stbrp_rect{
+                .id = static_cast<int>(i),
+                .w  = glyph.dims.x + k_glyphPadding,
+                .h  = glyph.dims.y + k_glyphPadding
+            });
+            totalArea += rect.w * rect.h;
+            maxWidth = std::max(maxWidth, rect.w);
+        }
+    }
+    // The atlas is about square, its width is fixed and the height is what is used
+    int texWidth = static_cast<int>(std::max(
+        std::bit_ceil(static_cast<uint32_t>(std::ceil(std::sqrt(totalArea)))),
+        std::bit_ceil(static_cast<uint32_t>(maxWidth + k_glyphPadding))
+    ));
+    std::vector<stbrp_node> nodes(texWidth);
+    stbrp_context context{};
+    stbrp_init_target(
+        &context, texWidth - k_glyphPadding, std::numeric_limits<int>::max() / 2,
+        nodes.data(), static_cast<int>(nodes.size())
+    );
+    if (!stbrp_pack_rects(&context, rects.data(), static_cast<int>(rects.size()))) {
+        throw Exception{"Could not pack glyphs of font"};
+    }
+    int texHeight = k_glyphPadding;
+    for (const stbrp_rect& rect : rects) {
+        texHeight = std::max(texHeight, rect.y + rect.h + k_glyphPadding);
+    }
+
+    // Copy glyphs to the stage and calculate their UVs
+    std::vector<unsigned char> stage(static_cast<size_t>(texWidth) * texHeight);
+    glm::vec2 texSizeInv = 1.0f / glm::vec2{texWidth, texHeight};
+    atlas.m_glyphs.reserve(rasterized.size());
+    for (const auto& glyph : rasterized) {
+        atlas.m_glyphs.emplace_back(
+            glm::vec4{}, glm::vec2{glyph.dims}, static_cast<float>(glyph.advance)
+        );
+    }
+    for (const stbrp_rect& rect : rects) {
+        const auto& glyph = rasterized[rect.id];
+        glm::ivec2 topLeft{rect.x + k_glyphPadding, rect.y + k_glyphPadding};
+        for (int y = 0; y < glyph.dims.y; ++y) {
+            std::memcpy(
+                &stage[static_cast<size_t>(topLeft.y + y) * texWidth + topLeft.x],
+                &glyph.alpha[static_cast<size_t>(y) * glyph.dims.x], glyph.dims.x
+            );
+        }
+        atlas.m_glyphs[rect.id].uvSizeRect = glm::vec4{
+            glm::vec2{topLeft.x, texHeight - topLeft.y - glyph.dims.y} * texSizeInv,
+            glm::vec2{glyph.dims} * texSizeInv
+        };
+    }
+
+    atlas.m_bytes = std::move(stage);
+    atlas.m_dims  = glm::uvec2{texWidth, texHeight};
+    return atlas;
+}
+
+std::optional<FontAtlas> FontAtlas::loadCached(std::string_view cacheDir, uint64_t key) {
+    try {
+        auto path = cachePath(cacheDir, key);
+        if (!std::filesystem::exists(path)) {
+            return std::nullopt;
+        }
+        return FontAtlas{readBinaryFile(path), key};
+    } catch (const std::exception&) {
+        return std::nullopt; // The cached atlas is unreadable, it will be replaced
+    }
+}
+
+void FontAtlas::storeCached(std::string_view cacheDir, uint64_t key) const {
+    std::filesystem::create_directories(cacheDir);
+    auto path     = cachePath(cacheDir, key);
+    auto tempPath = path;
+    // The name of the temporary file is unique among threads (and processes
+    // thanks to the random part) that store the atlas
+    std::random_device randomDevice;
+    tempPath += std::format(
+        ".{:x}.{:x}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()),
+        std::uniform_int_distribution<uint64_t>{}(randomDevice)
+    );
+    std::vector<unsigned char> encoded = encode(key);
+    {
+        std::ofstream file{tempPath, std::ios::binary | std::ios::trunc};
+        file.write(
+            reinterpret_cast<const char*>(encoded.data()),
+            static_cast<std::streamsize>(encoded.size())
+        );
+        if (!file) {
+            throw Exception{std::format("Could not write {}", tempPath.string())};
+        }
+    }
+    std::filesystem::rename(tempPath, path);
+}
+
+FontAtlas::FontAtlas(std::vector<unsigned char>&& encoded, uint64_t key)
+    : m_bytes(std::move(encoded)) {
+    Header header{};
+    if (m_bytes.size() < sizeof(Header)) {
+        throw Exception{"Font atlas is truncated"};
+    }
+    std::memcpy(&header, m_bytes.data(), sizeof(Header));
+    if (header.magic != k_magic || header.version != k_version) {
+        throw Exception{"Not a font atlas or unsupported version of font atlas"};
+    }
+    if (header.key != key) {
+        throw Exception{"Font atlas belongs to a different font"};
+    }
+    size_t glyphsSize  = header.glyphCount * sizeof(Glyph);
+    size_t offsetsSize = header.offsetCount * sizeof(GlyphOffset);
+    m_texelsOffset     = sizeof(Header) + glyphsSize + offsetsSize;
+    if (m_bytes.size() !=
+        m_texelsOffset + static_cast<size_t>(header.dims.x) * header.dims.y) {
+        throw Exception{"Font atlas is truncated"};
+    }
+    m_glyphs.resize(header.glyphCount);
+    std::memcpy(m_glyphs.data(), &m_bytes[sizeof(Header)], glyphsSize);
+    m_offsets.resize(header.offsetCount);
+    std::memcpy(m_offsets.data(), &m_bytes[sizeof(Header) + glyphsSize], offsetsSize);
+    m_dims       = header.dims;
+    m_lineSkipPx = header.lineSkipPx;
+    m_ascentPx   = header.ascentPx;
+}
+
+std::vector<unsigned char> FontAtlas::encode(uint64_t key) const {
+    Header header{
+        .key         = key,
+        .dims        = m_dims,
+        .lineSkipPx  = m_lineSkipPx,
+        .ascentPx    = m_ascentPx,
+        .glyphCount  = static_cast<uint32_t>(m_glyphs.size()),
+        .offsetCount = static_cast<uint32_t>(m_offsets.size())
+    };
+    auto texels = this->texels();
+    std::vector<unsigned char> out;
+    out.reserve(
+        sizeof(Header) + m_glyphs.size() * sizeof(Glyph) +
+        m_offsets.size() * sizeof(GlyphOffset) + texels.size()
+    );
+    auto append = [&out](const void* data, size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    };
+    append(&header, sizeof(Header));
+    append(m_glyphs.data(), m_glyphs.size() * sizeof(Glyph));
+    append(m_offsets.data(), m_offsets.size() * sizeof(GlyphOffset));
+    append(texels.data(), texels.size());
+    return out;
+}
+
+int FontAtlas::glyphCount() const {
+    return static_cast<int>(std::ranges::count_if(m_glyphs, [](const Glyph& g) {
+        return g.advancePx != 0.0f || g.sizePx != glm::vec2{0.0f};
+    }));
+}
+
+float FontAtlas::occupancy() const {
+    float glyphArea = 0.0f;
+    for (const Glyph& glyph : m_glyphs) { glyphArea += glyph.sizePx.x * glyph.sizePx.y; }
+    return glyphArea / static_cast<float>(m_dims.x * m_dims.y);
+}
+
+} // namespace re
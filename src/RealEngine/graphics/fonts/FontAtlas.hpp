@@ -0,0 +1,152 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include <RealEngine/resources/PackageConstants.hpp>
+#include <RealEngine/utility/Unicode.hpp>
+
+namespace re {
+
+struct RasterizedFontCreateInfo {
+    std::span<const unsigned char> ttfBytes{};
+    int pointSize{};
+    int faceIndex{};
+    std::span<const UnicodeRange> ranges = k_asciiPrintableUnicodeRanges;
+    /**
+     * @brief Directory where rasterized atlases are cached, empty disables the cache
+     */
+    std::string_view atlasCacheDir = k_fontAtlasCacheDir;
+};
+
+/**
+ * @brief   Holds rasterized glyphs of a font packed in a single-channel texture
+ * @details The atlas is either rasterized from the TrueType font or read from
+ *          its encoded form which is stored in the atlas cache.
+ * @details The encoded form consists of a header, the glyphs, the glyph
+ *          offsets and the texels (in this order). All values are stored
+ *          in little-endian byte order.
+ */
+class FontAtlas {
+public:
+    static_assert(
+        std::endian::native == std::endian::little,
+        "Font atlases are read in-place and require a little-endian host"
+    );
+
+    static constexpr std::array<char, 4> k_magic{'r', 'e', 'F', 'A'};
+    static constexpr uint32_t k_version            = 1;
+    static constexpr std::string_view k_fileSuffix = ".reatlas";
+
+    struct Glyph {
+        glm::vec4 uvSizeRect;
+        glm::vec2 sizePx;
+        float advancePx;
+    };
+    static_assert(sizeof(Glyph) == 28);
+
+    struct GlyphOffset {
+        char32_t lastChar{}; // If c is less-or-equal than this
+        int baseOffset{};    // c is at: baseOffset - (lastChar - c)
+    };
+    static_assert(sizeof(GlyphOffset) == 8);
+
+    struct Header {
+        std::array<char, 4> magic = k_magic;
+        uint32_t version          = k_version;
+        uint64_t key{}; ///< Of the font that the atlas was rasterized from
+        glm::uvec2 dims{};
+        float lineSkipPx{};
+        float ascentPx{};
+        uint32_t glyphCount{};
+        uint32_t offsetCount{};
+    };
+    static_assert(sizeof(Header) == 40);
+
+    /**
+     * @brief Computes the key that identifies the atlas of the font
+     * @details The key is a hash of the TTF and all rasterization parameters.
+     */
+    static uint64_t key(const RasterizedFontCreateInfo& createInfo);
+
+    /**
+     * @brief Gets path to the atlas with the key inside the cache directory
+     */
+    static std::filesystem::path cachePath(std::string_view cacheDir, uint64_t key);
+
+    /**
+     * @brief   Rasterizes the glyphs of the font (in parallel) and packs them
+     * @throws  Throws if the font cannot be opened
+     * @note    SDL_ttf must be initialized.
+     */
+    static FontAtlas rasterize(const RasterizedFontCreateInfo& createInfo);
+
+    /**
+     * @brief Reads the atlas with the key from the cache directory
+     * @return The atlas or nullopt if it is not cached or the cached file is invalid
+     */
+    static std::optional<FontAtlas> loadCached(std::string_view cacheDir, uint64_t key);
+
+    /**
+     * @brief   Stores the atlas into the cache directory (creates it if needed)
+     * @details The file is replaced atomically so concurrent readers never
+     *          see it partially written.
+     * @throws  Throws if the atlas cannot be written
+     */
+    void storeCached(std::string_view cacheDir, uint64_t key) const;
+
+    /**
+     * @brief   Reads atlas from its encoded form
+     * @details The encoded bytes are moved into the atlas, which owns them.
+     * @throws  Throws if the bytes do not form a valid atlas with the key
+     */
+    FontAtlas(std::vector<unsigned char>&& encoded, uint64_t key);
+
+    /**
+     * @brief Encodes the atlas so that it can be stored
+     */
+    std::vector<unsigned char> encode(uint64_t key) const;
+
+    std::span<const Glyph> glyphs() const { return m_glyphs; }
+    std::span<const GlyphOffset> offsets() const { return m_offsets; }
+    glm::uvec2 dims() const { return m_dims; }
+    std::span<const unsigned char> texels() const {
+        return std::span{m_bytes}.subspan(m_texelsOffset);
+    }
+    float lineSkipPx() const { return m_lineSkipPx; }
+    float ascentPx() const { return m_ascentPx; }
+
+    /**
+     * @brief Gets number of characters that have a glyph
+     */
+    int glyphCount() const;
+
+    /**
+     * @brief Gets fraction of the texture covered by glyphs
+     */
+    float occupancy() const;
+
+private:
+    FontAtlas() = default;
+
+    std::vector<Glyph> m_glyphs;
+    std::vector<GlyphOffset> m_offsets;
+    std::vector<unsigned char> m_bytes; ///< Contain the texels
+    size_t m_texelsOffset = 0;
+    glm::uvec2 m_dims{};
+    float m_lineSkipPx{};
+    float m_ascentPx{};
+};
+
+} // namespace re
@@ -1,133 +1,70 @@
 ﻿/**
  *  @author    Dubsky Tomas
  */
-#include <bit>
+#include <chrono>
 #include <format>
-#include <memory>
-#include <numeric>
-
-#include <SDL_ttf.h>
 
 #include <RealEngine/graphics/fonts/RasterizedFont.hpp>
 #include <RealEngine/utility/Error.hpp>
-#include <RealEngine/utility/Math.hpp>
 #include <RealEngine/utility/Unicode.hpp>
-#include <RealEngine/utility/UniqueCPtr.hpp>
 
 namespace re {
 
-using TTF_RWopsRAII   = UniqueCPtr<SDL_RWops, SDL_FreeRW>;
-using TTF_FontRAII    = UniqueCPtr<TTF_Font, TTF_CloseFont>;
-using SDL_SurfaceRAII = UniqueCPtr<SDL_Surface, SDL_FreeSurface>;
-
-RasterizedFont::RasterizedFont(const RasterizedFontCreateInfo& createInfo) {
-    TTF_RWopsRAII rWops{SDL_RWFromConstMem(
-        createInfo.ttfBytes.data(),
-        static_cast<int>(createInfo.ttfBytes.size_bytes())
-    )};
-    TTF_FontRAII font{TTF_OpenFontIndexRW(
-        rWops.get(), false, createInfo.pointSize, createInfo.faceIndex
-    )};
-
-    // Count the expected number of characters
-    int glyphCount = std::accumulate(
-        createInfo.ranges.begin(), createInfo.ranges.end(), 0,
-        [](int c, UnicodeRange r) { return c + (r.lastChar - r.firstChar + 1); }
-    );
+namespace {
 
-    // Reserve space
-    m_offsets.reserve(glyphCount);
-    m_glyphs.reserve(glyphCount);
-    std::vector<SDL_SurfaceRAII> surfs;
-    surfs.reserve(glyphCount);
-
-    // Measure and render all glyphs
-    constexpr SDL_Color k_fgCol{.r = 255, .g = 255, .b = 255, .a = 255};
-    int totalWidth = 0;
-    [[maybe_unused]] int dontCare{};
-    for (const UnicodeRange& r : createInfo.ranges) {
-        assert(r.firstChar <= r.lastChar);
-        for (char32_t c = r.firstChar; c <= r.lastChar; ++c) {
-            const SDL_SurfaceRAII& surf = surfs.emplace_back(
-                TTF_RenderGlyph32_Blended(font.get(), c, k_fgCol)
-            );
-            if (surf) { // If there is a glyph for the character
-                totalWidth += surf->w;
-                int advance{};
-                TTF_GlyphMetrics32(
-                    font.get(), c, &dontCare, &dontCare, &dontCare, &dontCare, &advance
-                );
-                m_glyphs.emplace_back(
-                    glm::vec4{}, glm::vec2{surf->w, surf->h},
-                    static_cast<float>(advance)
-                );
-            } else {
-                m_glyphs.emplace_back();
-            }
-        }
-        m_offsets.emplace_back(r.lastChar, static_cast<int>(m_glyphs.size()) - 1);
+/**
+ * @brief Loads the atlas from the cache or rasterizes (and caches) it
+ */
+FontAtlas obtainAtlas(const RasterizedFontCreateInfo& createInfo, bool& fromCache) {
+    if (createInfo.atlasCacheDir.empty()) {
+        return FontAtlas::rasterize(createInfo);
+    }
+    uint64_t key = FontAtlas::key(createInfo);
+    if (auto cached = FontAtlas::loadCached(createInfo.atlasCacheDir, key)) {
+        fromCache = true;
+        return std::move(*cached);
+    }
+    FontAtlas atlas = FontAtlas::rasterize(createInfo);
+    try {
+        atlas.storeCached(createInfo.atlasCacheDir, key);
+    } catch (const std::exception& e) {
+        // The cache is only an optimization
+        error(std::format("Could not cache font atlas: {}", e.what()));
     }
-    int height   = TTF_FontHeight(font.get());
-    m_ascentPx   = static_cast<float>(TTF_FontAscent(font.get()));
-    m_lineSkipPx = static_cast<float>(TTF_FontLineSkip(font.get()));
+    return atlas;
+}
 
-    // Calculate size of the texture and prepare stage
-    const uint32_t minArea = totalWidth * height;
-    const uint32_t squareRoot =
-        static_cast<uint32_t>(std::sqrt(static_cast<float>(minArea)));
-    const uint32_t texWidth = std::bit_ceil(squareRoot);
-    const uint32_t texHeight =
-        roundToMultiple(ceilDiv(minArea, texWidth) + height, height);
-    const uint32_t area = texWidth * texHeight;
-    std::vector<unsigned char> stage;
-    stage.resize(area);
+} // namespace
 
-    // Lambda for copying from SDL surface to stage buffer
-    auto copyGlyph = [stage = stage.data(),
-                      &texWidth](const SDL_Surface* surf, glm::ivec2 botLeft) {
-        const int rowCopyBytes = surf->w;
-        const int pitchBytes   = surf->pitch;
-        const auto pixels      = reinterpret_cast<unsigned char*>(surf->pixels);
-        for (int yGlyph = 0; yGlyph < surf->h; yGlyph++) {
-            int y = yGlyph + botLeft.y;
-            for (int xGlyph = 0; xGlyph < surf->w; xGlyph++) {
-                int x = xGlyph + botLeft.x;
-                // Extract alpha channel only
-                stage[x + y * texWidth] =
-                    pixels[(xGlyph * 4 + yGlyph * pitchBytes) + 3];
-            }
-        }
-    };
-
-    // Copy glyphs to the texture
-    glm::vec2 texSizeInv = 1.0f / glm::vec2{texWidth, texHeight};
-    glm::ivec2 botLeft   = glm::ivec2{0, 0};
-    for (int i = 0; i < glyphCount; i++) {
-        if (const SDL_Surface* surf = surfs[i].get()) {
-            auto& glyph = m_glyphs[i];
-            if (botLeft.x + surf->w >= texWidth) {           // If would not fit
-                botLeft = glm::ivec2{0, botLeft.y + height}; // Jump to next row
-                assert(botLeft.y <= texHeight);
-            }
-            copyGlyph(surf, botLeft);
-            glyph.uvSizeRect = glm::vec4{
-                glm::vec2{botLeft.x, texHeight - botLeft.y - height - 1} * texSizeInv,
-                glyph.sizePx * texSizeInv
-            };
-            botLeft.x += surf->w;
-        }
-    }
+RasterizedFont::RasterizedFont(const RasterizedFontCreateInfo& createInfo) {
+    auto start      = std::chrono::steady_clock::now();
+    bool fromCache  = false;
+    FontAtlas atlas = obtainAtlas(createInfo, fromCache);
+    m_offsets.assign(atlas.offsets().begin(), atlas.offsets().end());
+    m_glyphs.assign(atlas.glyphs().begin(), atlas.glyphs().end());
+    m_lineSkipPx = atlas.lineSkipPx();
+    m_ascentPx   = atlas.ascentPx();
 
     // Create the final texture
     using enum vk::ComponentSwizzle;
     m_glyphTex = Texture{TextureCreateInfo{
         .format           = vk::Format::eR8Unorm,
-        .extent           = glm::uvec3{texWidth, texHeight, 1},
+        .extent           = glm::uvec3{atlas.dims(), 1},
         .componentMapping = {eOne, eOne, eOne, eR},
         .magFilter        = vk::Filter::eLinear,
         .minFilter        = vk::Filter::eLinear,
-        .texels           = stage
+        .texels           = atlas.texels()
     }};
+
+    std::chrono::duration<float, std::milli> duration =
+        std::chrono::steady_clock::now() - start;
+    m_stats = RasterizedFontStats{
+        .constructionTimeMs = duration.count(),
+        .glyphCount         = atlas.glyphCount(),
+        .atlasDims          = atlas.dims(),
+        .atlasOccupancy     = atlas.occupancy(),
+        .loadedFromCache    = fromCache
+    };
 }
 
 void RasterizedFont::add(
@@ -172,6 +109,17 @@ int RasterizedFont::codeToIndex(char32_t c) const {
     return 0;
 }
 
+unsigned int RasterizedFont::countGlyphs(std::u8string_view str) {
+    unsigned int count = 0;
+    while (!str.empty()) {
+        char32_t c = readCode(str);
+        if (c != U'\n' && c != k_invalidCode) {
+            ++count;
+        }
+    }
+    return count;
+}
+
 float RasterizedFont::measureLineWidth(std::u8string_view str) const {
     auto nonEndingChar = [](char32_t c) { return (c != U'\0' && c != U'\n'); };
     float widthPx      = 0.0f;
@@ -191,6 +139,7 @@ template<std::invocable<std::u8string_view> AlignFunc>
 void RasterizedFont::addGeneric(
     SpriteBatch& batch, std::u8string_view str, const AlignFunc& align, Color col
 ) const {
+    auto range         = batch.reserve(countGlyphs(str));
     glm::vec2 cursorPx = align(str);
     while (!str.empty()) {
         char32_t c = readCode(str);
@@ -199,7 +148,7 @@ void RasterizedFont::addGeneric(
         case k_invalidCode: break;
         default:
             const Glyph& glyph = m_glyphs[codeToIndex(c)];
-            batch.add(
+            range.add(
                 m_glyphTex, glm::vec4{cursorPx, glyph.sizePx}, glyph.uvSizeRect, col
             );
             cursorPx.x += glyph.advancePx;
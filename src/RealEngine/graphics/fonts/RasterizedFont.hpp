@@ -7,16 +7,21 @@
 #include <string_view>
 
 #include <RealEngine/graphics/batches/SpriteBatch.hpp>
+#include <RealEngine/graphics/fonts/FontAtlas.hpp>
 #include <RealEngine/graphics/textures/Texture.hpp>
 #include <RealEngine/utility/Unicode.hpp>
 
 namespace re {
 
-struct RasterizedFontCreateInfo {
-    std::span<const unsigned char> ttfBytes{};
-    int pointSize{};
-    int faceIndex{};
-    std::span<const UnicodeRange> ranges = k_asciiPrintableUnicodeRanges;
+/**
+ * @brief Describes construction of a RasterizedFont
+ */
+struct RasterizedFontStats {
+    float constructionTimeMs{};
+    int glyphCount{}; ///< Number of characters that have a glyph
+    glm::uvec2 atlasDims{};
+    float atlasOccupancy{}; ///< Fraction of the atlas covered by glyphs
+    bool loadedFromCache{}; ///< The atlas was not rasterized but read from the cache
 };
 
 /**
@@ -30,8 +35,13 @@ enum class HorAlign {
 
 /**
  * @brief   Renders TrueType fonts
- * @details The glyphs are rasterized to a texture during construction.
- *          The actual rendering uses the rasterized glyphs.
+ * @details The glyphs are rasterized (in parallel) and packed to a texture
+ *          during construction. The actual rendering uses the rasterized glyphs.
+ * @details The rasterized atlas is cached on disk (see FontAtlas), so later
+ *          constructions of the same font only read and upload the atlas.
+ * @details The atlas texture has a slot in the bindless texture table, so
+ *          adding text to a SpriteBatch only copies the slot to the glyphs.
+ *          The glyphs of each added string are reserved in the batch at once.
  */
 class RasterizedFont {
 public:
@@ -56,6 +66,8 @@ public:
         HorAlign horAlign, Color col = SpriteBatch::k_white
     ) const;
 
+    const RasterizedFontStats& stats() const { return m_stats; }
+
 private:
 
     /**
@@ -63,6 +75,11 @@ private:
      */
     int codeToIndex(char32_t c) const;
 
+    /**
+     * @brief Counts glyphs that are added for str
+     */
+    static unsigned int countGlyphs(std::u8string_view str);
+
     /**
      * @brief Measures width (in pixels) of the first line in str
      */
@@ -73,23 +90,18 @@ private:
         SpriteBatch& batch, std::u8string_view str, const AlignFunc& align, Color col
     ) const;
 
-    struct GlyphOffset {
-        char32_t lastChar{}; // If c is less-or-equal than this
-        int baseOffset{};    // c is at: baseOffset - (lastChar - c)
-    };
+    using GlyphOffset = FontAtlas::GlyphOffset;
     std::vector<GlyphOffset> m_offsets;
 
-    struct Glyph {
-        glm::vec4 uvSizeRect;
-        glm::vec2 sizePx;
-        float advancePx;
-    };
+    using Glyph = FontAtlas::Glyph;
     std::vector<Glyph> m_glyphs;
 
     Texture m_glyphTex;
 
     float m_lineSkipPx{};
     float m_ascentPx{};
+
+    RasterizedFontStats m_stats{};
 };
 
 } // namespace re
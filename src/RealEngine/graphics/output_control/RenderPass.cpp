@@ -2,6 +2,7 @@
  *  @author    Dubsky Tomas
  */
 #include <RealEngine/graphics/output_control/RenderPass.hpp>
+#include <RealEngine/renderer/VulkanRenderer.hpp>
 
 namespace re {
 
@@ -23,6 +24,9 @@ RenderPass& RenderPass::operator=(RenderPass&& other) noexcept {
 }
 
 RenderPass::~RenderPass() {
+    if (m_renderPass && renderer()) {
+        renderer()->renderPassDestroyed(m_renderPass);
+    }
     deletionQueue().enqueueDeletion(m_renderPass);
 }
 
@@ -26,6 +26,13 @@ PipelineLayout::PipelineLayout(
     // Create descriptor sets
     m_descriptorSetLayouts.reserve(description.bindings.size());
     for (size_t i = 0; i < description.bindings.size(); i++) {
+        // Use the external layout if there is one
+        if (i < createInfo.externalSetLayouts.size() &&
+            createInfo.externalSetLayouts.data()[i]) {
+            m_descriptorSetLayouts.emplace_back(createInfo.externalSetLayouts.data()[i]);
+            m_externalSetLayouts |= uint64_t{1} << i;
+            continue;
+        }
         // Gets flags for this descriptor set
         uint32_t flagsCount                     = 0u;
         const vk::DescriptorBindingFlags* flags = nullptr;
@@ -53,11 +60,13 @@ PipelineLayout::PipelineLayout(
 
 PipelineLayout::PipelineLayout(PipelineLayout&& other) noexcept
     : m_descriptorSetLayouts(std::exchange(other.m_descriptorSetLayouts, {}))
+    , m_externalSetLayouts(std::exchange(other.m_externalSetLayouts, 0))
     , m_pipelineLayout(std::exchange(other.m_pipelineLayout, nullptr)) {
 }
 
 PipelineLayout& PipelineLayout::operator=(PipelineLayout&& other) noexcept {
     std::swap(m_descriptorSetLayouts, other.m_descriptorSetLayouts);
+    std::swap(m_externalSetLayouts, other.m_externalSetLayouts);
     std::swap(m_pipelineLayout, other.m_pipelineLayout);
     return *this;
 }
@@ -65,7 +74,9 @@ PipelineLayout& PipelineLayout::operator=(PipelineLayout&& other) noexcept {
 PipelineLayout::~PipelineLayout() {
     deletionQueue().enqueueDeletion(m_pipelineLayout);
     for (int i = static_cast<int>(m_descriptorSetLayouts.size()) - 1; i >= 0; i--) {
-        deletionQueue().enqueueDeletion(m_descriptorSetLayouts[i]);
+        if (!(m_externalSetLayouts & (uint64_t{1} << i))) {
+            deletionQueue().enqueueDeletion(m_descriptorSetLayouts[i]);
+        }
     }
 }
 
@@ -11,6 +11,13 @@ struct PipelineLayoutCreateInfo {
     vk::ArrayProxy<vk::ArrayProxy<vk::DescriptorBindingFlags>> descriptorBindingFlags{
     };
     vk::SpecializationInfo specializationInfo{};
+    /**
+     * @brief Replace the reflected (or described) layouts of the sets with the
+     *        same indices, null layouts are not replaced
+     * @details These layouts are not owned by the pipeline layout, they are
+     *          shared (e.g. BindlessTextures::descriptorSetLayout()).
+     */
+    vk::ArrayProxy<const vk::DescriptorSetLayout> externalSetLayouts{};
 };
 
 struct PipelineLayoutDescription {
@@ -98,6 +105,7 @@ private:
     ) const;
 
     std::vector<vk::DescriptorSetLayout> m_descriptorSetLayouts{};
+    uint64_t m_externalSetLayouts = 0; ///< Bit mask of the layouts that are not owned
     vk::PipelineLayout m_pipelineLayout{};
 };
 
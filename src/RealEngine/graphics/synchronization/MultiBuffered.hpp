@@ -0,0 +1,169 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// NOLINTBEGIN(*-macro-usage): Selected by the build (REALENGINE_FRAMES_IN_FLIGHT)
+#ifndef RE_FRAMES_IN_FLIGHT
+#    define RE_FRAMES_IN_FLIGHT 2
+#endif
+// NOLINTEND(*-macro-usage)
+
+namespace re {
+
+/**
+ * @brief   The number of frames that the CPU may prepare ahead of the GPU
+ * @details Double buffering (2) has the lowest latency, triple buffering (3)
+ *          lets GPU-bound rooms queue another frame to smooth out spikes.
+ *          It is selected by the CMake cache variable REALENGINE_FRAMES_IN_FLIGHT.
+ * @details cmake/scripts/CompareFramesInFlight.cmake builds RenderBenchmarks
+ *          with each of the settings and runs the same benchmark with both.
+ */
+constexpr int k_maxFramesInFlight = RE_FRAMES_IN_FLIGHT;
+static_assert(k_maxFramesInFlight >= 2, "At least 2 frames have to be in flight");
+
+template<typename T>
+concept MultiBufferingState = requires(T) {
+    { T::k_bufferCount } -> std::convertible_to<int>;
+    { T::writeIndex() } -> std::convertible_to<int>;
+    { T::readIndex() } -> std::convertible_to<int>;
+};
+
+/**
+ * @brief Helps with managing multi-buffered objects
+ */
+template<typename T, MultiBufferingState State>
+class MultiBuffered {
+    template<class Tother, MultiBufferingState>
+    friend class MultiBuffered;
+
+public:
+    using Type = T;
+
+    static constexpr int k_bufferCount = State::k_bufferCount;
+
+    MultiBuffered() {}
+
+    template<typename... Ts>
+        requires(sizeof...(Ts) == k_bufferCount &&
+                 (std::same_as<std::remove_cvref_t<Ts>, T> && ...))
+    MultiBuffered(Ts&&... ts)
+        : m_ts{std::forward<Ts>(ts)...} {}
+
+    /**
+     * @brief Constructs each buffer by calling 'generator' with its index
+     */
+    explicit MultiBuffered(std::invocable<int> auto generator)
+        : m_ts{generate(generator, std::make_index_sequence<k_bufferCount>{})} {}
+
+    /**
+     * @brief Accesses the object that should be used for writing from CPU
+     */
+    const T& write() const { return m_ts[State::writeIndex()]; }
+    T& write() { return m_ts[State::writeIndex()]; }
+    const T& operator*() const { return write(); }
+    const T* operator->() const { return &write(); }
+    T& operator*() { return write(); }
+    T* operator->() { return &write(); }
+
+    /**
+     * @brief Accesses the object that has been written previously
+     */
+    const T& read() const { return m_ts[State::readIndex()]; }
+    T& read() { return m_ts[State::readIndex()]; }
+
+    /**
+     * @brief Calls 'func' on each buffer
+     */
+    void forEach(std::invocable<T&> auto func) {
+        for (auto& t : m_ts) { func(t); }
+    }
+
+    /**
+     * @brief Calls 'func' on each buffer of this and 'arg'
+     */
+    template<typename Arg>
+    void forEach(
+        std::invocable<T&, const Arg&> auto func, const MultiBuffered<Arg, State>& arg
+    ) {
+        for (auto it = std::make_pair(m_ts.begin(), arg.m_ts.cbegin());
+             it.first != m_ts.end(); ++it.first, ++it.second) {
+            func(*it.first, *it.second);
+        }
+    }
+
+    T& operator[](int i) { return m_ts[i]; }
+
+private:
+    template<typename Generator, size_t... k_indices>
+    static std::array<T, k_bufferCount> generate(
+        Generator& generator, std::index_sequence<k_indices...>
+    ) {
+        return {generator(static_cast<int>(k_indices))...};
+    }
+
+    std::array<T, k_bufferCount> m_ts;
+};
+
+class FrameMultiBufferingState {
+public:
+    static constexpr int k_bufferCount = k_maxFramesInFlight;
+
+    // Updated internally by RealEngine
+    static void setTotalIndex(int totalIndex) {
+        s_writeIndex = totalIndex % k_bufferCount;
+        s_readIndex  = (totalIndex + k_bufferCount - 1) % k_bufferCount;
+    }
+
+    static int writeIndex() { return s_writeIndex; }
+    static int readIndex() { return s_readIndex; }
+
+private:
+    static inline int s_writeIndex = 0;
+    static inline int s_readIndex  = k_bufferCount - 1;
+};
+static_assert(MultiBufferingState<FrameMultiBufferingState>);
+
+/**
+ * @details The indices are switched on the main thread just before a step
+ *          begins. If the step runs concurrently with rendering of a frame
+ *          (see RoomDisplaySettings::pipelinedStepping), the indices stay
+ *          the same until the step finishes.
+ */
+class StepDoubleBufferingState {
+public:
+    static constexpr int k_bufferCount = 2;
+
+    // Updated internally by RealEngine
+    static void setTotalIndex(int totalIndex) {
+        s_writeIndex = totalIndex % 2;
+        s_readIndex  = (totalIndex + 1) % 2;
+    }
+
+    static int writeIndex() { return s_writeIndex; }
+    static int readIndex() { return s_readIndex; }
+
+private:
+    static inline int s_writeIndex = 0;
+    static inline int s_readIndex  = 1;
+};
+static_assert(MultiBufferingState<StepDoubleBufferingState>);
+
+/**
+ * @brief Represents frame-wise multi-buffered object (one per frame in flight)
+ */
+template<typename T>
+using FrameMultiBuffered = MultiBuffered<T, FrameMultiBufferingState>;
+
+/**
+ * @brief Represents step-wise double buffered object
+ */
+template<typename T>
+using StepDoubleBuffered = MultiBuffered<T, StepDoubleBufferingState>;
+
+} // namespace re
@@ -1,14 +1,16 @@
 ﻿/**
  *  @author    Dubsky Tomas
  */
-#include <RealEngine/graphics/buffers/BufferMapped.hpp>
+#include <vector>
+
+#include <glm/common.hpp>
+
 #include <RealEngine/graphics/textures/Texture.hpp>
 #include <RealEngine/utility/Error.hpp>
 
 using enum vk::ImageLayout;
 using enum vk::PipelineStageFlagBits;
 using enum vma::AllocationCreateFlagBits;
-using enum vma::MemoryUsage;
 
 namespace re {
 
@@ -41,7 +43,7 @@ Texture::Texture(const TextureCreateInfo& createInfo) {
         createInfo.type,
         createInfo.format,
         {createInfo.extent.x, createInfo.extent.y, createInfo.extent.z},
-        1u, // Mip level count
+        createInfo.mipLevels,
         createInfo.layers,
         vk::SampleCountFlagBits::e1,
         vk::ImageTiling::eOptimal,
@@ -63,13 +65,13 @@ Texture::Texture(const TextureCreateInfo& createInfo) {
         initializeTexels(createInfo);
     } else if (createInfo.initialLayout != eUndefined) {
         // Transit to initial layout
-        CommandBuffer::doOneTimeSubmit([&](const CommandBuffer& cb) {
+        m_uploadTicket = uploadQueue().record([&](const CommandBuffer& cb) {
             pipelineImageBarrier(
                 cb, eUndefined,
                 createInfo.initialLayout, // Image layouts
                 eTopOfPipe,
                 eTransfer,                // Pipeline stage
-                {}, {}, createInfo.layers
+                {}, {}, createInfo.mipLevels, createInfo.layers
             );
         });
     }
@@ -82,17 +84,26 @@ Texture::Texture(const TextureCreateInfo& createInfo) {
         createInfo.componentMapping,
         vk::ImageSubresourceRange{
             createInfo.aspects,
-            0u,               // Mip level
-            1u,               // Mip level count
-            0u,               // Base array layer
-            createInfo.layers // Array layer count
+            0u,                   // Mip level
+            createInfo.mipLevels, // Mip level count
+            0u,                   // Base array layer
+            createInfo.layers     // Array layer count
         }
     });
     // Create sampler
     if (createInfo.hasSampler) {
-        m_sampler = device().createSampler(vk::SamplerCreateInfo{
+        vk::SamplerCreateInfo samplerCreateInfo{
             {}, createInfo.magFilter, createInfo.minFilter, createInfo.mipmapMode
-        });
+        };
+        samplerCreateInfo.maxLod = static_cast<float>(createInfo.mipLevels - 1);
+        m_sampler                = device().createSampler(samplerCreateInfo);
+        // Assign slot in the bindless table
+        if (createInfo.usage & eSampled) {
+            m_bindlessSlot = bindlessTextures().add(
+                m_imageView, m_sampler,
+                createInfo.initialLayout == eGeneral ? eGeneral : eShaderReadOnlyOptimal
+            );
+        }
     }
 
     setDebugUtilsObjectName(m_image, createInfo.debugName);
@@ -104,7 +115,9 @@ Texture::Texture(Texture&& other) noexcept
     : m_allocation(std::exchange(other.m_allocation, nullptr))
     , m_image(std::exchange(other.m_image, nullptr))
     , m_imageView(std::exchange(other.m_imageView, nullptr))
-    , m_sampler(std::exchange(other.m_sampler, nullptr)) {
+    , m_sampler(std::exchange(other.m_sampler, nullptr))
+    , m_uploadTicket(std::exchange(other.m_uploadTicket, 0))
+    , m_bindlessSlot(std::exchange(other.m_bindlessSlot, BindlessTextures::k_noSlot)) {
 }
 
 Texture& Texture::operator=(Texture&& other) noexcept {
@@ -112,10 +125,15 @@ Texture& Texture::operator=(Texture&& other) noexcept {
     std::swap(m_image, other.m_image);
     std::swap(m_imageView, other.m_imageView);
     std::swap(m_sampler, other.m_sampler);
+    std::swap(m_uploadTicket, other.m_uploadTicket);
+    std::swap(m_bindlessSlot, other.m_bindlessSlot);
     return *this;
 }
 
 Texture::~Texture() {
+    if (m_bindlessSlot != BindlessTextures::k_noSlot) {
+        bindlessTextures().remove(m_bindlessSlot);
+    }
     deletionQueue().enqueueDeletion(m_sampler);
     deletionQueue().enqueueDeletion(m_imageView);
     deletionQueue().enqueueDeletion(m_image);
@@ -123,19 +141,32 @@ Texture::~Texture() {
 }
 
 void Texture::initializeTexels(const TextureCreateInfo& createInfo) {
-    // Create a staging buffer
-    BufferMapped<std::byte> stagingBuffer{BufferCreateInfo{
-        .allocFlags  = eHostAccessSequentialWrite | eMapped,
-        .memoryUsage = eAutoPreferHost,
-        .sizeInBytes = createInfo.texels.size(),
-        .usage       = vk::BufferUsageFlagBits::eTransferSrc
-    }};
-    // Copy texels to the staging buffer
-    std::memcpy(
-        stagingBuffer.mapped(), createInfo.texels.data(), createInfo.texels.size()
-    );
-    // Copy data from staging buffer to the image
-    CommandBuffer::doOneTimeSubmit([&](const CommandBuffer& cb) {
+    // Describe copy of each mip level, levels are tightly packed
+    std::vector<vk::BufferImageCopy> regions;
+    regions.reserve(createInfo.mipLevels);
+    vk::DeviceSize texelCount = 0;
+    for (uint32_t level = 0; level < createInfo.mipLevels; ++level) {
+        glm::uvec3 extent = glm::max(createInfo.extent >> level, glm::uvec3{1u});
+        regions.emplace_back(
+            texelCount, // Offset in texels for now
+            0u,
+            0u,
+            vk::ImageSubresourceLayers{
+                vk::ImageAspectFlagBits::eColor,
+                level, // Mip level
+                0u,    // Base array layer
+                1u     // Array layer count
+            },
+            vk::Offset3D{0u, 0u, 0u},
+            vk::Extent3D{extent.x, extent.y, extent.z}
+        );
+        texelCount += static_cast<vk::DeviceSize>(extent.x) * extent.y * extent.z;
+    }
+    vk::DeviceSize texelSize = createInfo.texels.size() / texelCount;
+
+    // Stage the texels and record copy from the stage to the image
+    auto recordCopy = [&](const CommandBuffer& cb, vk::Buffer stage,
+                          vk::DeviceSize offset) {
         pipelineImageBarrier(
             cb, eUndefined,
             eTransferDstOptimal,                // Image layouts
@@ -143,24 +174,13 @@ void Texture::initializeTexels(const TextureCreateInfo& createInfo) {
             eAllCommands,                       // Pipeline stage
             {},
             vk::AccessFlagBits::eTransferWrite, // Access flags
+            createInfo.mipLevels,
             createInfo.layers                   // Array layer count
         );
-        cb->copyBufferToImage(
-            stagingBuffer.buffer(), m_image, eTransferDstOptimal,
-            vk::BufferImageCopy{
-                0u,
-                0u,
-                0u,
-                vk::ImageSubresourceLayers{
-                    vk::ImageAspectFlagBits::eColor,
-                    0u, // Mip level
-                    0u, // Base array layer
-                    1u  // Array layer count
-                },
-                vk::Offset3D{0u, 0u, 0u},
-                {createInfo.extent.x, createInfo.extent.y, createInfo.extent.z}
-            }
-        );
+        for (auto& region : regions) {
+            region.bufferOffset = offset + region.bufferOffset * texelSize;
+        }
+        cb->copyBufferToImage(stage, m_image, eTransferDstOptimal, regions);
         using enum vk::AccessFlagBits;
         pipelineImageBarrier(
             cb, eTransferDstOptimal,
@@ -169,15 +189,20 @@ void Texture::initializeTexels(const TextureCreateInfo& createInfo) {
             eFragmentShader,          // Pipeline stage
             eTransferWrite,
             eShaderRead,              // Access flags
+            createInfo.mipLevels,
             createInfo.layers         // Array layer count
         );
-    });
+    };
+    m_uploadTicket = uploadQueue().upload(
+        std::as_bytes(createInfo.texels), recordCopy
+    );
 }
 
 void Texture::pipelineImageBarrier(
     const CommandBuffer& cb, vk::ImageLayout oldLayout, vk::ImageLayout newLayout,
     vk::PipelineStageFlags srcStage, vk::PipelineStageFlags dstStage,
-    vk::AccessFlags srcAccess, vk::AccessFlags dstAccess, uint32_t layerCount
+    vk::AccessFlags srcAccess, vk::AccessFlags dstAccess, uint32_t levelCount,
+    uint32_t layerCount
 ) {
     cb->pipelineBarrier(
         srcStage, dstStage, vk::DependencyFlags{}, {}, // Memory barriers
@@ -189,10 +214,10 @@ void Texture::pipelineImageBarrier(
             m_image,
             vk::ImageSubresourceRange{
                 vk::ImageAspectFlagBits::eColor,
-                0u,        // Mip level
-                1u,        // Mip level count
-                0u,        // Base array layer
-                layerCount // Array layer count
+                0u,         // Mip level
+                levelCount, // Mip level count
+                0u,         // Base array layer
+                layerCount  // Array layer count
             }
         }
     );
@@ -5,7 +5,9 @@
 #include <glm/vec3.hpp>
 
 #include <RealEngine/graphics/commands/CommandBuffer.hpp>
+#include <RealEngine/renderer/BindlessTextures.hpp>
 #include <RealEngine/renderer/ObjectUsingVulkan.hpp>
+#include <RealEngine/renderer/UploadQueue.hpp>
 
 namespace re {
 
@@ -22,6 +24,7 @@ struct TextureCreateInfo {
     vk::ImageType type         = vk::ImageType::e2D;
     vk::Format format          = vk::Format::eR8G8B8A8Unorm;
     glm::uvec3 extent{};
+    uint32_t mipLevels            = 1u;
     uint32_t layers               = 1u;
     vk::ImageUsageFlags usage     = vk::ImageUsageFlagBits::eSampled;
     vk::ImageLayout initialLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
@@ -38,7 +41,8 @@ struct TextureCreateInfo {
     vk::SamplerMipmapMode mipmapMode = vk::SamplerMipmapMode::eNearest;
 
     // Raster-related
-    std::span<const unsigned char> texels; // Only for 1 layer color images
+    // Only for 1 layer color images, all mip levels (largest first) tightly packed
+    std::span<const unsigned char> texels;
 
     // Debug
     [[no_unique_address]] DebugString<> debugName;
@@ -71,11 +75,33 @@ public:
     const vk::ImageView& imageView() const { return m_imageView; }
     const vk::Sampler& sampler() const { return m_sampler; }
 
+    /**
+     * @brief Gets the persistent slot of the texture in the bindless table
+     * @return The slot or BindlessTextures::k_noSlot if the texture is not
+     * sampled or has no sampler
+     */
+    uint32_t bindlessSlot() const { return m_bindlessSlot; }
+
+    /**
+     * @brief Checks whether the texels and the initial layout have been
+     * transferred to the image
+     * @details The transfer is asynchronous but commands submitted after the
+     * creation of the texture always observe it.
+     */
+    bool isUploaded() const { return uploadQueue().isComplete(m_uploadTicket); }
+
+    /**
+     * @brief Blocks until the texels and the initial layout are transferred
+     */
+    void waitForUpload() const { uploadQueue().wait(m_uploadTicket); }
+
 private:
     vma::Allocation m_allocation{};
     vk::Image m_image{};
     vk::ImageView m_imageView{};
     vk::Sampler m_sampler{};
+    UploadQueue::Ticket m_uploadTicket = 0;
+    uint32_t m_bindlessSlot            = BindlessTextures::k_noSlot;
 
     void initializeTexels(const TextureCreateInfo& createInfo);
 
@@ -83,7 +109,7 @@ private:
         const CommandBuffer& cb, vk::ImageLayout oldLayout,
         vk::ImageLayout newLayout, vk::PipelineStageFlags srcStage,
         vk::PipelineStageFlags dstStage, vk::AccessFlags srcAccess,
-        vk::AccessFlags dstAccess, uint32_t layerCount
+        vk::AccessFlags dstAccess, uint32_t levelCount, uint32_t layerCount
     );
 };
 
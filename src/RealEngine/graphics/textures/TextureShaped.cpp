@@ -5,18 +5,36 @@
 
 namespace re {
 
+namespace {
+
+TextureShape shapeOrDefault(const TextureShape& shape, glm::uvec2 dims) {
+    return TextureShape{
+        .subimageDims = shape.subimageDims == glm::vec2{0.0f, 0.0f}
+                            ? glm::vec2{dims}
+                            : shape.subimageDims,
+        .pivot                 = shape.pivot,
+        .subimagesSpritesCount = shape.subimagesSpritesCount
+    };
+}
+
+} // namespace
+
 TextureShaped::TextureShaped(const PNGLoader::PNGData& pngData)
     : Texture(TextureCreateInfo{.extent = {pngData.dims, 1u}, .texels = pngData.texels})
-    , m_shape(TextureShape{
-          .subimageDims = pngData.shape.subimageDims == glm::vec2{0.0f, 0.0f}
-                              ? glm::vec2{pngData.dims}
-                              : pngData.shape.subimageDims,
-          .pivot        = pngData.shape.pivot,
-          .subimagesSpritesCount = pngData.shape.subimagesSpritesCount
-      })
+    , m_shape(shapeOrDefault(pngData.shape, pngData.dims))
     , m_trueDims(pngData.dims) {
 }
 
+TextureShaped::TextureShaped(const TextureContainer& container)
+    : Texture(TextureCreateInfo{
+          .extent    = {container.dims(), 1u},
+          .mipLevels = container.mipLevelCount(),
+          .texels    = container.texels()
+      })
+    , m_shape(shapeOrDefault(container.shape(), container.dims()))
+    , m_trueDims(container.dims()) {
+}
+
 TextureShaped::TextureShaped(TextureShaped&& other) noexcept
     : Texture(std::forward<Texture>(other))
     , m_shape(other.m_shape)
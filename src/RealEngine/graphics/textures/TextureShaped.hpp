@@ -9,6 +9,7 @@
 #include <RealEngine/graphics/textures/Texture.hpp>
 #include <RealEngine/graphics/textures/TextureShape.hpp>
 #include <RealEngine/resources/PNGLoader.hpp>
+#include <RealEngine/resources/TextureContainer.hpp>
 
 namespace re {
 
@@ -37,6 +38,12 @@ public:
      */
     TextureShaped(const PNGLoader::PNGData& pngData);
 
+    /**
+     * @brief   Constructs texture from texture container
+     * @details All mip levels stored in the container are used.
+     */
+    TextureShaped(const TextureContainer& container);
+
     TextureShaped(const TextureShaped&)            = delete;  ///< Noncopyable
     TextureShaped& operator=(const TextureShaped&) = delete;  ///< Noncopyable
 
@@ -0,0 +1,65 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+
+#include <RealEngine/jobs/FrameArena.hpp>
+
+namespace re {
+
+namespace {
+
+std::byte* alignUp(std::byte* ptr, size_t alignment) {
+    auto address = reinterpret_cast<uintptr_t>(ptr);
+    return ptr + ((alignment - address % alignment) % alignment);
+}
+
+} // namespace
+
+FrameArena::FrameArena(size_t capacity)
+    : m_block(std::make_unique_for_overwrite<std::byte[]>(capacity))
+    , m_capacity(capacity) {
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment) {
+    assert(std::has_single_bit(alignment));
+    // Reserve enough to align the allocation wherever it starts
+    size_t reserved = size + alignment - 1;
+    size_t offset   = m_head.fetch_add(reserved, std::memory_order_relaxed);
+    if (offset + reserved > m_capacity) {
+        return allocateOverflow(size, alignment);
+    }
+    return alignUp(m_block.get() + offset, alignment);
+}
+
+void FrameArena::reset() {
+    if (!m_overflowBlocks.empty()) {
+        // Grow so that the whole frame fits into the main block next time
+        m_capacity = std::max(m_capacity * 2, m_capacity + m_overflowSize);
+        m_block    = std::make_unique_for_overwrite<std::byte[]>(m_capacity);
+        m_overflowBlocks.clear();
+        m_overflowSize = 0;
+    }
+    m_head.store(0, std::memory_order_relaxed);
+}
+
+size_t FrameArena::used() const {
+    std::lock_guard lock{m_overflowMutex};
+    return std::min(m_head.load(std::memory_order_relaxed), m_capacity) +
+           m_overflowSize;
+}
+
+void* FrameArena::allocateOverflow(size_t size, size_t alignment) {
+    size_t reserved = size + alignment - 1;
+    std::lock_guard lock{m_overflowMutex};
+    auto& block = m_overflowBlocks.emplace_back(
+        std::make_unique_for_overwrite<std::byte[]>(reserved)
+    );
+    m_overflowSize += reserved;
+    return alignUp(block.get(), alignment);
+}
+
+} // namespace re
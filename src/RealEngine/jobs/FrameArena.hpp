@@ -0,0 +1,79 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace re {
+
+/**
+ * @brief   Is a linear allocator for temporary data of jobs within a frame
+ * @details Allocation is a single atomic addition and is thread-safe.
+ *          Allocations that do not fit are served from overflow blocks,
+ *          the arena is grown to fit them all the next time it is reset.
+ * @details The arena of the engine is reset by MainProgram at the beginning
+ *          of each frame, all its allocations are valid until then.
+ */
+class FrameArena {
+public:
+    explicit FrameArena(size_t capacity);
+
+    FrameArena(const FrameArena&)            = delete; ///< Noncopyable
+    FrameArena& operator=(const FrameArena&) = delete; ///< Noncopyable
+
+    FrameArena(FrameArena&&)            = delete;      ///< Nonmovable
+    FrameArena& operator=(FrameArena&&) = delete;      ///< Nonmovable
+
+    /**
+     * @brief Allocates uninitialized memory, thread-safe
+     * @param alignment Must be a power of two
+     */
+    void* allocate(size_t size, size_t alignment);
+
+    /**
+     * @brief Allocates value-initialized array of objects, thread-safe
+     * @note The objects are never destroyed, they must not need to be.
+     */
+    template<typename T>
+        requires std::is_trivially_destructible_v<T>
+    std::span<T> allocate(size_t count) {
+        T* ts = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        std::uninitialized_value_construct_n(ts, count);
+        return {ts, count};
+    }
+
+    /**
+     * @brief   Releases all allocations
+     * @warning Must not be called concurrently with allocations.
+     */
+    void reset();
+
+    /**
+     * @brief Gets number of bytes allocated (including alignment) since last reset
+     */
+    size_t used() const;
+
+    /**
+     * @brief Gets size of the main block of the arena
+     */
+    size_t capacity() const { return m_capacity; }
+
+private:
+    void* allocateOverflow(size_t size, size_t alignment);
+
+    std::unique_ptr<std::byte[]> m_block;
+    size_t m_capacity;
+    std::atomic<size_t> m_head = 0;
+
+    mutable std::mutex m_overflowMutex;
+    std::vector<std::unique_ptr<std::byte[]>> m_overflowBlocks;
+    size_t m_overflowSize = 0;
+};
+
+} // namespace re
@@ -0,0 +1,48 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace re {
+
+/**
+ * @brief   Counts jobs that have been scheduled with it but have not finished yet
+ * @details Used to wait for a group of jobs (JobSystem::wait) or to make
+ *          jobs depend on a group of jobs (JobSystem::scheduleAfter).
+ *          The counter can be reused once all its jobs have finished.
+ * @warning The counter must outlive all jobs that were scheduled with it.
+ */
+class JobCounter {
+public:
+    JobCounter() = default;
+
+    JobCounter(const JobCounter&)            = delete; ///< Noncopyable
+    JobCounter& operator=(const JobCounter&) = delete; ///< Noncopyable
+
+    JobCounter(JobCounter&&)            = delete;      ///< Nonmovable
+    JobCounter& operator=(JobCounter&&) = delete;      ///< Nonmovable
+
+    /**
+     * @brief Checks whether all jobs of the counter have finished
+     */
+    bool isDone() const {
+        // Locked so that the counter is not destroyed while it is being finished
+        std::lock_guard lock{m_mutex};
+        return m_pending.load(std::memory_order_relaxed) == 0;
+    }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int> m_pending{0};
+    mutable std::mutex m_mutex;
+    std::vector<std::move_only_function<void()>> m_continuations;
+    std::exception_ptr m_exception; ///< First exception thrown by a job
+};
+
+} // namespace re
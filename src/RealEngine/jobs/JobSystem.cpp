@@ -0,0 +1,203 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <format>
+
+#include <RealEngine/jobs/JobSystem.hpp>
+#include <RealEngine/program/Profiler.hpp>
+
+namespace re {
+
+JobSystem& JobSystem::shared() {
+    if (s_shared) {
+        return *s_shared;
+    }
+    static JobSystem fallback{};
+    return fallback;
+}
+
+JobSystem::JobSystem(const JobSystemCreateInfo& createInfo)
+    : m_frameArena(createInfo.frameArenaSize) {
+    unsigned int workerCount = createInfo.workerCount;
+    if (workerCount == 0) {
+        // Leave one hardware thread for the main thread
+        workerCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    }
+    m_queues = std::make_unique<Queue[]>(workerCount);
+    m_workers.reserve(workerCount);
+    for (unsigned int i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back([this, i](const std::stop_token& stopToken) {
+            work(stopToken, i);
+        });
+    }
+}
+
+JobSystem::~JobSystem() {
+    for (auto& worker : m_workers) { worker.request_stop(); }
+    m_workers.clear(); // Joins the workers
+    if (s_shared == this) {
+        s_shared = nullptr;
+    }
+}
+
+void JobSystem::schedule(Job&& job, JobCounter* counter /* = nullptr*/) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    enqueue(QueuedJob{std::move(job), counter});
+}
+
+void JobSystem::scheduleAfter(
+    JobCounter& dependency, Job&& job, JobCounter* counter /* = nullptr*/
+) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::unique_lock lock{dependency.m_mutex};
+    if (dependency.m_pending.load(std::memory_order_relaxed) == 0) {
+        lock.unlock();
+        enqueue(QueuedJob{std::move(job), counter});
+    } else {
+        dependency.m_continuations.emplace_back(
+            [this, job = std::move(job), counter]() mutable {
+                enqueue(QueuedJob{std::move(job), counter});
+            }
+        );
+    }
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    while (!counter.isDone()) {
+        if (!executeOne()) {
+            // Nothing to help with, sleep until the counter finishes
+            int pending = counter.m_pending.load(std::memory_order_relaxed);
+            if (pending != 0) {
+                counter.m_pending.wait(pending, std::memory_order_relaxed);
+            }
+        }
+    }
+    std::lock_guard lock{counter.m_mutex};
+    if (counter.m_exception) {
+        std::rethrow_exception(std::exchange(counter.m_exception, nullptr));
+    }
+}
+
+void JobSystem::enqueue(QueuedJob&& job) {
+    auto [system, index] = s_worker;
+    Queue& queue         = system == this ? m_queues[index] : m_sharedQueue;
+    m_queuedCount.fetch_add(1); // Before the push so that it never underflows
+    {
+        std::lock_guard lock{queue.mutex};
+        queue.jobs.push_back(std::move(job));
+    }
+    if (m_sleepingCount.load() > 0) {
+        // Synchronize with the worker that is going to sleep
+        { std::lock_guard lock{m_sleepMutex}; }
+        m_jobAvailable.notify_one();
+    }
+}
+
+std::optional<JobSystem::QueuedJob> JobSystem::dequeue() {
+    auto pop = [this](Queue& queue, bool newest) -> std::optional<QueuedJob> {
+        std::lock_guard lock{queue.mutex};
+        if (queue.jobs.empty()) {
+            return std::nullopt;
+        }
+        std::optional<QueuedJob> job;
+        if (newest) {
+            job.emplace(std::move(queue.jobs.back()));
+            queue.jobs.pop_back();
+        } else {
+            job.emplace(std::move(queue.jobs.front()));
+            queue.jobs.pop_front();
+        }
+        m_queuedCount.fetch_sub(1, std::memory_order_relaxed);
+        return job;
+    };
+
+    // Own queue first, then the shared queue, then steal from the others
+    auto [system, index] = s_worker;
+    bool isWorker        = system == this;
+    if (isWorker) {
+        if (auto job = pop(m_queues[index], true)) {
+            return job;
+        }
+    } else {
+        index = 0;
+    }
+    if (auto job = pop(m_sharedQueue, false)) {
+        return job;
+    }
+    for (unsigned int i = isWorker ? 1 : 0; i < workerCount(); ++i) {
+        if (auto job = pop(m_queues[(index + i) % workerCount()], false)) {
+            return job;
+        }
+    }
+    return std::nullopt;
+}
+
+bool JobSystem::executeOne() {
+    if (m_queuedCount.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+    auto job = dequeue();
+    if (job) {
+        execute(std::move(*job));
+    }
+    return job.has_value();
+}
+
+void JobSystem::execute(QueuedJob&& job) {
+    std::exception_ptr exception;
+    try {
+        job.job();
+    } catch (...) {
+        if (!job.counter) {
+            throw; // Terminates the program if this is a worker
+        }
+        exception = std::current_exception();
+    }
+    job.job = nullptr; // Destroy captured state before the counter is finished
+    finish(job.counter, exception);
+}
+
+void JobSystem::finish(JobCounter* counter, std::exception_ptr exception) {
+    if (!counter) {
+        return;
+    }
+    std::vector<std::move_only_function<void()>> continuations;
+    {
+        // The counter must not be touched after unlocking if it has finished
+        std::lock_guard lock{counter->m_mutex};
+        if (exception && !counter->m_exception) {
+            counter->m_exception = exception;
+        }
+        if (counter->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            continuations = std::move(counter->m_continuations);
+            counter->m_continuations.clear();
+            counter->m_pending.notify_all();
+        }
+    }
+    for (auto& continuation : continuations) { continuation(); }
+}
+
+void JobSystem::work(const std::stop_token& stopToken, unsigned int index) {
+    s_worker = {this, index};
+    Profiler::setThreadName(std::format("Worker {}", index));
+    while (true) {
+        if (executeOne()) {
+            continue;
+        }
+        std::unique_lock lock{m_sleepMutex};
+        m_sleepingCount.fetch_add(1);
+        bool jobAvailable = m_jobAvailable.wait(lock, stopToken, [&] {
+            return m_queuedCount.load() > 0;
+        });
+        m_sleepingCount.fetch_sub(1);
+        if (!jobAvailable) {
+            return; // Stop was requested and all jobs have been executed
+        }
+    }
+}
+
+} // namespace re
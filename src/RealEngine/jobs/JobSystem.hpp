@@ -0,0 +1,229 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <RealEngine/jobs/FrameArena.hpp>
+#include <RealEngine/jobs/JobCounter.hpp>
+
+namespace re {
+
+struct JobSystemCreateInfo {
+    /**
+     * @brief Number of worker threads, zero selects one less than the number
+     *        of hardware threads (at least one)
+     */
+    unsigned int workerCount = 0;
+    /**
+     * @brief Initial capacity of the frame arena, it grows if it is exceeded
+     */
+    size_t frameArenaSize = 1 << 20;
+};
+
+/**
+ * @brief   Executes jobs on a pool of worker threads
+ * @details Each worker has its own queue. Jobs scheduled from a worker are
+ *          pushed to its queue and it executes them newest first, jobs
+ *          scheduled from other threads are pushed to a shared queue that is
+ *          executed oldest first. Idle workers steal the oldest jobs from
+ *          queues of the other workers.
+ * @details Threads that wait for a counter execute other jobs meanwhile,
+ *          so jobs may wait for the jobs that they have scheduled.
+ * @details The job system of the engine is created by MainProgram and
+ *          is used by resource streaming and font rasterization. Rooms can
+ *          access it via Room::engine().
+ */
+class JobSystem {
+public:
+    using Job = std::move_only_function<void()>;
+
+    /**
+     * @brief Gets the job system of the engine
+     * @details This is the job system of MainProgram once it has been initialized.
+     *          Before that (or in tools that do not use MainProgram) a job
+     *          system with default create info is created when first needed.
+     */
+    static JobSystem& shared();
+
+    /**
+     * @brief This is set by the MainProgram at startup
+     */
+    static void setShared(JobSystem* jobSystem) { s_shared = jobSystem; }
+
+    explicit JobSystem(const JobSystemCreateInfo& createInfo = {});
+
+    JobSystem(const JobSystem&)            = delete; ///< Noncopyable
+    JobSystem& operator=(const JobSystem&) = delete; ///< Noncopyable
+
+    JobSystem(JobSystem&&)            = delete;      ///< Nonmovable
+    JobSystem& operator=(JobSystem&&) = delete;      ///< Nonmovable
+
+    /**
+     * @brief Executes all scheduled jobs and stops the workers
+     */
+    ~JobSystem();
+
+    /**
+     * @brief Gets number of worker threads
+     */
+    unsigned int workerCount() const {
+        return static_cast<unsigned int>(m_workers.size());
+    }
+
+    /**
+     * @brief Gets number of threads that can execute jobs at once
+     *        (the workers and the thread that waits for them)
+     */
+    unsigned int concurrency() const { return workerCount() + 1; }
+
+    /**
+     * @brief Schedules the job for execution
+     * @param counter Is incremented now and decremented when the job finishes
+     *                (optional)
+     * @note If the job throws, the exception is rethrown by wait() for the
+     *       counter. Jobs without a counter must not throw.
+     */
+    void schedule(Job&& job, JobCounter* counter = nullptr);
+
+    /**
+     * @brief Schedules the job for execution once all jobs of the dependency finish
+     * @param counter Is incremented now and decremented when the job finishes
+     *                (optional)
+     * @warning No jobs may be added to the dependency until the job is scheduled.
+     */
+    void scheduleAfter(JobCounter& dependency, Job&& job, JobCounter* counter = nullptr);
+
+    /**
+     * @brief   Blocks until all jobs of the counter finish, executes other
+     *          jobs meanwhile
+     * @throws  Rethrows the first exception thrown by a job of the counter
+     */
+    void wait(JobCounter& counter);
+
+    /**
+     * @brief Calls func(begin, end) for consecutive batches that cover [first, last)
+     * @details The batches are executed in parallel by the workers and by the
+     *          calling thread. Returns once all batches have been executed.
+     * @param batchSize Maximum number of indices in one batch
+     * @throws  Rethrows the first exception thrown by the function
+     */
+    template<std::invocable<size_t, size_t> F>
+    void parallelFor(size_t first, size_t last, size_t batchSize, F&& func);
+
+    /**
+     * @brief Gets the arena for temporary allocations of jobs
+     */
+    FrameArena& frameArena() { return m_frameArena; }
+
+private:
+    struct QueuedJob {
+        Job job;
+        JobCounter* counter;
+    };
+
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<QueuedJob> jobs;
+    };
+
+    /**
+     * @brief Shared state of a parallelFor, it outlives the call if needed
+     */
+    struct ParallelFor {
+        size_t first;
+        size_t last;
+        size_t batchSize;
+        size_t batchCount;
+        std::atomic<size_t> nextBatch = 0;
+        std::atomic<size_t> doneBatches = 0;
+        std::mutex exceptionMutex;
+        std::exception_ptr exception;
+
+        template<typename F>
+        void execute(F& func);
+    };
+
+    void enqueue(QueuedJob&& job);
+    std::optional<QueuedJob> dequeue();
+    bool executeOne();
+    void execute(QueuedJob&& job);
+    void finish(JobCounter* counter, std::exception_ptr exception);
+    void work(const std::stop_token& stopToken, unsigned int index);
+
+    static inline JobSystem* s_shared = nullptr;
+
+    static inline thread_local std::pair<const JobSystem*, unsigned int>
+        s_worker{}; ///< The system and index of the worker that is this thread
+
+    std::unique_ptr<Queue[]> m_queues; ///< One per worker
+    Queue m_sharedQueue;               ///< For jobs scheduled from other threads
+    std::atomic<size_t> m_queuedCount = 0;
+    std::atomic<unsigned int> m_sleepingCount = 0;
+    std::mutex m_sleepMutex;
+    std::condition_variable_any m_jobAvailable;
+    FrameArena m_frameArena;
+    std::vector<std::jthread> m_workers; ///< Last, so that they are started last
+};
+
+template<std::invocable<size_t, size_t> F>
+void JobSystem::parallelFor(size_t first, size_t last, size_t batchSize, F&& func) {
+    if (first >= last) {
+        return;
+    }
+    batchSize         = std::max<size_t>(batchSize, 1);
+    size_t batchCount = (last - first + batchSize - 1) / batchSize;
+    if (batchCount == 1) {
+        func(first, last);
+        return;
+    }
+
+    // Helpers may start after the call has returned, so the state is shared
+    auto state = std::make_shared<ParallelFor>(first, last, batchSize, batchCount);
+    size_t helperCount = std::min<size_t>(batchCount - 1, workerCount());
+    for (size_t i = 0; i < helperCount; ++i) {
+        schedule([state, &func] { state->execute(func); });
+    }
+    state->execute(func);
+
+    // Wait for batches being executed by the helpers
+    for (size_t done = state->doneBatches; done < batchCount; done = state->doneBatches) {
+        state->doneBatches.wait(done);
+    }
+    if (state->exception) {
+        std::rethrow_exception(state->exception);
+    }
+}
+
+template<typename F>
+void JobSystem::ParallelFor::execute(F& func) {
+    // The function is only accessed while there are batches left
+    for (size_t batch = nextBatch++; batch < batchCount; batch = nextBatch++) {
+        size_t begin = first + batch * batchSize;
+        try {
+            func(begin, std::min(begin + batchSize, last));
+        } catch (...) {
+            std::lock_guard lock{exceptionMutex};
+            if (!exception) {
+                exception = std::current_exception();
+            }
+        }
+        if (++doneBatches == batchCount) {
+            doneBatches.notify_all();
+        }
+    }
+}
+
+} // namespace re
@@ -0,0 +1,23 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <cstdint>
+
+namespace re {
+
+/**
+ * @brief Provides info required to run a RealEngine application as a benchmark
+ * @details Input recorded by MainProgramInitInfo::inputRecordPath is replayed
+ *          with steps decoupled from wall time, as fast as possible. When the
+ *          recorded input ends, steps per second and frame statistics are
+ *          reported and the program exits. Two builds can be compared
+ *          by replaying the same log.
+ */
+struct BenchmarkInitInfo {
+    const char* inputLogPath{};      ///< Path to the replayed input log
+    uint32_t stepsPerFrame = 1;      ///< Exact number of steps in each frame
+    const char* statisticsCSVPath{}; ///< Frame statistics are also written here
+};
+
+} // namespace re
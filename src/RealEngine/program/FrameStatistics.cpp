@@ -0,0 +1,154 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <algorithm>
+#include <format>
+#include <fstream>
+
+#include <RealEngine/program/FrameStatistics.hpp>
+#include <RealEngine/utility/Error.hpp>
+
+namespace re {
+
+template<size_t k_fieldCount>
+void FrameStatistics::SampleRing<k_fieldCount>::push(const Sample& sample) {
+    size_t index = m_written.load(std::memory_order_relaxed);
+    m_started.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    auto& slot = m_slots[index % k_capacity];
+    for (size_t i = 0; i < k_fieldCount; ++i) {
+        slot[i].store(sample[i], std::memory_order_relaxed);
+    }
+    m_written.store(index + 1, std::memory_order_release);
+}
+
+template<size_t k_fieldCount>
+auto FrameStatistics::SampleRing<k_fieldCount>::read(size_t maxCount) const
+    -> std::vector<Sample> {
+    size_t end   = m_written.load(std::memory_order_acquire);
+    size_t begin = end - std::min({end, maxCount, k_capacity});
+    std::vector<Sample> samples(end - begin);
+    for (size_t index = begin; index < end; ++index) {
+        const auto& slot = m_slots[index % k_capacity];
+        for (size_t i = 0; i < k_fieldCount; ++i) {
+            samples[index - begin][i] = slot[i].load(std::memory_order_relaxed);
+        }
+    }
+    // Drop the samples whose slots have been reused by the writer meanwhile
+    std::atomic_thread_fence(std::memory_order_acquire);
+    size_t started = m_started.load(std::memory_order_relaxed);
+    if (started > begin + k_capacity) {
+        size_t overwritten = std::min(started - k_capacity - begin, samples.size());
+        samples.erase(samples.begin(), samples.begin() + overwritten);
+    }
+    return samples;
+}
+
+void FrameStatistics::recordFrame(const Frame& frame) {
+    decltype(m_frames)::Sample sample{};
+    sample[0] = frame.total.count();
+    for (size_t i = 0; i < k_framePhaseCount; ++i) {
+        sample[i + 1] = frame.phases[i].count();
+    }
+    sample[k_framePhaseCount + 1] = frame.stepCount;
+    m_frames.push(sample);
+}
+
+void FrameStatistics::recordStep(Duration duration) {
+    m_steps.push({duration.count()});
+}
+
+std::vector<FrameStatistics::Frame> FrameStatistics::frames(size_t maxCount) const {
+    auto samples = m_frames.read(maxCount);
+    std::vector<Frame> frames(samples.size());
+    for (size_t f = 0; f < samples.size(); ++f) {
+        frames[f].total = Duration{samples[f][0]};
+        for (size_t i = 0; i < k_framePhaseCount; ++i) {
+            frames[f].phases[i] = Duration{samples[f][i + 1]};
+        }
+        frames[f].stepCount = static_cast<uint32_t>(samples[f][k_framePhaseCount + 1]);
+    }
+    return frames;
+}
+
+std::vector<FrameStatistics::Duration> FrameStatistics::steps(size_t maxCount) const {
+    auto samples = m_steps.read(maxCount);
+    std::vector<Duration> steps(samples.size());
+    for (size_t s = 0; s < samples.size(); ++s) { steps[s] = Duration{samples[s][0]}; }
+    return steps;
+}
+
+FrameStatistics::Percentiles FrameStatistics::percentiles(Metric metric) const {
+    auto sorted = durations(metric);
+    if (sorted.empty()) {
+        return Percentiles{};
+    }
+    std::sort(sorted.begin(), sorted.end());
+    auto at = [&](double fraction) {
+        // Nearest-rank percentile
+        auto rank = static_cast<size_t>(fraction * static_cast<double>(sorted.size()));
+        return sorted[std::min(rank, sorted.size() - 1)];
+    };
+    return Percentiles{
+        .p50         = at(0.5),
+        .p95         = at(0.95),
+        .p99         = at(0.99),
+        .p999        = at(0.999),
+        .max         = sorted.back(),
+        .sampleCount = sorted.size()
+    };
+}
+
+std::vector<uint32_t> FrameStatistics::histogram(
+    Metric metric, Duration bucketWidth, size_t bucketCount
+) const {
+    std::vector<uint32_t> buckets(bucketCount);
+    if (bucketCount == 0 || bucketWidth <= Duration::zero()) {
+        return buckets;
+    }
+    for (Duration duration : durations(metric)) {
+        auto bucket = static_cast<size_t>(
+            std::max(duration / bucketWidth, Duration::rep{0})
+        );
+        buckets[std::min(bucket, bucketCount - 1)]++;
+    }
+    return buckets;
+}
+
+void FrameStatistics::writeCSV(const std::filesystem::path& path) const {
+    std::ofstream file{path, std::ios::trunc};
+    auto ms = [](Duration duration) {
+        return std::chrono::duration<double, std::milli>{duration}.count();
+    };
+    file << "frame,total_ms,input_ms,step_ms,record_ms,submit_ms,present_wait_ms,steps\n";
+    auto frames       = this->frames();
+    size_t firstIndex = recordedFrameCount() - frames.size();
+    for (size_t f = 0; f < frames.size(); ++f) {
+        const Frame& frame = frames[f];
+        file << std::format(
+            "{},{:.3f},{:.3f},{:.3f},{:.3f},{:.3f},{:.3f},{}\n", firstIndex + f,
+            ms(frame.total), ms(frame[FramePhase::Input]), ms(frame[FramePhase::Step]),
+            ms(frame[FramePhase::Record]), ms(frame[FramePhase::Submit]),
+            ms(frame[FramePhase::PresentWait]), frame.stepCount
+        );
+    }
+    if (!file) {
+        throw Exception{std::format("Could not write {}", path.string())};
+    }
+}
+
+std::vector<FrameStatistics::Duration> FrameStatistics::durations(Metric metric) const {
+    if (metric == Metric::SingleStep) {
+        return steps();
+    }
+    auto frames = this->frames();
+    std::vector<Duration> durations(frames.size());
+    for (size_t f = 0; f < frames.size(); ++f) {
+        durations[f] = metric == Metric::FrameTotal
+                           ? frames[f].total
+                           : frames[f].phases[static_cast<size_t>(metric) - 1];
+    }
+    return durations;
+}
+
+} // namespace re
@@ -0,0 +1,150 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace re {
+
+/**
+ * @brief Is a part of a frame whose duration is measured
+ */
+enum class FramePhase {
+    Input,       ///< Polling of input events
+    Step,        ///< Simulation steps (and waiting for the pipelined step)
+    Record,      ///< Preparation and recording of the frame
+    Submit,      ///< Submission and presentation of the frame
+    PresentWait  ///< Waiting for the GPU to release resources of the frame
+};
+constexpr size_t k_framePhaseCount = 5;
+
+/**
+ * @brief   Keeps durations of recent frames and steps and evaluates them
+ * @details The durations are kept in lock-free ring buffers. They are recorded
+ *          by the main loop and can be read from any thread at any time.
+ */
+class FrameStatistics {
+public:
+    using Duration = std::chrono::steady_clock::duration;
+
+    /**
+     * @brief Maximum number of frames (and steps) that are kept
+     */
+    static constexpr size_t k_capacity = 1024;
+
+    struct Frame {
+        Duration total{}; ///< From the beginning to the beginning of the next frame
+        std::array<Duration, k_framePhaseCount> phases{};
+        uint32_t stepCount{};
+
+        Duration& operator[](FramePhase phase) {
+            return phases[static_cast<size_t>(phase)];
+        }
+        Duration operator[](FramePhase phase) const {
+            return phases[static_cast<size_t>(phase)];
+        }
+    };
+
+    /**
+     * @brief Selects the durations to evaluate
+     */
+    enum class Metric {
+        FrameTotal,  ///< Whole frames
+        Input,       ///< FramePhase::Input of frames
+        Step,        ///< FramePhase::Step of frames
+        Record,      ///< FramePhase::Record of frames
+        Submit,      ///< FramePhase::Submit of frames
+        PresentWait, ///< FramePhase::PresentWait of frames
+        SingleStep   ///< Individual simulation steps
+    };
+
+    struct Percentiles {
+        Duration p50{};
+        Duration p95{};
+        Duration p99{};
+        Duration p999{};
+        Duration max{};
+        size_t sampleCount{};
+    };
+
+    /**
+     * @brief Records the frame, must not be called concurrently with itself
+     */
+    void recordFrame(const Frame& frame);
+
+    /**
+     * @brief Records duration of a step, must not be called concurrently with itself
+     */
+    void recordStep(Duration duration);
+
+    /**
+     * @brief Gets recent frames, oldest first
+     * @param maxCount Limits the number of the most recent frames
+     */
+    std::vector<Frame> frames(size_t maxCount = k_capacity) const;
+
+    /**
+     * @brief Gets durations of recent steps, oldest first
+     * @param maxCount Limits the number of the most recent steps
+     */
+    std::vector<Duration> steps(size_t maxCount = k_capacity) const;
+
+    /**
+     * @brief Gets total number of frames that have been recorded
+     */
+    size_t recordedFrameCount() const { return m_frames.recordedCount(); }
+
+    /**
+     * @brief Computes percentiles of the metric over the kept durations
+     */
+    Percentiles percentiles(Metric metric) const;
+
+    /**
+     * @brief Counts the kept durations of the metric in buckets of the width
+     * @details The last bucket also counts all longer durations.
+     */
+    std::vector<uint32_t> histogram(
+        Metric metric, Duration bucketWidth, size_t bucketCount
+    ) const;
+
+    /**
+     * @brief   Writes the kept frames to a CSV file, durations are in milliseconds
+     * @throws  Throws if the file cannot be written
+     */
+    void writeCSV(const std::filesystem::path& path) const;
+
+private:
+    /**
+     * @brief Is a single-writer, multi-reader ring buffer of samples
+     * @details Readers detect samples that were overwritten while being read
+     *          (like with a seqlock) and drop them.
+     */
+    template<size_t k_fieldCount>
+    class SampleRing {
+    public:
+        using Sample = std::array<int64_t, k_fieldCount>;
+
+        void push(const Sample& sample);
+        std::vector<Sample> read(size_t maxCount) const;
+        size_t recordedCount() const {
+            return m_written.load(std::memory_order_acquire);
+        }
+
+    private:
+        std::array<std::array<std::atomic<int64_t>, k_fieldCount>, k_capacity> m_slots{};
+        std::atomic<size_t> m_started = 0; ///< Incremented before a sample is written
+        std::atomic<size_t> m_written = 0; ///< Incremented after a sample is written
+    };
+
+    std::vector<Duration> durations(Metric metric) const;
+
+    SampleRing<k_framePhaseCount + 2> m_frames; ///< Total, phases, step count
+    SampleRing<1> m_steps;
+};
+
+} // namespace re
@@ -0,0 +1,24 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include <glm/vec2.hpp>
+
+namespace re {
+
+/**
+ * @brief Provides info required to run a RealEngine application without a display
+ * @details The frames are rendered into offscreen images and never presented.
+ *          This is intended for benchmarks and automated tests.
+ */
+struct HeadlessInitInfo {
+    glm::uvec2 extent{1280, 720};      ///< Of the offscreen images
+    uint64_t frameCount{};             ///< Exits after this many frames, 0 never exits
+    uint64_t captureInterval{};        ///< Every n-th frame is saved, 0 saves none
+    std::string captureDir = "frames"; ///< Where the captured frames are saved
+};
+
+} // namespace re
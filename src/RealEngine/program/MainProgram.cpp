@@ -1,19 +1,57 @@
 /**
  *  @author    Dubsky Tomas
  */
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <filesystem>
+#include <format>
 #include <fstream>
 #include <iostream>
+#include <utility>
 
 #include <SDL_events.h>
 #include <glm/common.hpp>
 
-#include <RealEngine/graphics/synchronization/DoubleBuffered.hpp>
+#include <RealEngine/graphics/synchronization/MultiBuffered.hpp>
 #include <RealEngine/program/MainProgram.hpp>
+#include <RealEngine/program/Profiler.hpp>
+#include <RealEngine/resources/ResourceManager.hpp>
 #include <RealEngine/rooms/Room.hpp>
 
 namespace re {
 
+namespace {
+
+constexpr std::array<const char*, k_framePhaseCount> k_framePhaseNames{
+    "Input", "Step", "Record", "Submit", "PresentWait"
+};
+
+WindowSettings windowSettings(const HeadlessInitInfo* headless) {
+    WindowSettings saved{};
+    if (!headless) {
+        return saved;
+    }
+    WindowFlags flags = saved.flags();
+    flags.headless    = true;
+    flags.fullscreen  = false;
+    return WindowSettings{
+        glm::ivec2{headless->extent},
+        glm::ivec2{WindowSettings::k_centeredWindowPosition}, flags,
+        saved.preferredDevice()
+    };
+}
+
+VulkanInitInfo vulkanInitInfo(const MainProgramInitInfo& initInfo) {
+    VulkanInitInfo vulkan = initInfo.vulkan;
+    if (initInfo.headless) {
+        vulkan.headlessExtent = initInfo.headless->extent;
+    }
+    return vulkan;
+}
+
+} // namespace
+
 void MainProgram::initialize(const MainProgramInitInfo& initInfo) {
     // Force initialization of the singleton instance
     instance(initInfo);
@@ -88,13 +126,23 @@ void MainProgram::setRelativeCursorMode(bool relative) {
 }
 
 void MainProgram::adoptRoomDisplaySettings(const RoomDisplaySettings& s) {
+    if (m_stepThread.isCallerStepThread()) {
+        // The frame is being rendered concurrently, adopt the settings later
+        m_settingsFromPipelinedStep = s;
+        return;
+    }
     m_synchronizer.setStepsPerSecond(s.stepsPerSecond);
-    m_synchronizer.setFramesPerSecondLimit(s.framesPerSecondLimit);
+    m_synchronizer.setCatchUpPolicy(s.stepCatchUp);
+    m_stepsPerSecond = m_synchronizer.stepsPerSecond();
+    m_synchronizer.setFramesPerSecondLimit(
+        m_benchmark ? Synchronizer::k_doNotLimitFramesPerSecond : s.framesPerSecondLimit
+    );
+    m_pipelinedStepping = s.pipelinedStepping;
 }
 
 int MainProgram::doRun(size_t roomName, const RoomTransitionArguments& args) {
     scheduleRoomTransition(roomName, args);
-    doRoomTransitionIfScheduled();
+    doRoomTransitionIfScheduled(true);
     if (!m_roomManager.currentRoom()) {
         throw std::runtime_error("Initial room was not set");
     }
@@ -104,122 +152,283 @@ int MainProgram::doRun(size_t roomName, const RoomTransitionArguments& args) {
 
     m_programShouldRun = true;
     m_synchronizer.resumeSteps();
+    if (m_benchmark) {
+        m_benchmark->start = std::chrono::steady_clock::now();
+    }
 
     // MAIN PROGRAM LOOP
     std::cout << "Entering main loop!" << std::endl;
     while (m_programShouldRun) {
         m_synchronizer.beginFrame();
+        if (m_synchronizer.stepsPerSecond() != m_stepsPerSecond) {
+            // The step rate has been adapted by the catch-up policy
+            auto newRate = m_synchronizer.stepsPerSecond();
+            auto oldRate = std::exchange(m_stepsPerSecond, newRate);
+            m_roomManager.currentRoom()->stepRateChangedCallback(oldRate, newRate);
+        }
+        auto frameStart = std::chrono::steady_clock::now();
+        auto lapStart   = frameStart;
+        FrameStatistics::Frame frameStats{};
+        // Attributes the time since the last lap to the phase
+        auto lap = [&](FramePhase phase) {
+            auto now = std::chrono::steady_clock::now();
+            frameStats[phase] += now - lapStart;
+            if (Profiler::enabled()) {
+                Profiler::recordZone(
+                    k_framePhaseNames[static_cast<size_t>(phase)], lapStart, now
+                );
+            }
+            lapStart = now;
+        };
+
+        // Allocations of the previous frame are no longer used
+        m_jobSystem.frameArena().reset();
+
+        // Create GPU objects of resources streamed in since the last frame
+        ResourceManager::finishStreamedLoads();
+        lapStart = std::chrono::steady_clock::now();
+
+        bool precisePacing = m_synchronizer.framePacing() ==
+                             Synchronizer::FramePacing::Precise;
+        if (precisePacing) {
+            // Wait for the GPU before the input is sampled to keep it fresh
+            m_renderer.waitForFrameResources();
+            lap(FramePhase::PresentWait);
+        }
+
+        // Receive input events, they are distributed among the steps below
+        if (m_pollEventsInMainThread && !m_benchmark) {
+            pollEvents();
+        } else {
+            SDL_PumpEvents();
+        }
 
         // Perform simulation steps to catch up the time
-        while (m_synchronizer.shouldStepHappen()) {
+        int stepCount = 0;
+        if (m_benchmark) {
+            // Steps are decoupled from wall time
+            stepCount = static_cast<int>(m_benchmark->stepsPerFrame);
+        } else {
+            while (m_synchronizer.shouldStepHappen()) { ++stepCount; }
+        }
+        for (int i = 0; i < stepCount; ++i) {
             // Check for user input
-            if (m_pollEventsInMainThread) {
-                m_inputManager.step();
-                pollEvents();
-            } else {
-                SDL_PumpEvents();
+            if (!sampleInput(i, stepCount)) {
+                stepCount = i; // The replayed input has ended
+                break;
             }
+            lap(FramePhase::Input);
             // Do the simulation step
-            step();
+            if (m_pipelinedStepping && i == stepCount - 1) {
+                // The last step runs concurrently with the drawing
+                beginStep();
+                m_stepThread.launch([this] { simulateStep(); });
+            } else {
+                step();
+            }
+            lap(FramePhase::Step);
+        }
+        frameStats.stepCount = static_cast<uint32_t>(stepCount);
+
+        if (!precisePacing) {
+            m_renderer.waitForFrameResources();
+            lap(FramePhase::PresentWait);
         }
 
         // Prepare for drawing
         const CommandBuffer& cb = m_renderer.prepareFrame();
 
         // Draw the frame
-        render(cb, m_synchronizer.drawInterpolationFactor());
+        render(cb, m_benchmark ? 0.0 : m_synchronizer.drawInterpolationFactor());
+        if (m_headless) {
+            finishHeadlessFrame();
+        }
+        lap(FramePhase::Record);
 
         // Finish the drawing
         m_renderer.finishFrame();
+        m_synchronizer.frameSubmitted(
+            m_renderer.lastSubmitTime(), m_renderer.frameResourcesWaitTime()
+        );
+        lap(FramePhase::Submit);
+
+        joinPipelinedStep();
+        lap(FramePhase::Step);
 
         performHotReload();
 
         doRoomTransitionIfScheduled();
 
         m_synchronizer.endFrame();
+        frameStats.total = std::chrono::steady_clock::now() - frameStart;
+        m_synchronizer.frameStatistics().recordFrame(frameStats);
+        Profiler::endFrame();
     }
     std::cout << "Leaving main loop!" << std::endl;
+    m_jobSystem.wait(m_preloadCounter);
 
     // Exit the program
     m_roomManager.currentRoom()->sessionEnd();
+    ResourceManager::releaseRetainedResources();
     m_renderer.prepareForDestructionOfRendererObjects();
 
     return m_programExitCode;
 }
 
 void MainProgram::step() {
+    beginStep();
+    simulateStep();
+}
+
+void MainProgram::beginStep() {
     StepDoubleBufferingState::setTotalIndex(++m_stepN);
+}
+
+void MainProgram::simulateStep() {
     m_renderer.deletionQueue().startNextIteration(DeletionQueue::Timeline::Step);
+    ProfilerZone zone{"Room::step"};
+    auto start = std::chrono::steady_clock::now();
     m_roomManager.currentRoom()->step();
+    auto duration = std::chrono::steady_clock::now() - start;
+    m_synchronizer.frameStatistics().recordStep(duration);
 }
 
 void MainProgram::render(const CommandBuffer& cb, double interpolationFactor) {
+    ProfilerZone zone{"Room::render"};
     m_roomManager.currentRoom()->render(cb, interpolationFactor);
 }
 
-void MainProgram::processEvent(SDL_Event* evnt) {
-    Key key = Key::UnknownKey;
-    switch (evnt->type) {
-    case SDL_KEYDOWN:
-        key = toKey(evnt->key.keysym.sym);
-        if (evnt->key.repeat == 0) {
-            m_inputManager.press(key);
-        }
-        break;
-    case SDL_KEYUP:
-        if (evnt->key.repeat == 0) {
-            m_inputManager.release(toKey(evnt->key.keysym.sym));
-        }
-        break;
-    case SDL_MOUSEBUTTONDOWN:
-        if (evnt->key.repeat == 0) {
-            auto key = toKey(evnt->button.button);
-            m_inputManager.press(key, evnt->button.clicks);
+void MainProgram::performHotReload() {
+#if RE_BUILDING_FOR_DEBUG
+    auto callback = [this](vk::Pipeline pipeline, int identifier) {
+        m_roomManager.notifyRooms<&Room::pipelineReloadedCallback>(pipeline, identifier);
+    };
+    if (m_pipelineHotLoader.reloadChangedPipelines(callback) > 0) {
+        SDL_RaiseWindow(m_window.sdlWindow());
+    }
+#endif // RE_BUILDING_FOR_DEBUG
+}
+
+void MainProgram::joinPipelinedStep() {
+    m_stepThread.join();
+    if (m_settingsFromPipelinedStep) {
+        adoptRoomDisplaySettings(*m_settingsFromPipelinedStep);
+        m_settingsFromPipelinedStep.reset();
+    }
+}
+
+bool MainProgram::sampleInput(int stepIndex, int stepCount) {
+    if (m_benchmark) {
+        // Live input is ignored
+        m_inputEventSource.discard();
+        m_inputManager.step();
+        if (!m_benchmark->replay.readStep(m_inputManager)) {
+            finishBenchmark();
+            return false;
         }
-        break;
-    case SDL_MOUSEBUTTONUP:
-        if (evnt->key.repeat == 0) {
-            m_inputManager.release(toKey(evnt->button.button));
+        m_synchronizer.inputSampled();
+    } else if (m_pollEventsInMainThread) {
+        m_inputManager.step();
+        auto until = stepIndex == stepCount - 1
+                         ? InputEvent::TimePoint::max()
+                         : m_synchronizer.stepTime(stepIndex, stepCount);
+        m_receivedEvents.clear();
+        m_inputEventSource.popUntil(until, m_receivedEvents);
+        for (const auto& event : m_receivedEvents) { applyInputEvent(event); }
+        m_synchronizer.inputSampled();
+        if (m_inputRecorder) {
+            m_inputRecorder->writeStep(m_inputManager);
         }
-        break;
-    case SDL_MOUSEMOTION:
+    } else {
+        m_inputEventSource.discard(); // The events are received elsewhere
+    }
+    return true;
+}
+
+void MainProgram::applyInputEvent(InputEvent event) {
+    const auto& displaySettings = m_roomManager.currentRoom()->displaySettings();
+    if (displaySettings.imGuiSubpassIndex != RoomDisplaySettings::k_notUsingImGui &&
+        m_window.isCapturedByImGui(event)) {
+        return;
+    }
+    if (event.type == InputEventType::CursorMove) {
         // Y coords are inverted to get standard math coordinates
         // Coords also have to be clamped to window dims
         // because SDL reports coords outside of the window when a key is held
-        m_inputManager.setCursor(
-            glm::clamp(
-                {evnt->motion.x, m_window.dims().y - evnt->motion.y - 1},
-                glm::ivec2(0), m_window.dims() - 1
-            ),
-            {evnt->motion.xrel, -evnt->motion.yrel}
+        event.cursorAbs = glm::clamp(
+            {event.cursorAbs.x, m_window.dims().y - event.cursorAbs.y - 1},
+            glm::ivec2(0), m_window.dims() - 1
         );
-        break;
-    case SDL_MOUSEWHEEL:
-        key = (evnt->wheel.y > 0) ? (Key::UMW) : (Key::DMW);
-        m_inputManager.press(key, std::abs(evnt->wheel.y));
-
-        key = (evnt->wheel.x > 0) ? (Key::RMW) : (Key::LMW);
-        m_inputManager.press(key, std::abs(evnt->wheel.x));
-        break;
-    case SDL_QUIT: scheduleExit(); break;
+        event.cursorRel.y = -event.cursorRel.y;
     }
+    m_inputManager.apply(event);
 }
 
-void MainProgram::performHotReload() {
-#if RE_BUILDING_FOR_DEBUG
-    auto callback = [this](vk::Pipeline pipeline, int identifier) {
-        m_roomManager.notifyRooms<&Room::pipelineReloadedCallback>(pipeline, identifier);
+void MainProgram::finishHeadlessFrame() {
+    ++m_headlessFrameN;
+    uint64_t interval = m_headless->captureInterval;
+    if (interval > 0 && m_headlessFrameN % interval == 0) {
+        m_renderer.captureFrame(std::format(
+            "{}/frame{:06}.png", m_headless->captureDir, m_headlessFrameN
+        ));
+    }
+    if (m_headless->frameCount > 0 && m_headlessFrameN >= m_headless->frameCount) {
+        scheduleExit();
+    }
+}
+
+void MainProgram::finishBenchmark() {
+    auto elapsed      = std::chrono::steady_clock::now() - m_benchmark->start;
+    double seconds    = std::chrono::duration<double>{elapsed}.count();
+    const auto& stats = m_synchronizer.frameStatistics();
+    uint64_t steps    = m_benchmark->replay.stepCount();
+    size_t frames     = stats.recordedFrameCount();
+    std::cout << std::format(
+        "Benchmark finished: {} steps and {} frames in {:.3f} s\n"
+        "    {:.1f} steps/s, {:.1f} frames/s, {} frames in flight\n",
+        steps, frames, seconds, static_cast<double>(steps) / seconds,
+        static_cast<double>(frames) / seconds, k_maxFramesInFlight
+    );
+    auto ms = [](FrameStatistics::Duration duration) {
+        return std::chrono::duration<double, std::milli>{duration}.count();
     };
-    if (m_pipelineHotLoader.reloadChangedPipelines(callback) > 0) {
-        SDL_RaiseWindow(m_window.sdlWindow());
+    auto report = [&](const char* name, FrameStatistics::Metric metric) {
+        auto p = stats.percentiles(metric);
+        std::cout << std::format(
+            "    {:<12} p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms "
+            "(last {} samples)\n",
+            name, ms(p.p50), ms(p.p95), ms(p.p99), ms(p.max), p.sampleCount
+        );
+    };
+    using enum FrameStatistics::Metric;
+    report("Frame", FrameTotal);
+    report("Step", SingleStep);
+    report("Record", Record);
+    report("Submit", Submit);
+    report("PresentWait", PresentWait);
+    if (!m_benchmark->statisticsCSVPath.empty()) {
+        stats.writeCSV(m_benchmark->statisticsCSVPath);
     }
-#endif // RE_BUILDING_FOR_DEBUG
+    scheduleExit();
 }
 
-void MainProgram::doRoomTransitionIfScheduled() {
+void MainProgram::doRoomTransitionIfScheduled(bool waitForPreload /* = false*/) {
     if (m_nextRoomName == k_noNextRoom)
         return;
 
+    // The current room keeps running until the next room is preloaded
+    startPreloadOfNextRoom();
+    if (waitForPreload) {
+        m_jobSystem.wait(m_preloadCounter);
+        startPreloadOfNextRoom(); // In case an outdated preload has just finished
+        m_jobSystem.wait(m_preloadCounter);
+    }
+    if (m_preloadedRoomName != m_nextRoomName || !m_preloadCounter.isDone()) {
+        return;
+    }
+    m_jobSystem.wait(m_preloadCounter); // Rethrows exception thrown by the preload
+    m_preloadedRoomName = k_noNextRoom;
+
     m_synchronizer.pauseSteps();
     auto transitionTo = m_nextRoomName;
     auto prev         = m_roomManager.currentRoom();
@@ -248,32 +457,77 @@ void MainProgram::scheduleRoomTransition(
 ) {
     m_nextRoomName       = name;
     m_roomTransitionArgs = args;
+    startPreloadOfNextRoom();
+}
+
+void MainProgram::startPreloadOfNextRoom() {
+    if (m_preloadedRoomName == m_nextRoomName || !m_preloadCounter.isDone()) {
+        return; // Already preloaded or another room is still being preloaded
+    }
+    m_jobSystem.wait(m_preloadCounter); // Rethrows exception of the previous preload
+    m_preloadedRoomName = m_nextRoomName;
+    Room* next          = m_roomManager.room(m_nextRoomName);
+    if (next == m_roomManager.currentRoom()) {
+        // The room is running so it cannot be preloaded concurrently
+        if (next) {
+            next->preload(m_roomTransitionArgs);
+        }
+    } else if (next) {
+        m_jobSystem.schedule(
+            [next, args = m_roomTransitionArgs] { next->preload(args); },
+            &m_preloadCounter
+        );
+    }
 }
 
 void MainProgram::pollEvents() {
+    // Input events have already been collected by m_inputEventSource
     SDL_Event evnt;
     const auto& displaySettings = m_roomManager.currentRoom()->displaySettings();
-    if (displaySettings.imGuiSubpassIndex != RoomDisplaySettings::k_notUsingImGui) {
-        while (SDL_PollEvent(&evnt)) {
-            if (!m_window.passSDLEvent(evnt)) {
-                // Pass the event to main application if it has not been consumed by ImGui
-                processEvent(&evnt);
-            }
+    bool usingImGui = displaySettings.imGuiSubpassIndex !=
+                      RoomDisplaySettings::k_notUsingImGui;
+    while (SDL_PollEvent(&evnt)) {
+        if (usingImGui) {
+            m_window.passSDLEvent(evnt);
+        }
+        if (evnt.type == SDL_QUIT) {
+            scheduleExit();
         }
-    } else {
-        while (SDL_PollEvent(&evnt)) { processEvent(&evnt); }
     }
 }
 
 MainProgram::MainProgram(const MainProgramInitInfo& initInfo)
-    : m_window{WindowSettings{}, WindowSubsystems::RealEngineVersionString()}
+    : m_jobSystem{initInfo.jobs}
+    , m_window{windowSettings(initInfo.headless),
+               WindowSubsystems::RealEngineVersionString()}
     , m_renderer{m_window.sdlWindow(), m_window.isVSynced(),
-                 m_window.preferredDevice(), initInfo.vulkan}
+                 m_window.preferredDevice(), vulkanInitInfo(initInfo)}
 #if RE_BUILDING_FOR_DEBUG
     , m_pipelineHotLoader{m_renderer.deletionQueue(), initInfo.hotReload}
 #endif // RE_BUILDING_FOR_DEBUG
-    , m_roomToEngineAccess{*this,    m_inputManager, m_synchronizer,
-                           m_window, m_renderer,     m_roomManager} {
+    , m_roomToEngineAccess{*this,       m_inputManager, m_synchronizer,
+                           m_window,    m_renderer,     m_roomManager,
+                           m_jobSystem} {
+
+    JobSystem::setShared(&m_jobSystem);
+    Profiler::setThreadName("Main");
+
+    if (initInfo.inputRecordPath) {
+        m_inputRecorder.emplace(initInfo.inputRecordPath);
+    }
+    if (initInfo.benchmark) {
+        const auto& benchmark = *initInfo.benchmark;
+        m_benchmark.emplace(
+            InputLogReader{benchmark.inputLogPath}, std::max(benchmark.stepsPerFrame, 1u),
+            benchmark.statisticsCSVPath ? benchmark.statisticsCSVPath : ""
+        );
+    }
+    if (initInfo.headless) {
+        m_headless = *initInfo.headless;
+        if (m_headless->captureInterval > 0) {
+            std::filesystem::create_directories(m_headless->captureDir);
+        }
+    }
 
     Room::setRoomToEngineAccess(&m_roomToEngineAccess);
     Room::setStaticReferences(this, &m_roomManager);
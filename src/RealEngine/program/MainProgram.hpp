@@ -4,10 +4,15 @@
  */
 #pragma once
 #include <concepts>
+#include <optional>
 
 #include <SDL_main.h>
 #include <glm/vec2.hpp>
 
+#include <RealEngine/jobs/JobSystem.hpp>
+#include <RealEngine/program/BenchmarkInitInfo.hpp>
+#include <RealEngine/program/HeadlessInitInfo.hpp>
+#include <RealEngine/program/StepThread.hpp>
 #include <RealEngine/program/Synchronizer.hpp>
 #include <RealEngine/renderer/VulkanRenderer.hpp>
 #include <RealEngine/resources/hot_reload/HotReloadInitInfo.hpp>
@@ -15,12 +20,12 @@
 #include <RealEngine/rooms/RoomManager.hpp>
 #include <RealEngine/rooms/RoomToEngineAccess.hpp>
 #include <RealEngine/rooms/RoomTransitionArguments.hpp>
+#include <RealEngine/user_input/InputEventSource.hpp>
+#include <RealEngine/user_input/InputLog.hpp>
 #include <RealEngine/user_input/InputManager.hpp>
 #include <RealEngine/utility/Error.hpp>
 #include <RealEngine/window/Window.hpp>
 
-union SDL_Event;
-
 namespace re {
 
 class Room;
@@ -39,10 +44,29 @@ struct MainProgramInitInfo {
 
     VulkanInitInfo vulkan{};
 
+    JobSystemCreateInfo jobs{};
+
     /**
      * @brief Hot reload will be disabled even in non-release builds if not provided
      */
     const HotReloadInitInfo* hotReload{};
+
+    /**
+     * @brief The program runs without a display if provided
+     * @details VulkanInitInfo::headlessExtent is replaced by its extent.
+     */
+    const HeadlessInitInfo* headless{};
+
+    /**
+     * @brief Input of all steps is recorded into this file if provided
+     * @see InputLogWriter
+     */
+    const char* inputRecordPath{};
+
+    /**
+     * @brief The program replays recorded input as a benchmark if provided
+     */
+    const BenchmarkInitInfo* benchmark{};
 };
 
 /**
@@ -120,7 +144,10 @@ public:
      * no room with such name.
      * @param args Arguments to start the next room's session with.
      *
-     * The transition, which happens at the end of current frame,
+     * The next room is preloaded via Room::preload() by a worker thread
+     * while the current room keeps running. The transition, which happens
+     * at the end of the frame in which the preload has completed (usually
+     * the current frame if the room does not override preload()),
      * does the following:
      * - ends session of current room via sessionEnd()
      * - start session of next room via sessionStart(params)
@@ -137,6 +164,11 @@ public:
 
     void setRelativeCursorMode(bool relative);
 
+    /**
+     * @brief Adopts the settings of the current room
+     * @details Settings changed from a pipelined step are adopted after the step
+     * is joined.
+     */
     void adoptRoomDisplaySettings(const RoomDisplaySettings& rds);
 
 private:
@@ -156,13 +188,28 @@ private:
     int doRun(size_t roomName, const RoomTransitionArguments& args);
 
     void step();
+    void beginStep();
+    void simulateStep();
     void render(const CommandBuffer& cb, double interpolationFactor);
 
+    /**
+     * @brief Samples input of the step (records or replays it)
+     * @details Received events up to the time of the step belong to the step,
+     * the last step of the frame takes all of them.
+     * @return False if the replayed input has ended
+     */
+    bool sampleInput(int stepIndex, int stepCount);
+    void applyInputEvent(InputEvent event);
     void pollEvents();
-    void processEvent(SDL_Event* evnt);
 
     void performHotReload();
 
+    void joinPipelinedStep();
+
+    void finishHeadlessFrame();
+    void finishBenchmark();
+
+    JobSystem m_jobSystem; ///< First, so that it is destroyed last
     Window m_window;
     VulkanRenderer m_renderer;
 #if RE_BUILDING_FOR_DEBUG
@@ -170,20 +217,45 @@ private:
 #endif // RE_BUILDING_FOR_DEBUG
     RoomManager m_roomManager;
     InputManager m_inputManager;
+    InputEventSource m_inputEventSource;
+    std::vector<InputEvent> m_receivedEvents; ///< Of the sampled step
     Synchronizer m_synchronizer{k_defaultStepsPerSecond, k_defaultFramesPerSecondLimit};
     RoomToEngineAccess m_roomToEngineAccess;
+    StepThread m_stepThread;
 
     bool m_programShouldRun = false;
     int m_programExitCode   = EXIT_SUCCESS;
     int m_stepN             = 0;
 
+    bool m_pipelinedStepping      = false;
+    unsigned int m_stepsPerSecond = k_defaultStepsPerSecond; ///< As known by the room
+    std::optional<RoomDisplaySettings> m_settingsFromPipelinedStep;
+
     bool m_pollEventsInMainThread = true;
 
-    void doRoomTransitionIfScheduled();
+    std::optional<HeadlessInitInfo> m_headless;
+    uint64_t m_headlessFrameN = 0;
+
+    std::optional<InputLogWriter> m_inputRecorder;
+    struct Benchmark {
+        InputLogReader replay;
+        uint32_t stepsPerFrame{};
+        std::string statisticsCSVPath;
+        std::chrono::steady_clock::time_point start{};
+    };
+    std::optional<Benchmark> m_benchmark;
+
+    /**
+     * @param waitForPreload Blocks until the next room is preloaded
+     */
+    void doRoomTransitionIfScheduled(bool waitForPreload = false);
+    void startPreloadOfNextRoom();
 
     static constexpr size_t k_noNextRoom = std::numeric_limits<size_t>::max();
     size_t m_nextRoomName                = k_noNextRoom;
     RoomTransitionArguments m_roomTransitionArgs;
+    size_t m_preloadedRoomName = k_noNextRoom; ///< Being preloaded or preloaded
+    JobCounter m_preloadCounter;
 };
 
 } // namespace re
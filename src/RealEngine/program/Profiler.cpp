@@ -0,0 +1,243 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <algorithm>
+#include <deque>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <tuple>
+#include <unordered_set>
+
+#include <ImGui/imgui.h>
+
+#include <RealEngine/program/Profiler.hpp>
+#include <RealEngine/utility/Error.hpp>
+
+namespace re {
+
+namespace {
+
+constexpr int k_cpuPid = 1; ///< Process of CPU tracks in the exported trace
+constexpr int k_gpuPid = 2; ///< Process of the GPU track in the exported trace
+
+struct TrackBuffer {
+    TrackBuffer(uint32_t index, std::string name)
+        : index(index)
+        , name(std::move(name)) {}
+
+    const uint32_t index;
+    std::string name; ///< Guarded by State::mutex
+    std::mutex mutex; ///< Guards zones
+    std::vector<Profiler::Zone> zones;
+};
+
+struct State {
+    std::mutex mutex; ///< Guards everything except zones of the tracks
+    std::deque<TrackBuffer> tracks;
+    TrackBuffer gpuTrack{Profiler::k_gpuTrack, "GPU"};
+    std::unordered_set<std::string> gpuNames; ///< Guarded by gpuTrack.mutex
+    std::deque<std::vector<Profiler::Zone>> frames;
+};
+
+State& state() {
+    // Never destroyed so that threads may record zones during static destruction
+    static State& s_state = *new State;
+    return s_state;
+}
+
+thread_local TrackBuffer* t_track = nullptr;
+
+TrackBuffer& threadTrack() {
+    if (!t_track) {
+        auto& s = state();
+        std::lock_guard lock{s.mutex};
+        auto index = static_cast<uint32_t>(s.tracks.size());
+        t_track    = &s.tracks.emplace_back(index, std::format("Thread {}", index));
+    }
+    return *t_track;
+}
+
+std::string escapeJSON(std::string_view str) {
+    std::string escaped;
+    escaped.reserve(str.size());
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped += std::format("\\u{:04x}", static_cast<int>(c));
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+double toMicroseconds(Profiler::Duration duration) {
+    return std::chrono::duration<double, std::micro>{duration}.count();
+}
+
+} // namespace
+
+void Profiler::setThreadName(std::string_view name) {
+    TrackBuffer& track = threadTrack();
+    std::lock_guard lock{state().mutex};
+    track.name = name;
+}
+
+void Profiler::recordZone(const char* name, TimePoint begin, TimePoint end) {
+    TrackBuffer& track = threadTrack();
+    std::lock_guard lock{track.mutex};
+    track.zones.emplace_back(name, begin, end - begin, track.index);
+}
+
+void Profiler::recordGPUZone(std::string_view name, TimePoint begin, TimePoint end) {
+    TrackBuffer& track = state().gpuTrack;
+    std::lock_guard lock{track.mutex};
+    const char* interned = state().gpuNames.emplace(name).first->c_str();
+    track.zones.emplace_back(interned, begin, end - begin, track.index);
+}
+
+void Profiler::endFrame() {
+    auto& s = state();
+    std::lock_guard lock{s.mutex};
+    std::vector<Zone> frame;
+    auto collect = [&](TrackBuffer& track) {
+        std::lock_guard trackLock{track.mutex};
+        frame.insert(frame.end(), track.zones.begin(), track.zones.end());
+        track.zones.clear();
+    };
+    for (auto& track : s.tracks) { collect(track); }
+    collect(s.gpuTrack);
+    if (frame.empty()) {
+        return;
+    }
+    s.frames.push_back(std::move(frame));
+    if (s.frames.size() > k_maxCapturedFrames) {
+        s.frames.pop_front();
+    }
+}
+
+std::vector<Profiler::Zone> Profiler::lastFrame() {
+    auto& s = state();
+    std::lock_guard lock{s.mutex};
+    return s.frames.empty() ? std::vector<Zone>{} : s.frames.back();
+}
+
+std::vector<Profiler::Track> Profiler::tracks() {
+    auto& s = state();
+    std::lock_guard lock{s.mutex};
+    std::vector<Track> tracks;
+    tracks.reserve(s.tracks.size() + 1);
+    for (const auto& track : s.tracks) { tracks.emplace_back(track.index, track.name); }
+    std::lock_guard gpuLock{s.gpuTrack.mutex};
+    if (!s.gpuNames.empty()) {
+        tracks.emplace_back(s.gpuTrack.index, s.gpuTrack.name);
+    }
+    return tracks;
+}
+
+void Profiler::clear() {
+    auto& s = state();
+    std::lock_guard lock{s.mutex};
+    s.frames.clear();
+}
+
+void Profiler::writeChromeTrace(const std::filesystem::path& path) {
+    auto tracks = Profiler::tracks();
+    auto& s     = state();
+    std::lock_guard lock{s.mutex};
+    std::ofstream file{path, std::ios::trunc};
+
+    // Timestamps are relative to the earliest zone
+    TimePoint origin = TimePoint::max();
+    for (const auto& frame : s.frames) {
+        for (const auto& zone : frame) { origin = std::min(origin, zone.begin); }
+    }
+
+    // CPU threads are in the first process, GPU in the second
+    auto pidTid = [](uint32_t track) {
+        return track == k_gpuTrack ? std::pair{k_gpuPid, 0u}
+                                   : std::pair{k_cpuPid, track};
+    };
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto writeEvent = [&](const std::string& event) {
+        file << (first ? "" : ",\n") << event;
+        first = false;
+    };
+    writeEvent(std::format(
+        R"({{"name":"process_name","ph":"M","pid":{},"args":{{"name":"CPU"}}}})",
+        k_cpuPid
+    ));
+    writeEvent(std::format(
+        R"({{"name":"process_name","ph":"M","pid":{},"args":{{"name":"GPU"}}}})",
+        k_gpuPid
+    ));
+    for (const auto& track : tracks) {
+        auto [pid, tid] = pidTid(track.index);
+        writeEvent(std::format(
+            R"({{"name":"thread_name","ph":"M","pid":{},"tid":{},)"
+            R"("args":{{"name":"{}"}}}})",
+            pid, tid, escapeJSON(track.name)
+        ));
+    }
+    for (const auto& frame : s.frames) {
+        for (const auto& zone : frame) {
+            auto [pid, tid] = pidTid(zone.track);
+            writeEvent(std::format(
+                R"({{"name":"{}","ph":"X","pid":{},"tid":{},)"
+                R"("ts":{:.3f},"dur":{:.3f}}})",
+                escapeJSON(zone.name), pid, tid, toMicroseconds(zone.begin - origin),
+                toMicroseconds(zone.duration)
+            ));
+        }
+    }
+    file << "\n]}\n";
+    if (!file) {
+        throw Exception{std::format("Could not write {}", path.string())};
+    }
+}
+
+void Profiler::drawImGuiOverlay(bool* open /* = nullptr*/) {
+    if (!ImGui::Begin("Profiler", open)) {
+        ImGui::End();
+        return;
+    }
+    bool enabled = Profiler::enabled();
+    if (ImGui::Checkbox("Enabled", &enabled)) {
+        setEnabled(enabled);
+    }
+
+    auto zones = lastFrame();
+    std::ranges::sort(zones, [](const Zone& a, const Zone& b) {
+        return std::tie(a.track, a.begin) < std::tie(b.track, b.begin);
+    });
+    auto zone = zones.begin();
+    for (const auto& track : tracks()) {
+        auto trackEnd = std::find_if(zone, zones.end(), [&](const Zone& z) {
+            return z.track != track.index;
+        });
+        if (zone != trackEnd &&
+            ImGui::TreeNodeEx(track.name.c_str(), ImGuiTreeNodeFlags_DefaultOpen)) {
+            // Zones are nested inside the zones that have not ended yet
+            std::vector<TimePoint> openEnds;
+            for (auto it = zone; it != trackEnd; ++it) {
+                while (!openEnds.empty() && it->begin >= openEnds.back()) {
+                    openEnds.pop_back();
+                }
+                ImGui::Text(
+                    "%*s%s: %.3f ms", static_cast<int>(openEnds.size()) * 2, "",
+                    it->name, toMicroseconds(it->duration) / 1000.0
+                );
+                openEnds.push_back(it->begin + it->duration);
+            }
+            ImGui::TreePop();
+        }
+        zone = trackEnd;
+    }
+    ImGui::End();
+}
+
+} // namespace re
@@ -0,0 +1,154 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace re {
+
+/**
+ * @brief   Records named zones of CPU and GPU work and exports them
+ * @details CPU zones are recorded by ProfilerZone (or recordZone()) on any
+ *          thread. GPU zones are measured by timestamp queries around debug
+ *          regions of the frame's command buffer (see CommandBuffer::DebugRegion),
+ *          in release builds too. The GPU results are read back when the
+ *          frame's resources are reused, so they arrive k_maxFramesInFlight
+ *          frames late but never stall the CPU.
+ * @details Zones are kept for the last k_maxCapturedFrames frames and can be
+ *          exported in the Chrome trace event format (which Perfetto and
+ *          chrome://tracing open) or shown in an ImGui window.
+ * @note    Nothing is recorded until the profiler is enabled.
+ */
+class Profiler {
+public:
+    using Clock     = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+    using Duration  = Clock::duration;
+
+    /**
+     * @brief Maximum number of frames whose zones are kept
+     */
+    static constexpr size_t k_maxCapturedFrames = 600;
+
+    /**
+     * @brief Track of GPU zones, CPU threads have tracks numbered from 0
+     */
+    static constexpr uint32_t k_gpuTrack = ~0u;
+
+    struct Zone {
+        const char* name{}; ///< Has static storage duration
+        TimePoint begin{};
+        Duration duration{};
+        uint32_t track{};
+    };
+
+    struct Track {
+        uint32_t index{};
+        std::string name;
+    };
+
+    static void setEnabled(bool enabled) {
+        s_enabled.store(enabled, std::memory_order_relaxed);
+    }
+    static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Names the track of the calling thread
+     * @details Threads that do not name their track are named by its index.
+     */
+    static void setThreadName(std::string_view name);
+
+    /**
+     * @brief Records a zone that has already been measured by the caller
+     * @param name Must have static storage duration (e.g. a string literal)
+     */
+    static void recordZone(const char* name, TimePoint begin, TimePoint end);
+
+    /**
+     * @brief   Records a zone of GPU work, its times have been converted to
+     *          CPU's clock by the caller
+     * @details The conversion may be approximate (see GPUProfiler).
+     * @param name Any string, the profiler keeps its copy
+     */
+    static void recordGPUZone(std::string_view name, TimePoint begin, TimePoint end);
+
+    /**
+     * @brief Moves zones recorded since the last call into a new captured frame
+     * @details This is called by the main loop at the end of each frame.
+     */
+    static void endFrame();
+
+    /**
+     * @brief Gets zones of the last captured frame
+     * @details The GPU zones in it belong to an earlier frame.
+     */
+    static std::vector<Zone> lastFrame();
+
+    /**
+     * @brief Gets tracks of threads that have recorded a zone or have been named
+     */
+    static std::vector<Track> tracks();
+
+    /**
+     * @brief Forgets all captured frames
+     */
+    static void clear();
+
+    /**
+     * @brief   Writes all captured frames in the Chrome trace event JSON format
+     * @throws  Throws if the file cannot be written
+     */
+    static void writeChromeTrace(const std::filesystem::path& path);
+
+    /**
+     * @brief   Draws a window with zones of the last captured frame
+     * @details Nested zones are indented under the zones that contain them.
+     * @note    Must be called between ImGui::NewFrame and ImGui::Render,
+     *          i.e. from Room::render when the room uses ImGui.
+     */
+    static void drawImGuiOverlay(bool* open = nullptr);
+
+private:
+    static inline std::atomic<bool> s_enabled = false;
+};
+
+/**
+ * @brief Is a RAII zone of CPU work that is recorded by the Profiler
+ * @note  Costs a single relaxed load when the profiler is disabled.
+ */
+class [[nodiscard]] ProfilerZone {
+public:
+    /**
+     * @param name Must have static storage duration (e.g. a string literal)
+     */
+    explicit ProfilerZone(const char* name)
+        : m_name(Profiler::enabled() ? name : nullptr) {
+        if (m_name) {
+            m_begin = Profiler::Clock::now();
+        }
+    }
+
+    ProfilerZone(const ProfilerZone&)            = delete; ///< Noncopyable
+    ProfilerZone& operator=(const ProfilerZone&) = delete; ///< Noncopyable
+
+    ProfilerZone(ProfilerZone&&)            = delete;      ///< Nonmovable
+    ProfilerZone& operator=(ProfilerZone&&) = delete;      ///< Nonmovable
+
+    ~ProfilerZone() {
+        if (m_name) {
+            Profiler::recordZone(m_name, m_begin, Profiler::Clock::now());
+        }
+    }
+
+private:
+    const char* m_name;
+    Profiler::TimePoint m_begin{};
+};
+
+} // namespace re
@@ -0,0 +1,51 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <cassert>
+#include <utility>
+
+#include <RealEngine/program/Profiler.hpp>
+#include <RealEngine/program/StepThread.hpp>
+
+namespace re {
+
+StepThread::StepThread()
+    : m_thread([this](std::stop_token stopToken) { run(stopToken); }) {
+}
+
+void StepThread::launch(std::function<void()> step) {
+    {
+        std::lock_guard lock{m_mutex};
+        assert(!m_launched && "The previous step has not been joined");
+        m_step     = std::move(step);
+        m_launched = true;
+    }
+    m_cv.notify_all();
+}
+
+void StepThread::join() {
+    std::unique_lock lock{m_mutex};
+    m_cv.wait(lock, [&] { return !m_launched; });
+    if (m_exception) {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+}
+
+void StepThread::run(std::stop_token stopToken) {
+    Profiler::setThreadName("Step");
+    std::unique_lock lock{m_mutex};
+    while (m_cv.wait(lock, stopToken, [&] { return m_step != nullptr; })) {
+        auto step = std::exchange(m_step, nullptr);
+        lock.unlock();
+        std::exception_ptr exception;
+        try {
+            step();
+        } catch (...) { exception = std::current_exception(); }
+        lock.lock();
+        m_exception = exception;
+        m_launched  = false;
+        m_cv.notify_all();
+    }
+}
+
+} // namespace re
@@ -0,0 +1,62 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace re {
+
+/**
+ * @brief   Runs simulation steps on a dedicated thread
+ * @details The thread is created once and sleeps while there is no step.
+ *          At most one step is in progress at any time.
+ * @note    This is used internally by MainProgram in pipelined stepping mode.
+ */
+class StepThread {
+public:
+    StepThread();
+
+    StepThread(const StepThread&)            = delete; ///< Noncopyable
+    StepThread& operator=(const StepThread&) = delete; ///< Noncopyable
+
+    StepThread(StepThread&&)            = delete;      ///< Nonmovable
+    StepThread& operator=(StepThread&&) = delete;      ///< Nonmovable
+
+    ~StepThread() = default; ///< Stops the thread, the step must have been joined
+
+    /**
+     * @brief   Starts the step on the thread and returns immediately
+     * @warning The previous step must have been joined.
+     */
+    void launch(std::function<void()> step);
+
+    /**
+     * @brief   Blocks until the launched step finishes, returns immediately
+     *          if there is no step in progress
+     * @throws  Rethrows the exception thrown by the step, if any
+     */
+    void join();
+
+    /**
+     * @brief Checks whether this is called from within a step on the thread
+     */
+    bool isCallerStepThread() const {
+        return std::this_thread::get_id() == m_thread.get_id();
+    }
+
+private:
+    void run(std::stop_token stopToken);
+
+    std::mutex m_mutex;
+    std::condition_variable_any m_cv;
+    std::function<void()> m_step;
+    bool m_launched = false; ///< Set by launch(), cleared when the step finishes
+    std::exception_ptr m_exception;
+    std::jthread m_thread; ///< Last, so that it is started last and stopped first
+};
+
+} // namespace re
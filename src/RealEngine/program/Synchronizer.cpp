@@ -1,7 +1,9 @@
 ﻿/**
  *  @author    Dubsky Tomas
  */
+#include <algorithm>
 #include <cassert>
+#include <numeric>
 #include <thread>
 
 #include <RealEngine/program/Synchronizer.hpp>
@@ -10,6 +12,15 @@ using namespace std::chrono_literals;
 
 namespace re {
 
+namespace {
+
+constexpr Synchronizer::Duration k_sleepSlice = 1ms;
+
+/// Number of recent steps whose durations estimate the duration of the next step
+constexpr size_t k_stepEstimateSampleCount = 16;
+
+} // namespace
+
 Synchronizer::Synchronizer(
     unsigned int stepsPerSecond, unsigned int framesPerSecondLimit,
     bool beginResumed /* = false*/
@@ -24,7 +35,15 @@ Synchronizer::Synchronizer(
 
 void Synchronizer::setStepsPerSecond(unsigned int stepsPerSecond) {
     assert(stepsPerSecond > 0);
-    m_timePerStep = 1'000'000'000ns / stepsPerSecond;
+    m_desiredStepsPerSecond = stepsPerSecond;
+    applyStepRate(stepsPerSecond);
+}
+
+void Synchronizer::setCatchUpPolicy(const CatchUpPolicy& policy) {
+    m_catchUpPolicy = policy;
+    if (!policy.adaptiveStepRate) {
+        applyStepRate(m_desiredStepsPerSecond);
+    }
 }
 
 void Synchronizer::setFramesPerSecondLimit(unsigned int framesPerSecondLimit) {
@@ -70,6 +89,17 @@ void Synchronizer::beginFrame() {
         m_framesPerSecondThisSecond = 0;
         m_maxFrameTime              = m_maxFrameTimeThisSecond;
         m_maxFrameTimeThisSecond    = frameTime;
+        m_inputToSubmitLatency =
+            m_inputToSubmitLatencySum / std::max(m_inputToSubmitLatencyCount, 1u);
+        m_inputToSubmitLatencySum   = Duration::zero();
+        m_inputToSubmitLatencyCount = 0;
+        m_gpuWaitTime    = m_gpuWaitTimeSum / std::max(m_framesPerSecond, 1u);
+        m_gpuWaitTimeSum = Duration::zero();
+        m_overruns           = m_overrunsThisSecond;
+        m_overrunsThisSecond = Overruns{};
+        if (m_catchUpPolicy.adaptiveStepRate) {
+            adaptStepRate();
+        }
     }
 
     // Update statistics of this second
@@ -79,9 +109,27 @@ void Synchronizer::beginFrame() {
         m_maxFrameTimeThisSecond = frameTime;
     }
 
+    // Estimate duration of the next step if the policy needs it
+    if (m_catchUpPolicy.stepTimeBudget != Duration::zero() ||
+        m_catchUpPolicy.adaptiveStepRate) {
+        auto steps = m_frameStatistics.steps(k_stepEstimateSampleCount);
+        if (!steps.empty()) {
+            m_stepDurationEstimate =
+                std::reduce(steps.begin(), steps.end(), Duration::zero()) /
+                static_cast<Duration::rep>(steps.size());
+        }
+    }
+    m_stepsThisFrame = 0;
+    m_frameOverrun   = false;
+
     m_lastFrameTime = now;
 }
 
+Synchronizer::TimePoint Synchronizer::stepTime(int stepIndex, int stepCount) const {
+    return m_lastFrameTime - m_stepTimeAccumulator -
+           (stepCount - 1 - stepIndex) * m_timePerStep;
+}
+
 void Synchronizer::endFrame() {
     // If frames per second should be limited
     if (m_timePerFrame != Duration::zero()) {
@@ -97,12 +145,18 @@ bool Synchronizer::shouldStepHappen() {
 
     // If accumulated enough time for the next step to happen
     if (m_stepTimeAccumulator >= m_timePerStep) {
+        if (stepLimitReached()) {
+            // Give up catching up, the simulation slows down instead
+            dropAccumulatedSteps();
+            return false;
+        }
         m_stepTimeAccumulator -= m_timePerStep; // Reduce accumulated time
+        m_stepsThisFrame++;
 
         // If lacking behind extremely (may be because of stoppping on a breakpoint)
         if (m_stepTimeAccumulator >= 4s) {
             // Skip the steps to avoid waiting for the simulation to catch up
-            m_stepTimeAccumulator %= m_timePerStep;
+            dropAccumulatedSteps();
         }
         return true;
     } else {
@@ -110,12 +164,101 @@ bool Synchronizer::shouldStepHappen() {
     }
 }
 
-void Synchronizer::delayTillEndOfFrame() const {
+void Synchronizer::inputSampled() {
+    m_inputSampleTime = std::chrono::steady_clock::now();
+}
+
+void Synchronizer::frameSubmitted(TimePoint submitTime, Duration gpuWaitTime) {
+    if (m_inputSampleTime) {
+        m_inputToSubmitLatencySum += submitTime - *m_inputSampleTime;
+        m_inputToSubmitLatencyCount++;
+        m_inputSampleTime.reset();
+    }
+    m_gpuWaitTimeSum += gpuWaitTime;
+}
+
+void Synchronizer::delayTillEndOfFrame() {
     auto now              = std::chrono::steady_clock::now();
     auto expectedFrameEnd = m_startTime + m_currFrameIndex * m_timePerFrame;
     if (now < expectedFrameEnd) { // If there is time to sleep
-        std::this_thread::sleep_until(expectedFrameEnd); // Sleep   zzZZZzz
+        if (m_framePacing == FramePacing::Precise) {
+            preciseSleepUntil(expectedFrameEnd);
+        } else {
+            std::this_thread::sleep_until(expectedFrameEnd); // Sleep   zzZZZzz
+        }
+    } else if (m_framePacing == FramePacing::Precise &&
+               now - expectedFrameEnd > m_timePerFrame) {
+        // Missed the schedule by more than a frame (e.g. because of waiting for
+        // the GPU), do not rush the following frames, it would cause jitter
+        m_startTime = now - m_currFrameIndex * m_timePerFrame;
+    }
+}
+
+void Synchronizer::preciseSleepUntil(TimePoint deadline) {
+    // Sleep while the rest surely takes longer than a slice (with its overshoot)
+    auto now = std::chrono::steady_clock::now();
+    while (deadline - now > m_sliceMean + 2 * m_sliceDeviation) {
+        std::this_thread::sleep_for(k_sleepSlice);
+        auto sliceEnd = std::chrono::steady_clock::now();
+        // Update the moving averages of the slice duration
+        auto slice   = sliceEnd - now;
+        auto diff    = slice - m_sliceMean;
+        m_sliceMean += diff / 16;
+        m_sliceDeviation += (std::chrono::abs(diff) - m_sliceDeviation) / 16;
+        now = sliceEnd;
+    }
+    // Spin for the rest
+    while (std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+bool Synchronizer::stepLimitReached() const {
+    if (m_stepsThisFrame == 0) {
+        return false; // At least one step per frame is always allowed
+    }
+    const auto& policy = m_catchUpPolicy;
+    if (policy.maxStepsPerFrame != 0 && m_stepsThisFrame >= policy.maxStepsPerFrame) {
+        return true;
     }
+    return policy.stepTimeBudget != Duration::zero() &&
+           (m_stepsThisFrame + 1) * m_stepDurationEstimate > policy.stepTimeBudget;
+}
+
+void Synchronizer::dropAccumulatedSteps() {
+    auto dropped = static_cast<unsigned int>(m_stepTimeAccumulator / m_timePerStep);
+    m_stepTimeAccumulator %= m_timePerStep;
+    m_overrunsThisSecond.droppedSteps += dropped;
+    m_totalDroppedSteps += dropped;
+    if (!m_frameOverrun) {
+        m_frameOverrun = true;
+        m_overrunsThisSecond.overrunFrames++;
+    }
+}
+
+void Synchronizer::adaptStepRate() {
+    unsigned int minRate = std::clamp(
+        m_catchUpPolicy.minStepsPerSecond, 1u, m_desiredStepsPerSecond
+    );
+    if (m_overruns.overrunFrames * 4 >= std::max(m_framesPerSecond, 1u)) {
+        // Steps have been dropped in many frames (not just in a single spike)
+        applyStepRate(std::max(m_stepsPerSecond * 9 / 10, minRate));
+    } else if (m_overruns.overrunFrames == 0 &&
+               m_stepsPerSecond < m_desiredStepsPerSecond) {
+        // Raise the rate if the steps would still take less than half of the time
+        unsigned int raised = std::min(
+            m_stepsPerSecond + std::max(m_stepsPerSecond / 10, 1u),
+            m_desiredStepsPerSecond
+        );
+        if (m_stepDurationEstimate * raised < 500ms) {
+            applyStepRate(raised);
+        }
+    }
+}
+
+void Synchronizer::applyStepRate(unsigned int stepsPerSecond) {
+    m_stepsPerSecond = stepsPerSecond;
+    m_timePerStep    = 1'000'000'000ns / stepsPerSecond;
 }
 
 void Synchronizer::resetSynchronization() {
@@ -3,6 +3,10 @@
  */
 #pragma once
 #include <chrono>
+#include <cstdint>
+#include <optional>
+
+#include <RealEngine/program/FrameStatistics.hpp>
 
 namespace re {
 
@@ -20,6 +24,64 @@ public:
 
     constexpr static unsigned int k_doNotLimitFramesPerSecond = 0u;
 
+    /**
+     * @brief Specifies how frames are paced when frames per second are limited
+     */
+    enum class FramePacing {
+        /**
+         * @brief Sleeps until the next frame should begin, the sleep
+         * may overshoot by the scheduler's quantum
+         */
+        Sleep,
+        /**
+         * @brief Sleeps until shortly before the next frame should begin and
+         * spins for the rest. The GPU is waited for before the input is
+         * sampled and the schedule is not rushed after missed frames.
+         */
+        Precise
+    };
+
+    /**
+     * @brief Specifies how steps catch up with the time after slow frames
+     *
+     * Without limits, a slow frame is followed by many steps which make the
+     * next frame even slower. The time of steps that exceed the limits is
+     * dropped instead - the simulation slows down but it does not stall.
+     */
+    struct CatchUpPolicy {
+        /**
+         * @brief Maximum number of steps per frame, zero does not limit
+         */
+        unsigned int maxStepsPerFrame = 0;
+        /**
+         * @brief Limits steps of a frame to those that are expected to fit into
+         * this time, zero does not limit
+         *
+         * Durations of steps are estimated from the recent steps. At least one
+         * step per frame is always allowed.
+         */
+        Duration stepTimeBudget{Duration::zero()};
+        /**
+         * @brief Lowers the step rate while steps are being dropped and restores
+         * it gradually once they fit again
+         *
+         * The current room is notified by Room::stepRateChangedCallback().
+         */
+        bool adaptiveStepRate = false;
+        /**
+         * @brief The adaptive step rate is never lowered below this
+         */
+        unsigned int minStepsPerSecond = 1;
+    };
+
+    /**
+     * @brief Describes steps that have been dropped
+     */
+    struct Overruns {
+        unsigned int droppedSteps  = 0; ///< Steps whose time has been dropped
+        unsigned int overrunFrames = 0; ///< Frames that have dropped steps
+    };
+
     /**
      * @brief Constructs new synchronizer.
      *
@@ -41,9 +103,33 @@ public:
      *
      * @param stepsPerSecond Desired number of steps to happen per second. Zero
      * is not a valid value - use pauseSteps() to stop steps.
+     *
+     * This also cancels any adaptation of the step rate.
      */
     void setStepsPerSecond(unsigned int stepsPerSecond);
 
+    /**
+     * @brief Gets the number of steps per second that are currently happening
+     *
+     * This differs from the desired number only if it has been lowered by
+     * the adaptive step rate of the catch-up policy.
+     */
+    unsigned int stepsPerSecond() const { return m_stepsPerSecond; }
+
+    /**
+     * @brief Gets the number of steps per second that has been set as desired
+     */
+    unsigned int desiredStepsPerSecond() const { return m_desiredStepsPerSecond; }
+
+    /**
+     * @brief Sets how steps catch up with the time after slow frames
+     *
+     * The default policy does not limit the steps.
+     */
+    void setCatchUpPolicy(const CatchUpPolicy& policy);
+
+    const CatchUpPolicy& catchUpPolicy() const { return m_catchUpPolicy; }
+
     /**
      * @brief Sets new limit for frames to be drawn per second.
      *
@@ -52,6 +138,13 @@ public:
      */
     void setFramesPerSecondLimit(unsigned int framesPerSecondLimit);
 
+    /**
+     * @brief Sets how frames are paced, the default is FramePacing::Sleep
+     */
+    void setFramePacing(FramePacing framePacing) { m_framePacing = framePacing; }
+
+    FramePacing framePacing() const { return m_framePacing; }
+
     /**
      * @brief Temporarily pauses steps.
      *
@@ -96,6 +189,39 @@ public:
      */
     Duration maxFrameTime() const;
 
+    /**
+     * @brief Gets average time from sampling of input to submission of the
+     * frame in the last second
+     *
+     * Only frames that have sampled input are counted.
+     */
+    Duration inputToSubmitLatency() const { return m_inputToSubmitLatency; }
+
+    /**
+     * @brief Gets average time spent waiting for the GPU to release
+     * resources of the frame in the last second
+     */
+    Duration gpuWaitTime() const { return m_gpuWaitTime; }
+
+    /**
+     * @brief Gets steps that have been dropped in the last second
+     */
+    Overruns overruns() const { return m_overruns; }
+
+    /**
+     * @brief Gets the number of steps that have been dropped since the beginning
+     */
+    uint64_t totalDroppedSteps() const { return m_totalDroppedSteps; }
+
+    /**
+     * @brief Gets durations of recent frames and steps
+     *
+     * Unlike the other metrics, these are not limited to the last second
+     * and can be used to find stutter patterns.
+     */
+    const FrameStatistics& frameStatistics() const { return m_frameStatistics; }
+    FrameStatistics& frameStatistics() { return m_frameStatistics; }
+
     /** @brief This function has to be called at the beginning of each frame */
     void beginFrame();
 
@@ -108,17 +234,55 @@ public:
      *
      * Result depends on the time that passed since the last step.
      * If it should, it assumes it will happen immediately, and it updates
-     * internal counters.
+     * internal counters. If the step would exceed the catch-up policy,
+     * the accumulated time is dropped and false is returned.
      */
     bool shouldStepHappen();
 
+    /**
+     * @brief Gets the time that the step simulates
+     * @param stepIndex Index of the step among the steps of the current frame
+     * @param stepCount Number of steps of the current frame (the number of
+     * times shouldStepHappen() has returned true)
+     *
+     * Steps of a frame are performed at once but they represent evenly spaced
+     * times. The last step represents the beginning of the frame minus the
+     * time that has been accumulated for the next step.
+     */
+    TimePoint stepTime(int stepIndex, int stepCount) const;
+
+    /** @brief Informs that the input has been sampled for the current frame */
+    void inputSampled();
+
+    /**
+     * @brief Informs that the current frame has been submitted
+     * @param submitTime    The time point of the submission
+     * @param gpuWaitTime   The time waited for the GPU before the frame was
+     * recorded
+     */
+    void frameSubmitted(TimePoint submitTime, Duration gpuWaitTime);
+
 private:
 
     /** @brief Sleeps this thread until next frame should begin. */
-    void delayTillEndOfFrame() const;
+    void delayTillEndOfFrame();
+
+    /** @brief Sleeps in short slices then spins until the deadline. */
+    void preciseSleepUntil(TimePoint deadline);
 
     void resetSynchronization();
 
+    /** @brief Tests whether another step would exceed the catch-up policy */
+    bool stepLimitReached() const;
+
+    /** @brief Drops the time accumulated for whole steps */
+    void dropAccumulatedSteps();
+
+    /** @brief Lowers or restores the step rate based on the last second */
+    void adaptStepRate();
+
+    void applyStepRate(unsigned int stepsPerSecond);
+
     /// Number of frames drawn since last resume, used when limiting frames per second
     unsigned int m_currFrameIndex = 0;
     /// Time point of the last resume - the center synchronization point
@@ -134,6 +298,17 @@ private:
     /// Accumulator of time for next step
     Duration m_stepTimeAccumulator{Duration::zero()};
 
+    unsigned int m_stepsPerSecond        = 0; ///< Current, possibly adapted
+    unsigned int m_desiredStepsPerSecond = 0; ///< As set by setStepsPerSecond()
+
+    CatchUpPolicy m_catchUpPolicy{};
+    unsigned int m_stepsThisFrame = 0;
+    bool m_frameOverrun           = false; ///< The current frame has dropped steps
+    Duration m_stepDurationEstimate{Duration::zero()}; ///< Mean of recent steps
+    Overruns m_overruns{};                             ///< Last second
+    Overruns m_overrunsThisSecond{};                   ///< This second
+    uint64_t m_totalDroppedSteps = 0;
+
     unsigned int m_framesPerSecond           = 0; ///< Count drawn last second
     unsigned int m_framesPerSecondThisSecond = 0; ///< Count drawn this second
 
@@ -141,6 +316,20 @@ private:
     Duration m_maxFrameTimeThisSecond{Duration::zero()}; ///< Max this second
 
     bool m_stepsPaused = false; ///< True if steps are paused
+
+    FramePacing m_framePacing = FramePacing::Sleep;
+    /// Expected duration of a sleep slice and its deviation (moving averages)
+    Duration m_sliceMean{std::chrono::milliseconds{2}};
+    Duration m_sliceDeviation{Duration::zero()};
+
+    std::optional<TimePoint> m_inputSampleTime; ///< Of the current frame
+    Duration m_inputToSubmitLatency{Duration::zero()};     ///< Average last second
+    Duration m_inputToSubmitLatencySum{Duration::zero()};  ///< Sum this second
+    unsigned int m_inputToSubmitLatencyCount = 0;          ///< Count this second
+    Duration m_gpuWaitTime{Duration::zero()};              ///< Average last second
+    Duration m_gpuWaitTimeSum{Duration::zero()};           ///< Sum this second
+
+    FrameStatistics m_frameStatistics;
 };
 
 } // namespace re
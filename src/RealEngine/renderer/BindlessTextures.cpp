@@ -0,0 +1,108 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <algorithm>
+#include <format>
+
+#include <RealEngine/graphics/synchronization/MultiBuffered.hpp>
+#include <RealEngine/renderer/BindlessTextures.hpp>
+#include <RealEngine/utility/Error.hpp>
+
+using enum vk::DescriptorBindingFlagBits;
+
+namespace re {
+
+BindlessTextures::BindlessTextures()
+    : m_capacity(deviceCapacity()) {
+    vk::DescriptorPoolSize poolSize{
+        vk::DescriptorType::eCombinedImageSampler, m_capacity
+    };
+    m_pool = device().createDescriptorPool(vk::DescriptorPoolCreateInfo{
+        vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind, 1u, poolSize
+    });
+
+    vk::DescriptorSetLayoutBinding binding{
+        0u, vk::DescriptorType::eCombinedImageSampler, m_capacity,
+        vk::ShaderStageFlagBits::eAll
+    };
+    vk::DescriptorBindingFlags bindingFlags =
+        ePartiallyBound | eUpdateAfterBind | eUpdateUnusedWhilePending;
+    m_layout = device().createDescriptorSetLayout(vk::StructureChain{
+        vk::DescriptorSetLayoutCreateInfo{
+            vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool, binding
+        },
+        vk::DescriptorSetLayoutBindingFlagsCreateInfo{bindingFlags}
+    }.get<>());
+
+    m_set = device().allocateDescriptorSets(vk::DescriptorSetAllocateInfo{
+        m_pool, m_layout
+    })[0];
+
+    setDebugUtilsObjectName(m_pool, "re::BindlessTextures::pool");
+    setDebugUtilsObjectName(m_layout, "re::BindlessTextures::layout");
+    setDebugUtilsObjectName(m_set, "re::BindlessTextures::set");
+}
+
+BindlessTextures::~BindlessTextures() {
+    // The set is freed with the pool
+    deletionQueue().enqueueDeletion(m_pool);
+    deletionQueue().enqueueDeletion(m_layout);
+}
+
+uint32_t BindlessTextures::add(
+    const vk::ImageView& imageView, const vk::Sampler& sampler, vk::ImageLayout layout
+) {
+    std::lock_guard lock{m_mutex};
+    uint32_t slot{};
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else if (m_nextSlot < m_capacity) {
+        slot = m_nextSlot++;
+    } else {
+        throw Exception{std::format(
+            "All {} slots of bindless textures are taken (released slots are "
+            "reused after {} frames)",
+            m_capacity, k_maxFramesInFlight
+        )};
+    }
+    vk::DescriptorImageInfo imageInfo{sampler, imageView, layout};
+    device().updateDescriptorSets(
+        vk::WriteDescriptorSet{
+            m_set, 0u, slot, vk::DescriptorType::eCombinedImageSampler, imageInfo
+        },
+        {}
+    );
+    return slot;
+}
+
+void BindlessTextures::remove(uint32_t slot) {
+    std::lock_guard lock{m_mutex};
+    m_releasedSlots.emplace_back(m_frame, slot);
+}
+
+void BindlessTextures::beginFrame() {
+    std::lock_guard lock{m_mutex};
+    ++m_frame;
+    // Frames recorded before the slot was released have been rendered
+    while (!m_releasedSlots.empty() &&
+           m_releasedSlots.front().frame + k_maxFramesInFlight <= m_frame) {
+        m_freeSlots.push_back(m_releasedSlots.front().slot);
+        m_releasedSlots.pop_front();
+    }
+}
+
+uint32_t BindlessTextures::deviceCapacity() {
+    auto props = physicalDevice().getProperties2<
+        vk::PhysicalDeviceProperties2, vk::PhysicalDeviceVulkan12Properties>();
+    const auto& vk12 = props.get<vk::PhysicalDeviceVulkan12Properties>();
+    return std::min(
+        {k_maxCapacity, vk12.maxPerStageDescriptorUpdateAfterBindSamplers,
+         vk12.maxPerStageDescriptorUpdateAfterBindSampledImages,
+         vk12.maxPerStageUpdateAfterBindResources,
+         vk12.maxDescriptorSetUpdateAfterBindSamplers,
+         vk12.maxDescriptorSetUpdateAfterBindSampledImages}
+    );
+}
+
+} // namespace re
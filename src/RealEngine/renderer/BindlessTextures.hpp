@@ -0,0 +1,98 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include <RealEngine/renderer/ObjectUsingVulkan.hpp>
+
+namespace re {
+
+/**
+ * @brief   Is the global table of textures that shaders index by slots
+ * @details Each Texture with a sampler gets a persistent slot in the table
+ *          when it is constructed and the slot's descriptor is written then.
+ *          Pipelines whose layout uses descriptorSetLayout() can bind
+ *          descriptorSet() once and sample any texture by its slot, so no
+ *          descriptors have to be written or looked up per frame.
+ * @details The descriptors are update-after-bind and partially bound. Slots
+ *          of destroyed textures are reused once the frames that could have
+ *          used them have been rendered.
+ * @details The table is thread-safe.
+ * @note    This is used internally by VulkanRenderer and Texture.
+ */
+class BindlessTextures: public ObjectUsingVulkan {
+public:
+    /**
+     * @brief Maximum number of slots, fewer are created if the device's limits
+     *        are lower
+     */
+    static constexpr uint32_t k_maxCapacity = 16384;
+
+    /**
+     * @brief Is the slot of textures that are not in the table
+     */
+    static constexpr uint32_t k_noSlot = ~0u;
+
+    BindlessTextures();
+
+    BindlessTextures(const BindlessTextures&)            = delete; ///< Noncopyable
+    BindlessTextures& operator=(const BindlessTextures&) = delete; ///< Noncopyable
+
+    BindlessTextures(BindlessTextures&&)            = delete;      ///< Nonmovable
+    BindlessTextures& operator=(BindlessTextures&&) = delete;      ///< Nonmovable
+
+    ~BindlessTextures();
+
+    /**
+     * @brief   Assigns the texture a slot and writes its descriptor
+     * @throws  Throws if all slots are taken
+     */
+    uint32_t add(
+        const vk::ImageView& imageView, const vk::Sampler& sampler,
+        vk::ImageLayout layout
+    );
+
+    /**
+     * @brief Releases the slot, it is reused k_maxFramesInFlight frames later
+     */
+    void remove(uint32_t slot);
+
+    /**
+     * @brief   Makes slots that cannot be used by frames in flight free for reuse
+     * @details Must be called once the frame's fence has been waited for.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Gets number of slots in the table
+     */
+    uint32_t capacity() const { return m_capacity; }
+
+    const vk::DescriptorSetLayout& descriptorSetLayout() const { return m_layout; }
+    const vk::DescriptorSet& descriptorSet() const { return m_set; }
+
+private:
+    struct ReleasedSlot {
+        uint64_t frame; ///< That the slot was released in
+        uint32_t slot;
+    };
+
+    static uint32_t deviceCapacity();
+
+    uint32_t m_capacity;
+    vk::DescriptorPool m_pool{};
+    vk::DescriptorSetLayout m_layout{};
+    vk::DescriptorSet m_set{};
+
+    std::mutex m_mutex; ///< Guards everything below and writes to the set
+    uint64_t m_frame    = 0;
+    uint32_t m_nextSlot = 0; ///< Slots from this on have never been used
+    std::vector<uint32_t> m_freeSlots;
+    std::deque<ReleasedSlot> m_releasedSlots; ///< In order of release
+};
+
+} // namespace re
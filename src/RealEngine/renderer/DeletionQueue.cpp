@@ -1,7 +1,7 @@
 /**
  *  @author    Dubsky Tomas
  */
-#include <RealEngine/graphics/synchronization/DoubleBuffered.hpp>
+#include <RealEngine/graphics/synchronization/MultiBuffered.hpp>
 #include <RealEngine/renderer/DeletionQueue.hpp>
 #include <RealEngine/utility/Error.hpp>
 
@@ -28,8 +28,9 @@ DeletionQueue::~DeletionQueue() {
 }
 
 void DeletionQueue::startNextIteration(Timeline timeline) {
-    m_currentTimeline = timeline;
-    auto& queue       = m_queues[std::to_underlying(timeline)];
+    s_currentTimeline = timeline;
+    std::lock_guard lock{m_mutex};
+    auto& queue = m_queues[std::to_underlying(timeline)];
     queue.emplace(QueueRecord::separator());
     deleteIteration(queue);
 }
@@ -95,6 +96,12 @@ void DeletionQueue::deleteVulkanHandle(vk::ObjectType type, void* handle) {
     case vk::ObjectType::eFramebuffer:
         m_device.destroy(reinterpret_cast<VkFramebuffer>(handle));
         break;
+    case vk::ObjectType::eCommandPool:
+        m_device.destroy(reinterpret_cast<VkCommandPool>(handle));
+        break;
+    case vk::ObjectType::eDescriptorPool:
+        m_device.destroy(reinterpret_cast<VkDescriptorPool>(handle));
+        break;
     default: error("Unsupported object queued for deletion");
     }
 }
@@ -2,6 +2,7 @@
  *  @author    Dubsky Tomas
  */
 #pragma once
+#include <mutex>
 #include <queue>
 #include <type_traits>
 #include <utility>
@@ -15,6 +16,9 @@ namespace re {
  * @brief   Allows delayed deletion of Vulkan and VMA objects
  * @details There are two queues: one for objects that are used in simulation
  *          steps and one for objects that are used frame rendering.
+ * @details The queue is thread-safe. Each thread enqueues to the timeline
+ *          whose iteration it has started last (steps may run on a separate
+ *          thread, see RoomDisplaySettings::pipelinedStepping).
  */
 class DeletionQueue {
 public:
@@ -34,10 +38,11 @@ public:
     };
 
     /**
-     * @brief   Deletes all objects from the iteration before previous and
-     *          starts new iteration of the timeline.
-     * @details Subsequent deletions will be enqueued to the provided timeline,
-     *          until this function is called again.
+     * @brief   Deletes all objects from the iteration that started
+     *          k_maxFramesInFlight iterations ago and starts new iteration
+     *          of the timeline.
+     * @details Subsequent deletions from the calling thread will be enqueued
+     *          to the provided timeline, until this function is called again.
      */
     void startNextIteration(Timeline timeline);
 
@@ -48,7 +53,8 @@ public:
         requires vk::isVulkanHandleType<T>::value
     void enqueueDeletion(const T& object) {
         if (object) {
-            m_queues[std::to_underlying(m_currentTimeline)].emplace(
+            std::lock_guard lock{m_mutex};
+            m_queues[std::to_underlying(s_currentTimeline)].emplace(
                 QueueRecord::Category::VulkanHandle, T::objectType,
                 static_cast<T::NativeType>(object)
             );
@@ -60,7 +66,8 @@ public:
      */
     void enqueueDeletion(const vma::Allocation& allocation) {
         if (allocation) {
-            m_queues[std::to_underlying(m_currentTimeline)].emplace(
+            std::lock_guard lock{m_mutex};
+            m_queues[std::to_underlying(s_currentTimeline)].emplace(
                 QueueRecord::Category::VmaAllocation, vk::ObjectType::eUnknown,
                 static_cast<VmaAllocation>(allocation)
             );
@@ -97,7 +104,8 @@ private:
 
     void deleteVulkanHandle(vk::ObjectType type, void* handle);
 
-    Timeline m_currentTimeline{};
+    static inline thread_local Timeline s_currentTimeline{};
+    std::mutex m_mutex;
     std::array<std::queue<QueueRecord>, 2> m_queues{};
     const vk::Device& m_device;
     const vma::Allocator& m_allocator;
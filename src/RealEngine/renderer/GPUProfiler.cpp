@@ -0,0 +1,149 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <algorithm>
+
+#include <RealEngine/program/Profiler.hpp>
+#include <RealEngine/renderer/GPUProfiler.hpp>
+
+using enum vk::PipelineStageFlagBits2;
+
+namespace re {
+
+GPUProfiler::GPUProfiler(uint32_t queueFamilyIndex, bool calibratedTimestamps)
+    : m_timestamps(k_queryCount) {
+    auto families = physicalDevice().getQueueFamilyProperties();
+    uint32_t validBits = families[queueFamilyIndex].timestampValidBits;
+    m_supported        = validBits > 0;
+    m_validMask  = validBits >= 64 ? ~uint64_t{0} : (uint64_t{1} << validBits) - 1;
+    m_tickPeriod = physicalDevice().getProperties().limits.timestampPeriod;
+    if (!m_supported) {
+        return;
+    }
+    if (calibratedTimestamps) {
+        auto domains = physicalDevice().getCalibrateableTimeDomainsEXT(
+            dispatchLoaderDynamic()
+        );
+        m_calibrated = std::ranges::find(domains, vk::TimeDomainEXT::eDevice) !=
+                       domains.end();
+    }
+    m_frames.forEach([](Frame& frame) {
+        frame.pool = device().createQueryPool(vk::QueryPoolCreateInfo{
+            {}, vk::QueryType::eTimestamp, k_queryCount
+        });
+        setDebugUtilsObjectName(frame.pool, "re::GPUProfiler::pool");
+    });
+}
+
+GPUProfiler::~GPUProfiler() {
+    m_frames.forEach([](Frame& frame) { deletionQueue().enqueueDeletion(frame.pool); });
+}
+
+void GPUProfiler::beginFrame(const vk::CommandBuffer& cb) {
+    auto& frame = *m_frames;
+    if (frame.measured) {
+        readResults(frame);
+    }
+    frame.zones.clear();
+    frame.openZones.clear();
+    frame.queryCount = 2;
+    frame.measured   = m_supported && Profiler::enabled();
+    m_cb             = frame.measured ? cb : nullptr;
+    if (frame.measured) {
+        cb.resetQueryPool(frame.pool, 0, k_queryCount);
+        cb.writeTimestamp2(eTopOfPipe, frame.pool, k_frameBeginQuery);
+    }
+}
+
+void GPUProfiler::endFrame() {
+    if (!m_cb) {
+        return;
+    }
+    // Close regions that have not been ended so that all queries are written
+    while (!m_frames->openZones.empty()) { endZone(m_cb); }
+    m_cb.writeTimestamp2(eBottomOfPipe, m_frames->pool, k_frameEndQuery);
+    m_cb = nullptr;
+}
+
+void GPUProfiler::frameSubmitted(std::chrono::steady_clock::time_point submitTime) {
+    m_frames->submitTime = submitTime;
+}
+
+void GPUProfiler::beginZone(const vk::CommandBuffer& cb, const char* label) {
+    if (!m_cb || cb != m_cb) {
+        return;
+    }
+    auto& frame = *m_frames;
+    if (frame.queryCount + 2 > k_queryCount) {
+        frame.openZones.push_back(k_droppedZone);
+        return;
+    }
+    frame.openZones.push_back(static_cast<uint32_t>(frame.zones.size()));
+    frame.zones.emplace_back(label, frame.queryCount);
+    cb.writeTimestamp2(eTopOfPipe, frame.pool, frame.queryCount);
+    frame.queryCount += 2;
+}
+
+void GPUProfiler::endZone(const vk::CommandBuffer& cb) {
+    auto& frame = *m_frames;
+    if (!m_cb || cb != m_cb || frame.openZones.empty()) {
+        return;
+    }
+    uint32_t zoneIndex = frame.openZones.back();
+    frame.openZones.pop_back();
+    if (zoneIndex != k_droppedZone) {
+        cb.writeTimestamp2(
+            eBottomOfPipe, frame.pool, frame.zones[zoneIndex].beginQuery + 1
+        );
+    }
+}
+
+void GPUProfiler::readResults(const Frame& frame) {
+    // The frame's fence has been waited for so the results are available
+    auto res = device().getQueryPoolResults(
+        frame.pool, 0, frame.queryCount, frame.queryCount * sizeof(uint64_t),
+        m_timestamps.data(), sizeof(uint64_t), vk::QueryResultFlagBits::e64
+    );
+    if (res != vk::Result::eSuccess) {
+        return;
+    }
+    Calibration calibration = calibrate(frame);
+    auto toCPUTime          = [&](uint64_t timestamp) {
+        // The timestamp may precede the calibration
+        uint64_t after  = (timestamp - calibration.gpu) & m_validMask;
+        uint64_t before = (calibration.gpu - timestamp) & m_validMask;
+        double ticks    = after <= before ? static_cast<double>(after)
+                                          : -static_cast<double>(before);
+        return calibration.cpu +
+               std::chrono::duration_cast<Profiler::Duration>(
+                   std::chrono::duration<double, std::nano>{ticks * m_tickPeriod}
+               );
+    };
+    Profiler::recordGPUZone(
+        "Frame", toCPUTime(m_timestamps[k_frameBeginQuery]),
+        toCPUTime(m_timestamps[k_frameEndQuery])
+    );
+    for (const auto& zone : frame.zones) {
+        Profiler::recordGPUZone(
+            zone.label, toCPUTime(m_timestamps[zone.beginQuery]),
+            toCPUTime(m_timestamps[zone.beginQuery + 1])
+        );
+    }
+}
+
+GPUProfiler::Calibration GPUProfiler::calibrate(const Frame& frame) const {
+    if (m_calibrated) {
+        // The CPU time is taken in the middle of the sampling of the GPU clock
+        auto before          = std::chrono::steady_clock::now();
+        auto [gpu, maxError] = device().getCalibratedTimestampEXT(
+            vk::CalibratedTimestampInfoEXT{vk::TimeDomainEXT::eDevice},
+            dispatchLoaderDynamic()
+        );
+        auto after = std::chrono::steady_clock::now();
+        return Calibration{.gpu = gpu, .cpu = before + (after - before) / 2};
+    }
+    // Approximate, GPU-bound frames start later than they are submitted
+    return Calibration{.gpu = m_timestamps[k_frameBeginQuery], .cpu = frame.submitTime};
+}
+
+} // namespace re
@@ -0,0 +1,122 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <RealEngine/graphics/synchronization/MultiBuffered.hpp>
+#include <RealEngine/renderer/ObjectUsingVulkan.hpp>
+
+namespace re {
+
+/**
+ * @brief   Measures debug regions of the frame's command buffer by timestamp queries
+ * @details Each frame in flight has its own query pool. Its results are read
+ *          when the frame's resources are reused (after its fence has been
+ *          waited for) so reading them never stalls. The results are passed
+ *          to the Profiler.
+ * @details GPU times are converted to CPU's clock by sampling both clocks at
+ *          once via VK_EXT_calibrated_timestamps when the device supports it.
+ *          Otherwise, the beginning of the frame's command buffer is aligned
+ *          with the time of its submission. The GPU track is then approximate:
+ *          GPU-bound frames start later than they are submitted, so their
+ *          zones appear earlier than they really happen.
+ * @note    This is used internally by VulkanRenderer and CommandBuffer.
+ */
+class GPUProfiler: public ObjectUsingVulkan {
+public:
+    /**
+     * @brief Regions beyond this count are not measured
+     */
+    static constexpr uint32_t k_maxZonesPerFrame = 256;
+
+    /**
+     * @param calibratedTimestamps Whether VK_EXT_calibrated_timestamps is enabled
+     */
+    GPUProfiler(uint32_t queueFamilyIndex, bool calibratedTimestamps);
+
+    GPUProfiler(const GPUProfiler&)            = delete; ///< Noncopyable
+    GPUProfiler& operator=(const GPUProfiler&) = delete; ///< Noncopyable
+
+    GPUProfiler(GPUProfiler&&)            = delete;      ///< Nonmovable
+    GPUProfiler& operator=(GPUProfiler&&) = delete;      ///< Nonmovable
+
+    ~GPUProfiler();
+
+    /**
+     * @brief   Reads results of the previous use of the frame's queries and
+     *          starts measuring the frame if the Profiler is enabled
+     * @details Must be called once the frame's fence has been waited for and
+     *          its command buffer has begun.
+     */
+    void beginFrame(const vk::CommandBuffer& cb);
+
+    /**
+     * @brief Must be called before the frame's command buffer ends
+     */
+    void endFrame();
+
+    /**
+     * @brief Must be called after the frame's command buffer has been submitted
+     */
+    void frameSubmitted(std::chrono::steady_clock::time_point submitTime);
+
+    /**
+     * @brief Begins a zone if the command buffer is the one of the measured frame
+     */
+    void beginZone(const vk::CommandBuffer& cb, const char* label);
+
+    /**
+     * @brief Ends the zone begun last if the command buffer is the one of
+     *        the measured frame
+     */
+    void endZone(const vk::CommandBuffer& cb);
+
+private:
+    static constexpr uint32_t k_frameBeginQuery = 0;
+    static constexpr uint32_t k_frameEndQuery   = 1;
+    static constexpr uint32_t k_queryCount      = 2 + 2 * k_maxZonesPerFrame;
+    static constexpr uint32_t k_droppedZone     = ~0u;
+
+    struct Zone {
+        std::string label;
+        uint32_t beginQuery{}; ///< The end query follows it
+    };
+
+    struct Frame {
+        vk::QueryPool pool{};
+        std::vector<Zone> zones;
+        std::vector<uint32_t> openZones; ///< Indices to zones
+        uint32_t queryCount = 0;
+        bool measured       = false;
+        std::chrono::steady_clock::time_point submitTime{};
+    };
+
+    /**
+     * @brief Is a pair of times that were sampled at once
+     */
+    struct Calibration {
+        uint64_t gpu{}; ///< Timestamp of the device
+        std::chrono::steady_clock::time_point cpu{};
+    };
+
+    void readResults(const Frame& frame);
+
+    /**
+     * @brief Samples both clocks, the frame's first timestamp is aligned with
+     *        its submission if the clocks cannot be sampled at once
+     */
+    Calibration calibrate(const Frame& frame) const;
+
+    bool m_supported     = false;
+    bool m_calibrated    = false; ///< The clocks can be sampled at once
+    uint64_t m_validMask = 0;   ///< Of the valid bits of timestamps
+    double m_tickPeriod  = 0.0; ///< In nanoseconds
+    vk::CommandBuffer m_cb{};   ///< Of the measured frame, null if not measured
+    FrameMultiBuffered<Frame> m_frames;
+    std::vector<uint64_t> m_timestamps;
+};
+
+} // namespace re
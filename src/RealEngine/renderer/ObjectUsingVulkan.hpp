@@ -13,7 +13,11 @@
 
 namespace re {
 
+class BindlessTextures;
 class CommandBuffer;
+class GPUProfiler;
+class UploadQueue;
+class VulkanRenderer;
 
 /**
  * @brief   Provides derived objects access to global Vulkan objects (such as device).
@@ -49,9 +53,16 @@ protected:
         return *s_dispatchLoaderDynamic;
     }
     static DeletionQueue& deletionQueue() { return *s_deletionQueue; }
+    static UploadQueue& uploadQueue() { return *s_uploadQueue; }
     static PipelineHotLoader& pipelineHotLoader() {
         return *s_pipelineHotLoader;
     }
+    static GPUProfiler& gpuProfiler() { return *s_gpuProfiler; }
+    static BindlessTextures& bindlessTextures() { return *s_bindlessTextures; }
+    /**
+     * @brief Returns the renderer or nullptr if it has already been destroyed
+     */
+    static VulkanRenderer* renderer() { return s_renderer; }
 
     /**
      * @brief Assign a debug name to a given object, does nothing in release build
@@ -83,7 +94,11 @@ private:
     static inline const vk::DescriptorPool* s_descriptorPool = nullptr;
     static inline const vk::DispatchLoaderDynamic* s_dispatchLoaderDynamic = nullptr;
     static inline DeletionQueue* s_deletionQueue         = nullptr;
+    static inline UploadQueue* s_uploadQueue             = nullptr;
     static inline PipelineHotLoader* s_pipelineHotLoader = nullptr;
+    static inline GPUProfiler* s_gpuProfiler             = nullptr;
+    static inline BindlessTextures* s_bindlessTextures   = nullptr;
+    static inline VulkanRenderer* s_renderer             = nullptr;
 };
 
 } // namespace re
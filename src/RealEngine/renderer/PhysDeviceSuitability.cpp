@@ -24,6 +24,9 @@ bool areExtensionsSupported(vk::PhysicalDevice physicalDevice) {
 }
 
 bool isSwapchainSupported(vk::PhysicalDevice physicalDevice, vk::SurfaceKHR surface) {
+    if (!surface) {
+        return true; // Headless, nothing is presented
+    }
     bool formatSupported = false;
     for (const auto& format : physicalDevice.getSurfaceFormatsKHR(surface)) {
         if (format == k_surfaceFormat) {
@@ -53,7 +56,11 @@ bool findQueueFamilyIndices(
             graphicsCompQueueFamIndex = i;
             graphicsCompQueueFound    = true;
         }
-        if (physicalDevice.getSurfaceSupportKHR(i, surface)) {
+        if (!surface && graphicsCompQueueFound) {
+            // Headless, presentation is not needed
+            presentationQueueFamIndex = graphicsCompQueueFamIndex;
+            presentQueueFound         = true;
+        } else if (surface && physicalDevice.getSurfaceSupportKHR(i, surface)) {
             presentationQueueFamIndex = i;
             presentQueueFound         = true;
         }
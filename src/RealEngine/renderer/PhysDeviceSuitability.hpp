@@ -15,6 +15,13 @@ namespace re {
  */
 constexpr std::array k_deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 
+/**
+ * @brief The extensions that are enabled if the physical device supports them
+ */
+constexpr std::array k_optionalDeviceExtensions = {
+    VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME
+};
+
 /**
  * @brief Tells which device was selected
  */
@@ -30,7 +37,7 @@ struct SelectedPhysDevice {
  * @brief Specifies what the selected device must support
  */
 struct PhysDeviceRequirements {
-    vk::SurfaceKHR surface;              ///< Must support k_surfaceFormat
+    vk::SurfaceKHR surface;              ///< Must support k_surfaceFormat, or null
     const void* deviceCreateInfoChain{}; ///< Must support all features in chain
     std::string_view preferredDevice;    ///< Takes precedence if it is suitable
 };
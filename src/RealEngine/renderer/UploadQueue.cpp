@@ -0,0 +1,167 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <cassert>
+#include <cstring>
+
+#include <RealEngine/renderer/UploadQueue.hpp>
+#include <RealEngine/utility/Math.hpp>
+
+using enum vma::AllocationCreateFlagBits;
+using enum vma::MemoryUsage;
+
+namespace re {
+
+namespace {
+
+BufferCreateInfo stageCreateInfo(vk::DeviceSize sizeInBytes, const char* debugName) {
+    return BufferCreateInfo{
+        .allocFlags  = eHostAccessSequentialWrite | eMapped,
+        .memoryUsage = eAutoPreferHost,
+        .sizeInBytes = sizeInBytes,
+        .usage       = vk::BufferUsageFlagBits::eTransferSrc,
+        .debugName   = debugName
+    };
+}
+
+} // namespace
+
+UploadQueue::UploadQueue(vk::DeviceSize arenaSize, uint32_t queueFamilyIndex)
+    : m_arenaSize(arenaSize)
+    , m_arena(stageCreateInfo(arenaSize, "re::UploadQueue::arena"))
+    , m_pool(device().createCommandPool(vk::CommandPoolCreateInfo{
+          vk::CommandPoolCreateFlagBits::eResetCommandBuffer, queueFamilyIndex
+      })) {
+    for (auto& batch : m_batches) {
+        batch.cb = CommandBuffer{{.pool = m_pool, .debugName = "re::UploadQueue::cb"}};
+    }
+    setDebugUtilsObjectName(*m_timeline, "re::UploadQueue::timeline");
+    setDebugUtilsObjectName(m_pool, "re::UploadQueue::pool");
+}
+
+UploadQueue::~UploadQueue() {
+    if (!m_submitted.empty()) {
+        m_timeline.wait(m_submitted.back().signalValue);
+    }
+    // The command buffers are freed before the pool is deleted
+    deletionQueue().enqueueDeletion(m_pool);
+}
+
+void UploadQueue::submit() {
+    std::lock_guard lock{m_mutex};
+    submitBatch();
+}
+
+void UploadQueue::submitBatch() {
+    if (!m_recording) {
+        return;
+    }
+    auto& batch = m_batches[m_recordingIndex];
+
+    // Make the transfers visible to everything that is submitted later
+    using enum vk::PipelineStageFlagBits2;
+    using Access = vk::AccessFlagBits2; // Both enums have eNone
+    vk::MemoryBarrier2 barrier{
+        eAllCommands, Access::eMemoryWrite, eAllCommands,
+        Access::eMemoryRead | Access::eMemoryWrite
+    };
+    batch.cb->pipelineBarrier2(vk::DependencyInfo{{}, barrier, {}, {}});
+    batch.cb->end();
+
+    // Submit the batch
+    batch.signalValue = m_recordingValue;
+    vk::CommandBufferSubmitInfo cbSubmitInfo{*batch.cb};
+    vk::SemaphoreSubmitInfo signalSubmitInfo{*m_timeline, m_recordingValue, eAllCommands};
+    graphicsCompQueue().submit2(vk::SubmitInfo2{{}, {}, cbSubmitInfo, signalSubmitInfo});
+    m_submitted.emplace_back(m_recordingValue, m_arenaHead);
+
+    // Move to the next batch
+    ++m_recordingValue;
+    m_recordingIndex = (m_recordingIndex + 1) % k_batchCount;
+    m_recording      = false;
+}
+
+bool UploadQueue::isComplete(Ticket ticket) const {
+    if (ticket == 0) {
+        return true;
+    }
+    {
+        std::lock_guard lock{m_mutex};
+        if (ticket >= m_recordingValue) {
+            return false;
+        }
+    }
+    return device().getSemaphoreCounterValue(*m_timeline) >= ticket;
+}
+
+void UploadQueue::wait(Ticket ticket) {
+    {
+        std::lock_guard lock{m_mutex};
+        if (ticket == m_recordingValue) {
+            submitBatch();
+        }
+    }
+    if (ticket != 0) {
+        m_timeline.wait(ticket);
+    }
+}
+
+std::pair<vk::Buffer, vk::DeviceSize> UploadQueue::stageData(
+    std::span<const std::byte> data
+) {
+    vk::DeviceSize size = data.size_bytes();
+    if (size > m_arenaSize / 2) {
+        // The data are too large for the arena, use a dedicated stage
+        recordingCommandBuffer(); // The stage has to belong to the recording batch
+        auto& stage = m_batches[m_recordingIndex].dedicatedStages.emplace_back(
+            stageCreateInfo(size, "re::UploadQueue::dedicatedStage")
+        );
+        std::memcpy(stage.mapped(), data.data(), size);
+        return {stage.buffer(), 0};
+    }
+
+    // Find place in the arena, data must not wrap around its end
+    vk::DeviceSize offset = roundToMultiple(m_arenaHead, k_stageAlignment);
+    if (offset % m_arenaSize + size > m_arenaSize) {
+        offset = roundToMultiple(offset, m_arenaSize);
+    }
+    while (offset + size - m_arenaTail > m_arenaSize) {
+        // The arena is full, wait for the oldest batch to finish
+        if (m_submitted.empty()) {
+            submitBatch(); // The arena is occupied by the recording batch only
+        }
+        assert(!m_submitted.empty());
+        reclaimFinishedBatches(true);
+    }
+    m_arenaHead = offset + size;
+
+    offset %= m_arenaSize;
+    std::memcpy(m_arena.mapped() + offset, data.data(), size);
+    return {m_arena.buffer(), offset};
+}
+
+const CommandBuffer& UploadQueue::recordingCommandBuffer() {
+    auto& batch = m_batches[m_recordingIndex];
+    if (!m_recording) {
+        // Previous use of the batch must have finished before it can be reused
+        m_timeline.wait(batch.signalValue);
+        reclaimFinishedBatches(false);
+        batch.dedicatedStages.clear();
+        batch.cb->begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+        m_recording = true;
+    }
+    return batch.cb;
+}
+
+void UploadQueue::reclaimFinishedBatches(bool waitForOldest) {
+    if (waitForOldest && !m_submitted.empty()) {
+        m_timeline.wait(m_submitted.front().signalValue);
+    }
+    uint64_t finished = device().getSemaphoreCounterValue(*m_timeline);
+    while (!m_submitted.empty() && m_submitted.front().signalValue <= finished) {
+        m_arenaTail = m_submitted.front().arenaEnd;
+        m_submitted.pop_front();
+    }
+}
+
+} // namespace re
@@ -0,0 +1,140 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <array>
+#include <concepts>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include <RealEngine/graphics/buffers/BufferMapped.hpp>
+#include <RealEngine/graphics/commands/CommandBuffer.hpp>
+#include <RealEngine/graphics/synchronization/Semaphore.hpp>
+#include <RealEngine/renderer/ObjectUsingVulkan.hpp>
+
+namespace re {
+
+/**
+ * @brief   Collects transfers of initial data to GPU objects and submits them in batches
+ * @details Data are staged in a persistently mapped ring-buffered arena.
+ *          Transfers are recorded into the current batch which is submitted
+ *          (without waiting) when the frame is submitted, or sooner if needed.
+ *          Completion of batches is tracked by a timeline semaphore.
+ * @details All transfers are visible to all commands submitted after the batch.
+ * @details The queue is thread-safe so buffers and textures can be constructed
+ *          on any thread. Batches are recorded into command buffers of its
+ *          own pool. Because batches may be submitted from any thread, all
+ *          submissions to the graphics-compute queue (and presentations)
+ *          must go through submitAfterUploads() which synchronizes the queue.
+ * @note    This is used internally by Buffer and Texture constructors.
+ */
+class UploadQueue: public ObjectUsingVulkan {
+public:
+    /**
+     * @brief Identifies the batch that a transfer was recorded into
+     * @details Zero stands for no transfer, it is always complete.
+     */
+    using Ticket = uint64_t;
+
+    UploadQueue(vk::DeviceSize arenaSize, uint32_t queueFamilyIndex);
+
+    UploadQueue(const UploadQueue&)            = delete; ///< Noncopyable
+    UploadQueue& operator=(const UploadQueue&) = delete; ///< Noncopyable
+
+    UploadQueue(UploadQueue&&)            = delete;      ///< Nonmovable
+    UploadQueue& operator=(UploadQueue&&) = delete;      ///< Nonmovable
+
+    ~UploadQueue();
+
+    /**
+     * @brief Stages data and records their transfer into the current batch
+     * @param data The data to stage
+     * @param recordCopy Records the copy from the staging buffer (at given
+     *                   offset) to the destination object
+     */
+    template<std::invocable<const CommandBuffer&, vk::Buffer, vk::DeviceSize> F>
+    Ticket upload(std::span<const std::byte> data, F recordCopy) {
+        std::lock_guard lock{m_mutex};
+        auto [stage, offset] = stageData(data);
+        recordCopy(recordingCommandBuffer(), stage, offset);
+        return m_recordingValue;
+    }
+
+    /**
+     * @brief Records commands (e.g. layout transitions) into the current batch
+     */
+    template<std::invocable<const CommandBuffer&> F>
+    Ticket record(F op) {
+        std::lock_guard lock{m_mutex};
+        op(recordingCommandBuffer());
+        return m_recordingValue;
+    }
+
+    /**
+     * @brief Submits the current batch, does nothing if it is empty
+     * @details This does not wait for the batch to finish.
+     */
+    void submit();
+
+    /**
+     * @brief   Submits the current batch and then lets submitOp use the
+     *          graphics-compute queue
+     * @details Work submitted by submitOp observes all transfers recorded
+     *          before. No other thread uses the queue during submitOp.
+     */
+    template<std::invocable<const vk::Queue&> F>
+    decltype(auto) submitAfterUploads(F submitOp) {
+        std::lock_guard lock{m_mutex};
+        submitBatch();
+        return submitOp(graphicsCompQueue());
+    }
+
+    /**
+     * @brief Checks whether the batch of the ticket has finished on the GPU
+     */
+    bool isComplete(Ticket ticket) const;
+
+    /**
+     * @brief Blocks until the batch of the ticket finishes on the GPU
+     * @details Submits the current batch if the ticket belongs to it.
+     */
+    void wait(Ticket ticket);
+
+private:
+    static constexpr size_t k_batchCount             = 4;
+    static constexpr vk::DeviceSize k_stageAlignment = 16;
+
+    struct Batch {
+        CommandBuffer cb;
+        Ticket signalValue = 0;
+        std::vector<BufferMapped<std::byte>> dedicatedStages; ///< For oversized data
+    };
+
+    struct SubmittedBatch {
+        Ticket signalValue;
+        vk::DeviceSize arenaEnd; ///< Arena head when the batch was submitted
+    };
+
+    // These expect the mutex to be locked
+    void submitBatch();
+    std::pair<vk::Buffer, vk::DeviceSize> stageData(std::span<const std::byte> data);
+    const CommandBuffer& recordingCommandBuffer();
+    void reclaimFinishedBatches(bool waitForOldest);
+
+    mutable std::mutex m_mutex; ///< Guards everything below and the queue
+    vk::DeviceSize m_arenaSize;
+    BufferMapped<std::byte> m_arena;
+    vk::DeviceSize m_arenaHead = 0; ///< Monotonic, wraps by the arena size
+    vk::DeviceSize m_arenaTail = 0; ///< Monotonic, wraps by the arena size
+    Semaphore m_timeline{0};
+    vk::CommandPool m_pool{};
+    std::array<Batch, k_batchCount> m_batches;
+    size_t m_recordingIndex = 0;
+    bool m_recording        = false;
+    Ticket m_recordingValue = 1;
+    std::deque<SubmittedBatch> m_submitted;
+};
+
+} // namespace re
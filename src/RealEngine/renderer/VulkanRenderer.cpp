@@ -1,7 +1,11 @@
 /**
  *  @author    Dubsky Tomas
  */
+#include <algorithm>
+#include <cstring>
+#include <format>
 #include <iostream>
+#include <utility>
 
 #include <ImGui/imgui_impl_sdl2.h>
 #include <ImGui/imgui_impl_vulkan.h>
@@ -10,9 +14,12 @@
 #define VMA_IMPLEMENTATION
 #include <vma/vk_mem_alloc.hpp>
 
+#include <RealEngine/jobs/JobSystem.hpp>
 #include <RealEngine/renderer/DebugMessageHandler.hpp>
 #include <RealEngine/renderer/PhysDeviceSuitability.hpp>
 #include <RealEngine/renderer/VulkanRenderer.hpp>
+#include <RealEngine/resources/PNGLoader.hpp>
+#include <RealEngine/utility/Error.hpp>
 #include <RealEngine/utility/Version.hpp>
 
 using enum vk::DebugUtilsMessageSeverityFlagBitsEXT;
@@ -49,6 +56,7 @@ const void* defaultDeviceCreateInfoChain() {
         vk::PhysicalDeviceVulkan12Features{}
             .setShaderSampledImageArrayNonUniformIndexing(true)
             .setDescriptorBindingUpdateUnusedWhilePending(true)
+            .setDescriptorBindingSampledImageUpdateAfterBind(true)
             .setDescriptorBindingPartiallyBound(true)
             .setTimelineSemaphore(true),
         vk::PhysicalDeviceVulkan13Features{}.setSynchronization2(true)
@@ -61,6 +69,7 @@ VulkanRenderer::VulkanRenderer(
     const VulkanInitInfo& vulkan
 )
     : m_sdlWindow(sdlWindow)
+    , m_headlessExtent(vulkan.headlessExtent)
     , m_instance(createInstance())
 #if RE_BUILDING_FOR_DEBUG
     , m_debugUtilsMessenger(createDebugUtilsMessenger())
@@ -83,21 +92,24 @@ VulkanRenderer::VulkanRenderer(
     , m_cbs([&]() {
         assignImplementationReferences(); // Deliberate side effect, ref to device
                                           // and pool is required to construct a cmd buf
-        return FrameDoubleBuffered<CommandBuffer>{
-            CommandBuffer{{.debugName = "re::VulkanRenderer::cbs[0]"}},
-            CommandBuffer{{.debugName = "re::VulkanRenderer::cbs[1]"}}
-        };
+        return FrameMultiBuffered<CommandBuffer>{[](int i) {
+            std::string name = std::format("re::VulkanRenderer::cbs[{}]", i);
+            return CommandBuffer{{.debugName = name.c_str()}};
+        }};
     }())
     , m_oneTimeSubmitCmdBuf({.debugName = "re::VulkanRenderer::oneTimeSubmit"})
     , m_pipelineCache(createPipelineCache())
     , m_descriptorPool(createDescriptorPool())
     , m_imageAvailableSems(createSemaphores())
     , m_renderingFinishedSems(createSemaphores())
-    , m_inFlightFences(createFences()) {
+    , m_inFlightFences(createFences())
+    , m_uploadQueue(vulkan.uploadArenaSize, m_graphicsCompQueueFamIndex)
+    , m_gpuProfiler(m_graphicsCompQueueFamIndex, m_calibratedTimestamps)
+    , m_offscreenImages(createOffscreenImages()) {
 
     // Implementations
     assignImplementationReferences();
-    FrameDoubleBufferingState::setTotalIndex(m_frame++);
+    FrameMultiBufferingState::setTotalIndex(m_frame++);
 
     ObjectUsingVulkan::setDebugUtilsObjectName(
         *m_graphicsCompQueue, "re::VulkanRenderer::graphicsCompQueue"
@@ -111,37 +123,45 @@ VulkanRenderer::VulkanRenderer(
 
 VulkanRenderer::~VulkanRenderer() {
     m_device.waitIdle();
-    ImGui_ImplVulkan_Shutdown();
+    if (m_imGuiRenderPass) {
+        ImGui_ImplVulkan_Shutdown();
+    }
     ImGui_ImplSDL2_Shutdown();
+    ObjectUsingVulkan::s_renderer = nullptr;
 }
 
 void VulkanRenderer::setMainRenderPass(const RenderPass& rp, uint32_t imGuiSubpassIndex) {
-    if (m_mainRenderPass) {
-        if (m_imGuiSubpassIndex != RoomDisplaySettings::k_notUsingImGui) {
-            ImGui_ImplVulkan_Shutdown();
-        }
-        m_swapChainFramebuffers.~vector();
-    }
-
     m_mainRenderPass    = &rp;
     m_imGuiSubpassIndex = imGuiSubpassIndex;
 
-    new (&m_swapChainFramebuffers) decltype(m_swapChainFramebuffers
-    ){createSwapchainFramebuffers()};
+    // Framebuffers of render passes used before are reused
+    auto [it, inserted] = m_framebuffers.try_emplace(*rp);
+    if (inserted) {
+        it->second = createSwapchainFramebuffers(*rp);
+    }
+    m_mainFramebuffers = &it->second;
 
-    if (m_imGuiSubpassIndex != RoomDisplaySettings::k_notUsingImGui) {
+    if (m_imGuiSubpassIndex != RoomDisplaySettings::k_notUsingImGui &&
+        (m_imGuiRenderPass != *rp || m_imGuiRenderPassSubpass != imGuiSubpassIndex)) {
+        if (m_imGuiRenderPass) {
+            // The previous pipeline may still be used by frames in flight
+            m_device.waitIdle();
+            ImGui_ImplVulkan_Shutdown();
+        }
+        m_imGuiRenderPass        = *rp;
+        m_imGuiRenderPassSubpass = imGuiSubpassIndex;
         // Initialize ImGui for the new renderpass
         ImGui_ImplVulkan_InitInfo imGuiInitInfo{
-            .Instance       = *m_instance,
-            .PhysicalDevice = *m_physicalDevice,
-            .Device         = *m_device,
-            .QueueFamily    = m_graphicsCompQueueFamIndex,
-            .Queue          = *m_graphicsCompQueue,
-            .DescriptorPool = *m_descriptorPool,
-            .RenderPass     = **m_mainRenderPass,
-            .MinImageCount  = m_minImageCount,
-            .ImageCount  = static_cast<uint32_t>(m_swapchainImageViews.size()),
-            .MSAASamples = VK_SAMPLE_COUNT_1_BIT,
+            .Instance            = *m_instance,
+            .PhysicalDevice      = *m_physicalDevice,
+            .Device              = *m_device,
+            .QueueFamily         = m_graphicsCompQueueFamIndex,
+            .Queue               = *m_graphicsCompQueue,
+            .DescriptorPool      = *m_descriptorPool,
+            .RenderPass          = **m_mainRenderPass,
+            .MinImageCount       = m_minImageCount,
+            .ImageCount          = static_cast<uint32_t>(imageCount()),
+            .MSAASamples         = VK_SAMPLE_COUNT_1_BIT,
             .PipelineCache       = *m_pipelineCache,
             .Subpass             = imGuiSubpassIndex,
             .UseDynamicRendering = false,
@@ -154,11 +174,47 @@ void VulkanRenderer::setMainRenderPass(const RenderPass& rp, uint32_t imGuiSubpa
     }
 }
 
+void VulkanRenderer::renderPassDestroyed(vk::RenderPass rp) {
+    if (auto it = m_framebuffers.find(rp); it != m_framebuffers.end()) {
+        // The framebuffers may still be used by frames in flight
+        for (auto& framebuffer : it->second) {
+            m_deletionQueue.enqueueDeletion(vk::Framebuffer{framebuffer.release()});
+        }
+        if (m_mainFramebuffers == &it->second) {
+            m_mainRenderPass   = nullptr;
+            m_mainFramebuffers = nullptr;
+        }
+        m_framebuffers.erase(it);
+    }
+    if (m_imGuiRenderPass == rp) {
+        // A new render pass could get the same handle
+        m_device.waitIdle();
+        ImGui_ImplVulkan_Shutdown();
+        m_imGuiRenderPass = nullptr;
+    }
+}
+
+void VulkanRenderer::waitForFrameResources() {
+    if (m_frameResourcesReady) {
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    checkSuccess(m_device.waitForFences(**m_inFlightFences, true, k_maxTimeout));
+    m_frameResourcesWaitTime = std::chrono::steady_clock::now() - start;
+    m_frameResourcesReady    = true;
+}
+
 const CommandBuffer& VulkanRenderer::prepareFrame() {
     // Wait for the previous frame to finish
-    checkSuccess(m_device.waitForFences(**m_inFlightFences, true, k_maxTimeout));
+    waitForFrameResources();
+
+    // The frame that used the resources before has been rendered
+    if (!m_captures->pathPNG.empty()) {
+        saveCapture(*m_captures);
+    }
 
     m_deletionQueue.startNextIteration(DeletionQueue::Timeline::Render);
+    m_bindlessTextures.beginFrame();
 
     // Recreate swapchain if required
     if (m_recreteSwapchain) {
@@ -169,17 +225,23 @@ const CommandBuffer& VulkanRenderer::prepareFrame() {
     m_device.resetFences(**m_inFlightFences);
 
     // Acquire next image
-    vk::AcquireNextImageInfoKHR acquireNextImageInfo{
-        *m_swapchain, k_maxTimeout, **m_imageAvailableSems, nullptr, 1u
-    };
-    auto [res, imageIndex] = m_device.acquireNextImage2KHR(acquireNextImageInfo);
-    checkSuccess(res);
-    m_imageIndex = imageIndex;
+    if (isHeadless()) {
+        // The offscreen images are rotated like the swapchain's
+        m_imageIndex = (m_imageIndex + 1) % static_cast<uint32_t>(imageCount());
+    } else {
+        vk::AcquireNextImageInfoKHR acquireNextImageInfo{
+            *m_swapchain, k_maxTimeout, **m_imageAvailableSems, nullptr, 1u
+        };
+        auto [res, imageIndex] = m_device.acquireNextImage2KHR(acquireNextImageInfo);
+        checkSuccess(res);
+        m_imageIndex = imageIndex;
+    }
 
     // Restart command buffer
     auto& cb = *m_cbs;
     cb->reset();
     cb->begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+    m_gpuProfiler.beginFrame(*cb);
 
     // Begin ImGui frame
     if (m_imGuiSubpassIndex != RoomDisplaySettings::k_notUsingImGui) {
@@ -201,7 +263,7 @@ void VulkanRenderer::mainRenderPassBegin(std::span<const vk::ClearValue> clearVa
     auto& cb = m_cbs.write();
     cb->beginRenderPass2(
         vk::RenderPassBeginInfo{
-            **m_mainRenderPass, *m_swapChainFramebuffers[m_imageIndex],
+            **m_mainRenderPass, *(*m_mainFramebuffers)[m_imageIndex],
             vk::Rect2D{{}, m_swapchainExtent}, clearValues
         },
         vk::SubpassBeginInfo{vk::SubpassContents::eInline}
@@ -246,40 +308,76 @@ void VulkanRenderer::mainRenderPassEnd() {
 
 void VulkanRenderer::finishFrame() {
     auto& cb = m_cbs.write();
+    if (!m_captures->pathPNG.empty()) {
+        recordCapture(cb, *m_captures);
+    }
+    m_gpuProfiler.endFrame();
     cb->end();
 
-    // Submit the command buffer
-    vk::PipelineStageFlags waitDstStageMask =
-        vk::PipelineStageFlagBits::eColorAttachmentOutput;
-    vk::SubmitInfo submitInfo{
-        **m_imageAvailableSems,   // Wait for image to be available
-        waitDstStageMask,         // Wait just before writing output
-        *cb,
-        **m_renderingFinishedSems // Signal that the rendering has
-                                  // finished once done
-    };
-    m_graphicsCompQueue.submit(submitInfo, **m_inFlightFences);
+    // Submit the command buffer, uploads recorded during the frame precede it
+    if (isHeadless()) {
+        // There is no image to wait for and nothing to present
+        m_uploadQueue.submitAfterUploads([&](const vk::Queue& queue) {
+            queue.submit(vk::SubmitInfo{{}, {}, *cb}, **m_inFlightFences);
+        });
+    } else {
+        vk::PipelineStageFlags waitDstStageMask =
+            vk::PipelineStageFlagBits::eColorAttachmentOutput;
+        vk::SubmitInfo submitInfo{
+            **m_imageAvailableSems,   // Wait for image to be available
+            waitDstStageMask,         // Wait just before writing output
+            *cb,
+            **m_renderingFinishedSems // Signal that the rendering has
+                                      // finished once done
+        };
+        m_uploadQueue.submitAfterUploads([&](const vk::Queue& queue) {
+            queue.submit(submitInfo, **m_inFlightFences);
+        });
+    }
+    m_lastSubmitTime = std::chrono::steady_clock::now();
+    m_gpuProfiler.frameSubmitted(m_lastSubmitTime);
 
     // Present new image
-    vk::PresentInfoKHR presentInfo{
-        **m_renderingFinishedSems, // Wait for rendering to finish
-        *m_swapchain, m_imageIndex
-    };
+    if (!isHeadless()) {
+        vk::PresentInfoKHR presentInfo{
+            **m_renderingFinishedSems, // Wait for rendering to finish
+            *m_swapchain, m_imageIndex
+        };
+
+        try {
+            // The presentation queue may be the graphics-compute queue
+            checkSuccess(m_uploadQueue.submitAfterUploads([&](const vk::Queue&) {
+                return m_presentationQueue.presentKHR(presentInfo);
+            }));
+        } catch (vk::OutOfDateKHRError&) { recreateSwapchain(); }
+    }
 
-    try {
-        checkSuccess(m_presentationQueue.presentKHR(presentInfo));
-    } catch (vk::OutOfDateKHRError&) { recreateSwapchain(); }
+    FrameMultiBufferingState::setTotalIndex(m_frame++);
+    m_frameResourcesReady = false;
+}
 
-    FrameDoubleBufferingState::setTotalIndex(m_frame++);
+void VulkanRenderer::captureFrame(std::string pathPNG) {
+    if (!isHeadless() && !m_swapchainReadable) {
+        throw std::runtime_error{"Swapchain images cannot be captured on this device"};
+    }
+    m_captures->pathPNG = std::move(pathPNG);
 }
 
 void VulkanRenderer::changePresentation(bool vSync) {
+    if (isHeadless()) {
+        return; // Nothing is presented
+    }
     m_presentMode      = selectClosestPresentMode(vSync);
     m_recreteSwapchain = true;
 }
 
 void VulkanRenderer::prepareForDestructionOfRendererObjects() {
     m_device.waitIdle();
+    m_captures.forEach([&](FrameCapture& capture) {
+        if (!capture.pathPNG.empty()) {
+            saveCapture(capture);
+        }
+    });
 }
 
 std::vector<std::string> VulkanRenderer::availableDevices() const {
@@ -310,21 +408,25 @@ vk::raii::Instance VulkanRenderer::createInstance() {
 #endif // RE_BUILDING_FOR_DEBUG
     };
 
-    // Add extensions required by SDL2
-    unsigned int sdl2ExtensionCount{};
-    if (!SDL_Vulkan_GetInstanceExtensions(m_sdlWindow, &sdl2ExtensionCount, nullptr)) {
-        throw std::runtime_error(
-            "Could not get number of Vulkan extensions required for SDL2!"
-        );
-    }
-    size_t defaultExtensionsCount = extensions.size();
-    extensions.resize(defaultExtensionsCount + sdl2ExtensionCount);
-    if (!SDL_Vulkan_GetInstanceExtensions(
-            m_sdlWindow, &sdl2ExtensionCount, &extensions[defaultExtensionsCount]
-        )) {
-        throw std::runtime_error(
-            "Could not get Vulkan extensions required for SDL2!"
-        );
+    // Add extensions required by SDL2 (to create the surface)
+    if (!isHeadless()) {
+        unsigned int sdl2ExtensionCount{};
+        if (!SDL_Vulkan_GetInstanceExtensions(
+                m_sdlWindow, &sdl2ExtensionCount, nullptr
+            )) {
+            throw std::runtime_error(
+                "Could not get number of Vulkan extensions required for SDL2!"
+            );
+        }
+        size_t defaultExtensionsCount = extensions.size();
+        extensions.resize(defaultExtensionsCount + sdl2ExtensionCount);
+        if (!SDL_Vulkan_GetInstanceExtensions(
+                m_sdlWindow, &sdl2ExtensionCount, &extensions[defaultExtensionsCount]
+            )) {
+            throw std::runtime_error(
+                "Could not get Vulkan extensions required for SDL2!"
+            );
+        }
     }
 
     // Create Vulkan instance
@@ -356,6 +458,9 @@ vk::raii::DebugUtilsMessengerEXT VulkanRenderer::createDebugUtilsMessenger() {
 }
 
 vk::raii::SurfaceKHR VulkanRenderer::createSurface() {
+    if (isHeadless()) {
+        return vk::raii::SurfaceKHR{nullptr};
+    }
     VkSurfaceKHR surface{};
     if (!SDL_Vulkan_CreateSurface(m_sdlWindow, *m_instance, &surface)) {
         throw std::runtime_error("SDL2 could not create Vulkan surface!");
@@ -396,6 +501,9 @@ vk::raii::PhysicalDevice VulkanRenderer::createPhysicalDevice(
 }
 
 vk::PresentModeKHR VulkanRenderer::selectClosestPresentMode(bool vSync) {
+    if (isHeadless()) {
+        return eFifo; // Irrelevant, nothing is presented
+    }
     auto modes     = m_physicalDevice.getSurfacePresentModesKHR(*m_surface);
     auto idealMode = vSync ? eMailbox : eImmediate;
     auto acceptableMode  = vSync ? eFifo : eFifoRelaxed;
@@ -425,8 +533,23 @@ vk::raii::Device VulkanRenderer::createDevice(const void* deviceCreateInfoChain)
             &deviceQueuePriority
         );
     }
+    // Enable the optional extensions that are supported
+    std::vector<const char*> extensions{
+        k_deviceExtensions.begin(), k_deviceExtensions.end()
+    };
+    for (const auto& ext : m_physicalDevice.enumerateDeviceExtensionProperties()) {
+        for (const char* optional : k_optionalDeviceExtensions) {
+            if (std::strcmp(ext.extensionName.data(), optional) == 0) {
+                extensions.push_back(optional);
+            }
+        }
+    }
+    m_calibratedTimestamps = std::ranges::find_if(extensions, [](const char* ext) {
+        return std::strcmp(ext, VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME) == 0;
+    }) != extensions.end();
+
     vk::DeviceCreateInfo createInfo{{}, deviceQueueCreateInfos,
-                                    {}, k_deviceExtensions,
+                                    {}, extensions,
                                     {}, deviceCreateInfoChain};
 
     return vk::raii::Device{m_physicalDevice, createInfo};
@@ -451,6 +574,12 @@ vk::raii::Queue VulkanRenderer::getQueue(uint32_t familyIndex) {
 }
 
 vk::raii::SwapchainKHR VulkanRenderer::createSwapchain() {
+    if (isHeadless()) {
+        // Offscreen images are used instead, see createOffscreenImages()
+        m_minImageCount   = k_maxFramesInFlight + 1;
+        m_swapchainExtent = vk::Extent2D{m_headlessExtent.x, m_headlessExtent.y};
+        return vk::raii::SwapchainKHR{nullptr};
+    }
     auto caps = m_physicalDevice.getSurfaceCapabilitiesKHR(*m_surface);
     // Minimum image count
     m_minImageCount = glm::clamp(
@@ -474,6 +603,13 @@ vk::raii::SwapchainKHR VulkanRenderer::createSwapchain() {
         );
     }
 
+    // Usage, copies from the images are needed to capture them
+    m_swapchainReadable = static_cast<bool>(caps.supportedUsageFlags & eTransferSrc);
+    vk::ImageUsageFlags usage = eColorAttachment;
+    if (m_swapchainReadable) {
+        usage |= eTransferSrc;
+    }
+
     // Sharing mode
     bool oneQueueFamily = m_graphicsCompQueueFamIndex == m_presentationQueueFamIndex;
     auto sharingMode              = oneQueueFamily ? eExclusive : eConcurrent;
@@ -488,7 +624,7 @@ vk::raii::SwapchainKHR VulkanRenderer::createSwapchain() {
         k_surfaceFormat.colorSpace,
         m_swapchainExtent,
         1u,
-        eColorAttachment,
+        usage,
         sharingMode,
         oneQueueFamily ? vk::ArrayProxyNoTemporaries<const uint32_t>{}
                        : queueFamilyIndices,
@@ -501,8 +637,11 @@ vk::raii::SwapchainKHR VulkanRenderer::createSwapchain() {
 }
 
 std::vector<vk::raii::ImageView> VulkanRenderer::createSwapchainImageViews() {
-    auto images = m_swapchain.getImages();
     std::vector<vk::raii::ImageView> imageViews;
+    if (isHeadless()) {
+        return imageViews;
+    }
+    auto images = m_swapchain.getImages();
     imageViews.reserve(images.size());
     for (const auto& image : images) {
         imageViews.emplace_back(
@@ -540,12 +679,34 @@ std::vector<Texture> VulkanRenderer::createAdditionalBuffers() {
     return buffers;
 }
 
-std::vector<vk::raii::Framebuffer> VulkanRenderer::createSwapchainFramebuffers() {
+std::vector<Texture> VulkanRenderer::createOffscreenImages() {
+    std::vector<Texture> images;
+    if (!isHeadless()) {
+        return images;
+    }
+    images.reserve(m_minImageCount);
+    for (uint32_t i = 0; i < m_minImageCount; ++i) {
+        images.emplace_back(TextureCreateInfo{
+            .allocFlags    = vma::AllocationCreateFlagBits::eDedicatedMemory,
+            .format        = k_surfaceFormat.format,
+            .extent        = glm::uvec3{m_headlessExtent, 1},
+            .usage         = eColorAttachment | eTransferSrc,
+            .initialLayout = vk::ImageLayout::eUndefined,
+            .hasSampler    = false,
+            .debugName     = "re::VulkanRenderer::offscreenImages"
+        });
+    }
+    return images;
+}
+
+std::vector<vk::raii::Framebuffer> VulkanRenderer::createSwapchainFramebuffers(
+    vk::RenderPass rp
+) {
     std::vector<vk::ImageView> views;
     views.resize(1 + m_additionalBuffers.size());
     vk::FramebufferCreateInfo createInfo{
         {},
-        **m_mainRenderPass,
+        rp,
         views,
         m_swapchainExtent.width,
         m_swapchainExtent.height,
@@ -559,9 +720,9 @@ std::vector<vk::raii::Framebuffer> VulkanRenderer::createSwapchainFramebuffers()
 
     // Swapchain images are different
     std::vector<vk::raii::Framebuffer> framebuffers;
-    framebuffers.reserve(m_swapchainImageViews.size());
-    for (size_t i = 0; i < m_swapchainImageViews.size(); i++) {
-        views[0] = *m_swapchainImageViews[i];
+    framebuffers.reserve(imageCount());
+    for (uint32_t i = 0; i < imageCount(); i++) {
+        views[0] = imageView(i);
         framebuffers.emplace_back(m_device, createInfo);
     }
     return framebuffers;
@@ -574,17 +735,18 @@ vk::raii::CommandPool VulkanRenderer::createCommandPool() {
     return vk::raii::CommandPool{m_device, createInfo};
 }
 
-FrameDoubleBuffered<vk::raii::Semaphore> VulkanRenderer::createSemaphores() {
+FrameMultiBuffered<vk::raii::Semaphore> VulkanRenderer::createSemaphores() {
     vk::SemaphoreCreateInfo createInfo{};
-    return {
-        vk::raii::Semaphore{m_device, createInfo},
-        vk::raii::Semaphore{m_device, createInfo}
-    };
+    return FrameMultiBuffered<vk::raii::Semaphore>{[&](int) {
+        return vk::raii::Semaphore{m_device, createInfo};
+    }};
 }
 
-FrameDoubleBuffered<vk::raii::Fence> VulkanRenderer::createFences() {
+FrameMultiBuffered<vk::raii::Fence> VulkanRenderer::createFences() {
     vk::FenceCreateInfo createInfo{vk::FenceCreateFlagBits::eSignaled};
-    return {vk::raii::Fence{m_device, createInfo}, vk::raii::Fence{m_device, createInfo}};
+    return FrameMultiBuffered<vk::raii::Fence>{[&](int) {
+        return vk::raii::Fence{m_device, createInfo};
+    }};
 }
 
 vk::raii::PipelineCache VulkanRenderer::createPipelineCache() {
@@ -609,7 +771,7 @@ vk::raii::DescriptorPool VulkanRenderer::createDescriptorPool() {
     vk::DescriptorPoolCreateInfo createInfo{
         {},
         // 8 is 'just enough' - deserves a better solution
-        static_cast<uint32_t>(m_swapchainImageViews.size()) * 8u,
+        static_cast<uint32_t>(imageCount()) * 8u,
         poolSizes
     };
     return vk::raii::DescriptorPool{m_device, createInfo};
@@ -618,7 +780,7 @@ vk::raii::DescriptorPool VulkanRenderer::createDescriptorPool() {
 void VulkanRenderer::recreateSwapchain() {
     m_device.waitIdle();
     // Destroy all swapchain dependent objects
-    m_swapChainFramebuffers.~vector();
+    for (auto& [rp, framebuffers] : m_framebuffers) { framebuffers.clear(); }
     m_additionalBuffers.~vector();
     m_swapchainImageViews.~vector();
     m_swapchain.~SwapchainKHR();
@@ -629,8 +791,105 @@ void VulkanRenderer::recreateSwapchain() {
     ){createSwapchainImageViews()};
     new (&m_additionalBuffers) decltype(m_additionalBuffers
     ){createAdditionalBuffers()};
-    new (&m_swapChainFramebuffers) decltype(m_swapChainFramebuffers
-    ){createSwapchainFramebuffers()};
+    for (auto& [rp, framebuffers] : m_framebuffers) {
+        framebuffers = createSwapchainFramebuffers(rp);
+    }
+}
+
+size_t VulkanRenderer::imageCount() const {
+    return isHeadless() ? m_minImageCount : m_swapchainImageViews.size();
+}
+
+vk::Image VulkanRenderer::image(uint32_t index) const {
+    if (isHeadless()) {
+        return m_offscreenImages[index].image();
+    }
+    return vk::Image{m_swapchain.getImages()[index]};
+}
+
+vk::ImageView VulkanRenderer::imageView(uint32_t index) const {
+    if (isHeadless()) {
+        return m_offscreenImages[index].imageView();
+    }
+    return *m_swapchainImageViews[index];
+}
+
+void VulkanRenderer::recordCapture(const CommandBuffer& cb, FrameCapture& capture) {
+    glm::uvec2 extent{m_swapchainExtent.width, m_swapchainExtent.height};
+    if (capture.extent != extent) {
+        using enum vma::AllocationCreateFlagBits;
+        capture.extent = extent;
+        capture.buffer = BufferMapped<std::byte>{BufferCreateInfo{
+            .allocFlags  = eHostAccessRandom | eMapped,
+            .memoryUsage = vma::MemoryUsage::eAutoPreferHost,
+            .sizeInBytes = static_cast<vk::DeviceSize>(extent.x) * extent.y * 4,
+            .usage       = vk::BufferUsageFlagBits::eTransferDst,
+            .debugName   = "re::VulkanRenderer::captures"
+        }};
+    }
+
+    // The main render pass leaves the image in the presentation layout
+    using enum vk::PipelineStageFlagBits2;
+    using enum vk::ImageLayout;
+    using Access = vk::AccessFlagBits2; // Both flag enums have eNone
+    vk::Image image = this->image(m_imageIndex);
+    vk::ImageSubresourceRange range{vk::ImageAspectFlagBits::eColor, 0u, 1u, 0u, 1u};
+    cb->pipelineBarrier2(vk::DependencyInfo{
+        {},
+        {},
+        {},
+        vk::ImageMemoryBarrier2{
+            eColorAttachmentOutput, Access::eColorAttachmentWrite, eCopy,
+            Access::eTransferRead,
+            ePresentSrcKHR, eTransferSrcOptimal, vk::QueueFamilyIgnored,
+            vk::QueueFamilyIgnored, image, range
+        }
+    });
+    cb->copyImageToBuffer2(vk::CopyImageToBufferInfo2{
+        image, eTransferSrcOptimal, capture.buffer.buffer(),
+        vk::BufferImageCopy2{
+            0u, 0u, 0u,
+            vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, 0u, 0u, 1u},
+            vk::Offset3D{0, 0, 0}, vk::Extent3D{extent.x, extent.y, 1u}
+        }
+    });
+    cb->pipelineBarrier2(vk::DependencyInfo{
+        {},
+        {},
+        vk::BufferMemoryBarrier2{
+            eCopy, Access::eTransferWrite, eHost, Access::eHostRead,
+            vk::QueueFamilyIgnored, vk::QueueFamilyIgnored, capture.buffer.buffer(), 0u,
+            vk::WholeSize
+        },
+        vk::ImageMemoryBarrier2{
+            eCopy, {}, eAllCommands, {}, eTransferSrcOptimal, ePresentSrcKHR,
+            vk::QueueFamilyIgnored, vk::QueueFamilyIgnored, image, range
+        }
+    });
+}
+
+void VulkanRenderer::saveCapture(FrameCapture& capture) {
+    static_assert(k_surfaceFormat.format == vk::Format::eB8G8R8A8Unorm);
+    capture.buffer.invalidateMapped();
+    const auto* texels = reinterpret_cast<const unsigned char*>(capture.buffer.mapped());
+    size_t size = static_cast<size_t>(capture.extent.x) * capture.extent.y * 4;
+    PNGLoader::PNGData png{
+        .texels = {texels, texels + size},
+        .dims   = capture.extent,
+        .shape  = TextureShape{.subimageDims = capture.extent}
+    };
+    // Swizzle to RGBA, the image is presented as opaque
+    for (size_t i = 0; i < png.texels.size(); i += 4) {
+        std::swap(png.texels[i], png.texels[i + 2]);
+        png.texels[i + 3] = 255;
+    }
+    JobSystem::shared().schedule(
+        [png = std::move(png), path = std::exchange(capture.pathPNG, {})] {
+            try {
+                PNGLoader::save(path, png);
+            } catch (const std::exception& e) { error(e.what()); }
+        }
+    );
 }
 
 void VulkanRenderer::assignImplementationReferences() {
@@ -644,6 +903,10 @@ void VulkanRenderer::assignImplementationReferences() {
     ObjectUsingVulkan::s_oneTimeSubmitCmdBuf   = &m_oneTimeSubmitCmdBuf;
     ObjectUsingVulkan::s_dispatchLoaderDynamic = &(m_dispatchLoaderDynamic);
     ObjectUsingVulkan::s_deletionQueue         = &m_deletionQueue;
+    ObjectUsingVulkan::s_uploadQueue           = &m_uploadQueue;
+    ObjectUsingVulkan::s_gpuProfiler           = &m_gpuProfiler;
+    ObjectUsingVulkan::s_bindlessTextures      = &m_bindlessTextures;
+    ObjectUsingVulkan::s_renderer              = this;
 }
 
 } // namespace re
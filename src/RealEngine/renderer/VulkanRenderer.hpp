@@ -3,16 +3,24 @@
  */
 #pragma once
 #include <array>
+#include <chrono>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
+#include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
 #include <vma/vk_mem_alloc.hpp>
 #include <vulkan/vulkan_raii.hpp>
 
-#include <RealEngine/graphics/synchronization/DoubleBuffered.hpp>
+#include <RealEngine/graphics/buffers/BufferMapped.hpp>
+#include <RealEngine/graphics/synchronization/MultiBuffered.hpp>
 #include <RealEngine/graphics/textures/Texture.hpp>
 #include <RealEngine/renderer/Allocator.hpp>
+#include <RealEngine/renderer/BindlessTextures.hpp>
+#include <RealEngine/renderer/GPUProfiler.hpp>
+#include <RealEngine/renderer/UploadQueue.hpp>
 #include <RealEngine/rooms/RoomDisplaySettings.hpp>
 
 struct SDL_Window;
@@ -46,6 +54,18 @@ struct VulkanInitInfo {
      * Extent of all of these is the extent of the swapchain.
      */
     std::span<BufferDescr> additionalBuffers;
+    /**
+     * @brief Size of the staging arena used to upload initial data of buffers
+     * and textures. Larger data are staged in dedicated buffers.
+     */
+    vk::DeviceSize uploadArenaSize = 32 * 1024 * 1024;
+    /**
+     * @brief Extent of offscreen images that are rendered into instead of
+     * the window if non-zero (= headless rendering). No surface is created
+     * and nothing is presented so no display is required. The window does
+     * not have to be created with Vulkan support.
+     */
+    glm::uvec2 headlessExtent{};
 };
 
 /**
@@ -72,8 +92,25 @@ public:
 
     ~VulkanRenderer();
 
+    /**
+     * @brief   Sets the render pass that the main render pass functions use
+     * @details Framebuffers are created only when the render pass is set for
+     *          the first time, they are kept for switching back to it until
+     *          the render pass is destroyed.
+     *          ImGui's backend can be initialized for a single render pass
+     *          at a time. It is reinitialized only if the render pass (or its
+     *          ImGui subpass) differs from the last one that used ImGui.
+     */
     void setMainRenderPass(const RenderPass& rp, uint32_t imGuiSubpassIndex);
 
+    /**
+     * @brief   Blocks until the GPU finishes the previous use of the resources
+     *          of the next frame
+     * @details This is done by prepareFrame() if it has not been done since
+     *          the last frame was finished.
+     */
+    void waitForFrameResources();
+
     const CommandBuffer& prepareFrame();
 
     void mainRenderPassBegin(std::span<const vk::ClearValue> clearValues);
@@ -83,6 +120,37 @@ public:
 
     void finishFrame();
 
+    /**
+     * @brief   Saves the frame that is being recorded as a PNG once it is rendered
+     * @details The image is copied to a host-visible buffer at the end of the
+     *          frame. The buffer is read when the resources of the frame are
+     *          reused, so the CPU never waits for it. The PNG is encoded and
+     *          written by the shared JobSystem.
+     * @note    Must be called between prepareFrame() and finishFrame(), after
+     *          the main render pass has ended. Only one capture per frame.
+     * @throws  Throws if the presented images cannot be copied from
+     */
+    void captureFrame(std::string pathPNG);
+
+    /**
+     * @brief Checks whether the renderer renders into offscreen images
+     */
+    bool isHeadless() const { return m_headlessExtent != glm::uvec2{}; }
+
+    /**
+     * @brief Gets time that was spent in waitForFrameResources() for the last frame
+     */
+    std::chrono::steady_clock::duration frameResourcesWaitTime() const {
+        return m_frameResourcesWaitTime;
+    }
+
+    /**
+     * @brief Gets time point when the last frame was submitted to the GPU
+     */
+    std::chrono::steady_clock::time_point lastSubmitTime() const {
+        return m_lastSubmitTime;
+    }
+
     void changePresentation(bool vSync);
 
     void prepareForDestructionOfRendererObjects();
@@ -101,10 +169,25 @@ public:
     DeletionQueue& deletionQueue() { return m_deletionQueue; }
 
 private:
+    friend class RenderPass;
+
+    /**
+     * @brief   Releases everything that has been created for the render pass
+     * @details Called by RenderPass when it is destroyed.
+     */
+    void renderPassDestroyed(vk::RenderPass rp);
+
+    struct FrameCapture {
+        std::string pathPNG; ///< Empty if the frame is not captured
+        glm::uvec2 extent{};
+        BufferMapped<std::byte> buffer;
+    };
+
     // Vulkan objects
     uint32_t m_imageIndex   = 0u;
     int m_frame             = 0;
     SDL_Window* m_sdlWindow = nullptr;
+    glm::uvec2 m_headlessExtent{};
     vk::raii::Context m_context{};
     vk::raii::Instance m_instance;
 #if RE_BUILDING_FOR_DEBUG
@@ -115,6 +198,7 @@ private:
     uint32_t m_presentationQueueFamIndex{};
     vk::raii::PhysicalDevice m_physicalDevice;
     vk::PresentModeKHR m_presentMode{};
+    bool m_calibratedTimestamps = false; ///< Whether the extension is enabled
     vk::raii::Device m_device;
     vk::DispatchLoaderDynamic m_dispatchLoaderDynamic{
         *m_instance, vkGetInstanceProcAddr, *m_device, vkGetDeviceProcAddr
@@ -126,23 +210,39 @@ private:
     vk::Extent2D m_swapchainExtent{};
     vk::raii::SwapchainKHR m_swapchain;
     std::vector<vk::raii::ImageView> m_swapchainImageViews;
+    bool m_swapchainReadable = false; ///< Can be copied from (for captures)
     std::vector<VulkanInitInfo::BufferDescr> m_additionalBufferDescrs;
     std::vector<Texture> m_additionalBuffers;
-    std::vector<vk::raii::Framebuffer> m_swapChainFramebuffers;
+    /**
+     * @brief Framebuffers of swapchain images for each render pass that has
+     *        been the main render pass
+     */
+    std::unordered_map<vk::RenderPass, std::vector<vk::raii::Framebuffer>> m_framebuffers;
     vk::raii::CommandPool m_commandPool;
-    FrameDoubleBuffered<CommandBuffer> m_cbs;
+    FrameMultiBuffered<CommandBuffer> m_cbs;
     CommandBuffer m_oneTimeSubmitCmdBuf;
     vk::raii::PipelineCache m_pipelineCache;
     vk::raii::DescriptorPool m_descriptorPool;
-    FrameDoubleBuffered<vk::raii::Semaphore> m_imageAvailableSems;
-    FrameDoubleBuffered<vk::raii::Semaphore> m_renderingFinishedSems;
-    FrameDoubleBuffered<vk::raii::Fence> m_inFlightFences;
-    bool m_recreteSwapchain = false;
+    FrameMultiBuffered<vk::raii::Semaphore> m_imageAvailableSems;
+    FrameMultiBuffered<vk::raii::Semaphore> m_renderingFinishedSems;
+    FrameMultiBuffered<vk::raii::Fence> m_inFlightFences;
+    bool m_recreteSwapchain    = false;
+    bool m_frameResourcesReady = false; ///< Waited for since the last frame
+    std::chrono::steady_clock::duration m_frameResourcesWaitTime{};
+    std::chrono::steady_clock::time_point m_lastSubmitTime{};
     DeletionQueue m_deletionQueue{*m_device, m_allocator};
+    UploadQueue m_uploadQueue;
+    GPUProfiler m_gpuProfiler;
+    BindlessTextures m_bindlessTextures;
+    std::vector<Texture> m_offscreenImages; ///< Replace swapchain when headless
+    FrameMultiBuffered<FrameCapture> m_captures;
 
     // Active room dependent
     const RenderPass* m_mainRenderPass{};
     uint32_t m_imGuiSubpassIndex{};
+    std::vector<vk::raii::Framebuffer>* m_mainFramebuffers{};
+    vk::RenderPass m_imGuiRenderPass{}; ///< That ImGui is initialized for
+    uint32_t m_imGuiRenderPassSubpass{};
 
     // Implementations
     void assignImplementationReferences();
@@ -161,14 +261,23 @@ private:
     vk::raii::SwapchainKHR createSwapchain();
     std::vector<vk::raii::ImageView> createSwapchainImageViews();
     std::vector<Texture> createAdditionalBuffers();
-    std::vector<vk::raii::Framebuffer> createSwapchainFramebuffers();
+    std::vector<Texture> createOffscreenImages();
+    std::vector<vk::raii::Framebuffer> createSwapchainFramebuffers(vk::RenderPass rp);
     vk::raii::CommandPool createCommandPool();
-    FrameDoubleBuffered<vk::raii::Semaphore> createSemaphores();
-    FrameDoubleBuffered<vk::raii::Fence> createFences();
+    FrameMultiBuffered<vk::raii::Semaphore> createSemaphores();
+    FrameMultiBuffered<vk::raii::Fence> createFences();
     vk::raii::PipelineCache createPipelineCache();
     vk::raii::DescriptorPool createDescriptorPool();
 
     void recreateSwapchain();
+
+    // Presented (or offscreen when headless) images
+    size_t imageCount() const;
+    vk::Image image(uint32_t index) const;
+    vk::ImageView imageView(uint32_t index) const;
+
+    void recordCapture(const CommandBuffer& cb, FrameCapture& capture);
+    void saveCapture(FrameCapture& capture);
 };
 
 } // namespace re
@@ -0,0 +1,175 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <RealEngine/resources/BlockCompression.hpp>
+#include <RealEngine/utility/Error.hpp>
+
+namespace re {
+
+namespace {
+
+// Constants of the LZ4 block format
+constexpr size_t k_minMatch      = 4;  // Shortest encodable match
+constexpr size_t k_lastLiterals  = 5;  // Last bytes are always literals
+constexpr size_t k_mfLimit       = 12; // Last match starts at least this far from end
+constexpr size_t k_maxOffset     = 65535;
+constexpr unsigned int k_hashLog = 16;
+
+uint32_t read32(const unsigned char* p) {
+    uint32_t val{};
+    std::memcpy(&val, p, sizeof(val));
+    return val;
+}
+
+uint32_t hash4(uint32_t sequence) {
+    constexpr uint32_t k_prime = 2654435761u;
+    return (sequence * k_prime) >> (32 - k_hashLog);
+}
+
+void writeLength(std::vector<unsigned char>& out, size_t len) {
+    while (len >= 255) {
+        out.push_back(255);
+        len -= 255;
+    }
+    out.push_back(static_cast<unsigned char>(len));
+}
+
+void writeSequence(
+    std::vector<unsigned char>& out, std::span<const unsigned char> literals,
+    size_t offset, size_t matchLen
+) {
+    size_t litLen   = literals.size();
+    size_t matchExt = matchLen - k_minMatch;
+    auto token      = static_cast<unsigned char>(
+        (std::min<size_t>(litLen, 15) << 4) | std::min<size_t>(matchExt, 15)
+    );
+    out.push_back(token);
+    if (litLen >= 15) {
+        writeLength(out, litLen - 15);
+    }
+    out.insert(out.end(), literals.begin(), literals.end());
+    out.push_back(static_cast<unsigned char>(offset & 0xff));
+    out.push_back(static_cast<unsigned char>(offset >> 8));
+    if (matchExt >= 15) {
+        writeLength(out, matchExt - 15);
+    }
+}
+
+void writeLastLiterals(
+    std::vector<unsigned char>& out, std::span<const unsigned char> literals
+) {
+    size_t litLen = literals.size();
+    out.push_back(static_cast<unsigned char>(std::min<size_t>(litLen, 15) << 4));
+    if (litLen >= 15) {
+        writeLength(out, litLen - 15);
+    }
+    out.insert(out.end(), literals.begin(), literals.end());
+}
+
+size_t readLength(std::span<const unsigned char> in, size_t& ip) {
+    size_t len = 0;
+    unsigned char byte{};
+    do {
+        if (ip >= in.size()) {
+            throw Exception{"Malformed LZ4 block: truncated length"};
+        }
+        byte = in[ip++];
+        len += byte;
+    } while (byte == 255);
+    return len;
+}
+
+} // namespace
+
+std::vector<unsigned char> compressLZ4Block(std::span<const unsigned char> in) {
+    std::vector<unsigned char> out;
+    out.reserve(in.size() + in.size() / 255 + 16);
+    const unsigned char* src = in.data();
+    size_t anchor            = 0;
+
+    if (in.size() > k_mfLimit) {
+        // Positions are stored +1 so that zero means an empty slot
+        std::vector<uint32_t> table(size_t{1} << k_hashLog, 0);
+        size_t mfLimit    = in.size() - k_mfLimit;
+        size_t matchLimit = in.size() - k_lastLiterals;
+        size_t ip         = 0;
+        while (ip < mfLimit) {
+            uint32_t sequence = read32(src + ip);
+            uint32_t& slot    = table[hash4(sequence)];
+            size_t ref        = slot;
+            slot              = static_cast<uint32_t>(ip + 1);
+            if (ref == 0 || ip - (ref - 1) > k_maxOffset ||
+                read32(src + ref - 1) != sequence) {
+                ++ip;
+                continue;
+            }
+            ref -= 1;
+
+            // Extend the match forward
+            size_t len = k_minMatch;
+            while (ip + len < matchLimit && src[ref + len] == src[ip + len]) { ++len; }
+
+            writeSequence(out, in.subspan(anchor, ip - anchor), ip - ref, len);
+            ip += len;
+            anchor = ip;
+        }
+    }
+
+    writeLastLiterals(out, in.subspan(anchor));
+    return out;
+}
+
+void decompressLZ4Block(std::span<const unsigned char> in, std::span<unsigned char> out) {
+    size_t ip = 0;
+    size_t op = 0;
+    while (ip < in.size()) {
+        unsigned int token = in[ip++];
+
+        // Copy literals
+        size_t litLen = token >> 4;
+        if (litLen == 15) {
+            litLen += readLength(in, ip);
+        }
+        if (litLen > in.size() - ip || litLen > out.size() - op) {
+            throw Exception{"Malformed LZ4 block: literals out of bounds"};
+        }
+        std::memcpy(out.data() + op, in.data() + ip, litLen);
+        ip += litLen;
+        op += litLen;
+        if (ip == in.size()) {
+            break; // The last sequence has no match
+        }
+
+        // Copy match
+        if (in.size() - ip < 2) {
+            throw Exception{"Malformed LZ4 block: truncated offset"};
+        }
+        size_t offset = in[ip] | (size_t{in[ip + 1]} << 8);
+        ip += 2;
+        size_t matchLen = (token & 15) + k_minMatch;
+        if ((token & 15) == 15) {
+            matchLen += readLength(in, ip);
+        }
+        if (offset == 0 || offset > op || matchLen > out.size() - op) {
+            throw Exception{"Malformed LZ4 block: match out of bounds"};
+        }
+        unsigned char* dst       = out.data() + op;
+        const unsigned char* ref = dst - offset;
+        if (offset >= matchLen) {
+            std::memcpy(dst, ref, matchLen);
+        } else { // Overlapping copy
+            for (size_t i = 0; i < matchLen; ++i) { dst[i] = ref[i]; }
+        }
+        op += matchLen;
+    }
+
+    if (op != out.size()) {
+        throw Exception{"Malformed LZ4 block: unexpected decompressed size"};
+    }
+}
+
+} // namespace re
@@ -0,0 +1,27 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <span>
+#include <vector>
+
+namespace re {
+
+/**
+ * @brief   Compresses data as a single block in LZ4 block format
+ * @details The compressor is a simple greedy one - it is meant to be used
+ *          offline by the packager. The output is decodable by any LZ4 block
+ *          decoder.
+ */
+std::vector<unsigned char> compressLZ4Block(std::span<const unsigned char> in);
+
+/**
+ * @brief Decompresses a single block in LZ4 block format
+ * @param in The compressed block
+ * @param out Receives the decompressed data, its size must match the original
+ *            size of the data exactly
+ * @throws re::Exception When the block is malformed or does not fit the output
+ */
+void decompressLZ4Block(std::span<const unsigned char> in, std::span<unsigned char> out);
+
+} // namespace re
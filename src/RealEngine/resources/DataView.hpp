@@ -0,0 +1,50 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <span>
+
+namespace re {
+
+/**
+ * @brief   Is a read-only view of bytes of a resource which keeps them alive
+ * @details The bytes typically reside directly in a memory-mapped package
+ *          or file, in which case they are never copied. The handle is cheap
+ *          to copy; the bytes stay valid as long as any copy of it exists.
+ * @see     ResourceManager::dataView()
+ */
+class DataView {
+public:
+    /**
+     * @brief Constructs an empty view
+     */
+    DataView() = default;
+
+    /**
+     * @param bytes The viewed bytes
+     * @param owner Keeps the bytes alive
+     */
+    DataView(std::span<const std::byte> bytes, std::shared_ptr<const void> owner)
+        : m_bytes(bytes)
+        , m_owner(std::move(owner)) {}
+
+    std::span<const std::byte> bytes() const { return m_bytes; }
+
+    /**
+     * @brief Gets the bytes for interoperability with APIs that take unsigned chars
+     */
+    std::span<const unsigned char> asUnsignedChars() const {
+        return {reinterpret_cast<const unsigned char*>(m_bytes.data()), m_bytes.size()};
+    }
+
+    size_t size() const { return m_bytes.size(); }
+    bool empty() const { return m_bytes.empty(); }
+
+private:
+    std::span<const std::byte> m_bytes;
+    std::shared_ptr<const void> m_owner;
+};
+
+} // namespace re
@@ -0,0 +1,745 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <RealEngine/resources/FastPNGDecoder.hpp>
+#include <RealEngine/utility/SIMD.hpp>
+
+namespace re {
+
+namespace {
+
+uint32_t readBE32(const unsigned char* p) {
+    return (uint32_t{p[0]} << 24) | (uint32_t{p[1]} << 16) | (uint32_t{p[2]} << 8) |
+           uint32_t{p[3]};
+}
+
+uint32_t adler32(std::span<const unsigned char> data) {
+    constexpr uint32_t k_base = 65521;
+    constexpr size_t k_nmax   = 5552; ///< Largest block that cannot overflow b
+    uint32_t a = 1, b = 0;
+    const unsigned char* p = data.data();
+    size_t remaining       = data.size();
+    while (remaining > 0) {
+        size_t block = std::min(remaining, k_nmax);
+        remaining -= block;
+        for (; block > 0; --block) {
+            a += *p++;
+            b += a;
+        }
+        a %= k_base;
+        b %= k_base;
+    }
+    return (b << 16) | a;
+}
+
+/**
+ * @brief Reads bits of a deflate stream, least significant bit first
+ * @details Reading past the end of the input yields zeros,
+ *          overrun() reports whether such bits have been consumed.
+ */
+class BitReader {
+public:
+    explicit BitReader(std::span<const unsigned char> in)
+        : m_in(in) {}
+
+    /**
+     * @brief Ensures at least 56 bits are buffered
+     */
+    void refill() {
+        if (m_next + sizeof(uint64_t) <= m_in.size()) {
+            uint64_t word;
+            std::memcpy(&word, &m_in[m_next], sizeof(word));
+            if constexpr (std::endian::native == std::endian::big) {
+                word = std::byteswap(word);
+            }
+            m_buf |= word << m_count;
+            m_next += (63 - m_count) >> 3;
+            m_count |= 56;
+        } else {
+            while (m_count <= 56) {
+                uint64_t byte = m_next < m_in.size() ? m_in[m_next] : 0;
+                m_buf |= byte << m_count;
+                ++m_next;
+                m_count += 8;
+            }
+        }
+    }
+
+    uint32_t peek(unsigned int count) const {
+        return static_cast<uint32_t>(m_buf & ((uint64_t{1} << count) - 1));
+    }
+
+    void consume(unsigned int count) {
+        m_buf >>= count;
+        m_count -= count;
+    }
+
+    uint32_t bits(unsigned int count) {
+        uint32_t value = peek(count);
+        consume(count);
+        return value;
+    }
+
+    /**
+     * @brief Discards the buffered bits up to the next byte boundary
+     * @return Position of the next unread byte of the input
+     */
+    size_t alignToByte() {
+        consume(m_count & 7);
+        size_t pos = m_next - m_count / 8;
+        m_buf      = 0;
+        m_count    = 0;
+        m_next     = pos;
+        return pos;
+    }
+
+    void skipTo(size_t pos) { m_next = pos; }
+
+    bool overrun() const { return m_next - m_count / 8 > m_in.size(); }
+
+private:
+    std::span<const unsigned char> m_in;
+    size_t m_next        = 0; ///< Next byte to load into the buffer
+    uint64_t m_buf       = 0;
+    unsigned int m_count = 0; ///< Number of valid bits in the buffer
+};
+
+/**
+ * @brief Canonical Huffman code with a lookup table for short codes
+ */
+class HuffmanTable {
+public:
+    static constexpr unsigned int k_fastBits = 9;
+    static constexpr unsigned int k_maxBits  = 15;
+    static constexpr size_t k_maxSymbols     = 288;
+    static constexpr int k_invalid           = -1;
+
+    /**
+     * @brief Builds the code from lengths of codes of the symbols
+     * @return False if the lengths do not form a valid code
+     */
+    bool build(std::span<const uint8_t> lengths) {
+        std::array<int, k_maxBits + 1> counts{};
+        for (uint8_t length : lengths) { ++counts[length]; }
+        counts[0] = 0;
+        m_fast.fill(0);
+        std::array<int, k_maxBits + 1> nextCode{};
+        int code = 0, symbolIndex = 0;
+        for (unsigned int len = 1; len <= k_maxBits; ++len) {
+            nextCode[len]     = code;
+            m_firstCode[len]  = code;
+            m_firstIndex[len] = symbolIndex;
+            code += counts[len];
+            if (counts[len] != 0 && code - 1 >= (1 << len)) {
+                return false; // Oversubscribed
+            }
+            m_maxCode[len] = code << (16 - len); // Pre-shifted for decoding
+            code <<= 1;
+            symbolIndex += counts[len];
+        }
+        m_maxCode[k_maxBits + 1] = 0x10000; // Sentinel
+        for (size_t symbol = 0; symbol < lengths.size(); ++symbol) {
+            unsigned int len = lengths[symbol];
+            if (len == 0) {
+                continue;
+            }
+            int index        = nextCode[len] - m_firstCode[len] + m_firstIndex[len];
+            m_lengths[index] = static_cast<uint8_t>(len);
+            m_symbols[index] = static_cast<uint16_t>(symbol);
+            if (len <= k_fastBits) {
+                auto fast             = static_cast<uint16_t>((len << 9) | symbol);
+                unsigned int reversed = reverseBits(nextCode[len], len);
+                for (; reversed < m_fast.size(); reversed += 1u << len) {
+                    m_fast[reversed] = fast;
+                }
+            }
+            ++nextCode[len];
+        }
+        return true;
+    }
+
+    /**
+     * @brief Decodes next symbol, there must be at least 15 bits buffered
+     */
+    int decode(BitReader& reader) const {
+        uint16_t fast = m_fast[reader.peek(k_fastBits)];
+        if (fast != 0) {
+            reader.consume(fast >> 9);
+            return fast & 511;
+        }
+        // The code is longer than the lookup, search canonically
+        int reversed     = static_cast<int>(reverseBits(reader.peek(16), 16));
+        unsigned int len = k_fastBits + 1;
+        while (reversed >= m_maxCode[len]) { ++len; }
+        if (len > k_maxBits) {
+            return k_invalid;
+        }
+        int index = (reversed >> (16 - len)) - m_firstCode[len] + m_firstIndex[len];
+        if (index < 0 || index >= static_cast<int>(k_maxSymbols) ||
+            m_lengths[index] != len) {
+            return k_invalid;
+        }
+        reader.consume(len);
+        return m_symbols[index];
+    }
+
+private:
+    static unsigned int reverseBits(unsigned int value, unsigned int count) {
+        unsigned int reversed = 0;
+        for (unsigned int i = 0; i < count; ++i) {
+            reversed = (reversed << 1) | (value & 1);
+            value >>= 1;
+        }
+        return reversed;
+    }
+
+    std::array<uint16_t, 1u << k_fastBits> m_fast{}; ///< Length << 9 | symbol
+    std::array<int, k_maxBits + 1> m_firstCode{};
+    std::array<int, k_maxBits + 2> m_maxCode{};
+    std::array<int, k_maxBits + 1> m_firstIndex{};
+    std::array<uint8_t, k_maxSymbols> m_lengths{};
+    std::array<uint16_t, k_maxSymbols> m_symbols{};
+};
+
+constexpr std::array<uint16_t, 29> k_lengthBase{
+    3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+    31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+constexpr std::array<uint8_t, 29> k_lengthExtra{
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+constexpr std::array<uint16_t, 30> k_distBase{
+    1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+    193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+constexpr std::array<uint8_t, 30> k_distExtra{
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+constexpr std::array<uint8_t, 19> k_codeLengthOrder{
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+/**
+ * @brief Inflates zlib stream whose decompressed size is known beforehand
+ * @details Matches are copied in 8-byte words, so the output must have
+ *          k_outputSlack extra bytes after the expected size.
+ */
+class Inflater {
+public:
+    static constexpr size_t k_outputSlack = 8;
+
+    Inflater(std::span<const unsigned char> in, std::span<unsigned char> out)
+        : m_reader(in)
+        , m_in(in)
+        , m_out(out.data())
+        , m_outEnd(out.data() + out.size() - k_outputSlack)
+        , m_outBegin(out.data()) {}
+
+    /**
+     * @brief Inflates the whole stream
+     * @return True if the stream is valid and has exactly the expected size
+     */
+    bool inflate() {
+        // Zlib header
+        if (m_in.size() < 6 || (m_in[0] * 256 + m_in[1]) % 31 != 0 ||
+            (m_in[0] & 15) != 8 || (m_in[0] >> 4) > 7 || (m_in[1] & 32) != 0) {
+            return false;
+        }
+        m_reader.skipTo(2);
+
+        // Deflate blocks
+        bool finalBlock = false;
+        while (!finalBlock) {
+            m_reader.refill();
+            finalBlock    = m_reader.bits(1) != 0;
+            uint32_t type = m_reader.bits(2);
+            bool ok       = false;
+            switch (type) {
+            case 0: ok = inflateStored(); break;
+            case 1: ok = inflateFixed(); break;
+            case 2: ok = inflateDynamic(); break;
+            default: return false;
+            }
+            if (!ok || m_reader.overrun()) {
+                return false;
+            }
+        }
+
+        // Zlib trailer
+        size_t trailer = m_reader.alignToByte();
+        if (trailer + 4 > m_in.size() || m_out != m_outEnd) {
+            return false;
+        }
+        return adler32({m_outBegin, m_outEnd}) == readBE32(&m_in[trailer]);
+    }
+
+private:
+    bool inflateStored() {
+        size_t pos = m_reader.alignToByte();
+        if (pos + 4 > m_in.size()) {
+            return false;
+        }
+        uint32_t len  = m_in[pos] | (m_in[pos + 1] << 8);
+        uint32_t nlen = m_in[pos + 2] | (m_in[pos + 3] << 8);
+        pos += 4;
+        if ((len ^ 0xFFFF) != nlen || pos + len > m_in.size() ||
+            len > static_cast<size_t>(m_outEnd - m_out)) {
+            return false;
+        }
+        std::memcpy(m_out, &m_in[pos], len);
+        m_out += len;
+        m_reader.skipTo(pos + len);
+        return true;
+    }
+
+    bool inflateFixed() {
+        static const auto s_tables = [] {
+            std::array<HuffmanTable, 2> tables;
+            std::array<uint8_t, 288> lengths{};
+            std::fill_n(&lengths[0], 144, 8);
+            std::fill_n(&lengths[144], 112, 9);
+            std::fill_n(&lengths[256], 24, 7);
+            std::fill_n(&lengths[280], 8, 8);
+            tables[0].build(lengths);
+            std::array<uint8_t, 32> distLengths{};
+            distLengths.fill(5);
+            tables[1].build(distLengths);
+            return tables;
+        }();
+        return inflateBlock(s_tables[0], s_tables[1]);
+    }
+
+    bool inflateDynamic() {
+        m_reader.refill();
+        uint32_t litCount  = m_reader.bits(5) + 257;
+        uint32_t distCount = m_reader.bits(5) + 1;
+        uint32_t clCount   = m_reader.bits(4) + 4;
+        if (litCount > 286 || distCount > 30) {
+            return false;
+        }
+
+        // Code lengths code
+        std::array<uint8_t, 19> clLengths{};
+        for (uint32_t i = 0; i < clCount; ++i) {
+            m_reader.refill();
+            clLengths[k_codeLengthOrder[i]] = static_cast<uint8_t>(m_reader.bits(3));
+        }
+        HuffmanTable clTable;
+        if (!clTable.build(clLengths)) {
+            return false;
+        }
+
+        // Literal/length and distance code lengths
+        std::array<uint8_t, 286 + 30> lengths{};
+        uint32_t total = litCount + distCount;
+        uint32_t i     = 0;
+        while (i < total) {
+            m_reader.refill();
+            int symbol = clTable.decode(m_reader);
+            if (symbol < 0) {
+                return false;
+            } else if (symbol < 16) {
+                lengths[i++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+            uint8_t repeated = 0;
+            uint32_t count   = 0;
+            if (symbol == 16) {
+                if (i == 0) {
+                    return false;
+                }
+                repeated = lengths[i - 1];
+                count    = 3 + m_reader.bits(2);
+            } else if (symbol == 17) {
+                count = 3 + m_reader.bits(3);
+            } else {
+                count = 11 + m_reader.bits(7);
+            }
+            if (i + count > total) {
+                return false;
+            }
+            std::fill_n(&lengths[i], count, repeated);
+            i += count;
+        }
+        if (lengths[256] == 0) {
+            return false; // The block could not end
+        }
+
+        HuffmanTable litTable, distTable;
+        if (!litTable.build({&lengths[0], litCount}) ||
+            !distTable.build({&lengths[litCount], distCount})) {
+            return false;
+        }
+        return inflateBlock(litTable, distTable);
+    }
+
+    bool inflateBlock(const HuffmanTable& litTable, const HuffmanTable& distTable) {
+        while (true) {
+            // Literal/length symbol (15 bits) + extra bits (5) + distance
+            // symbol (15) + extra bits (13) fits into single refill
+            m_reader.refill();
+            int symbol = litTable.decode(m_reader);
+            if (symbol < 256) {
+                if (symbol < 0 || m_out == m_outEnd) {
+                    return false;
+                }
+                *m_out++ = static_cast<unsigned char>(symbol);
+                continue;
+            } else if (symbol == 256) {
+                return true;
+            }
+
+            symbol -= 257;
+            if (symbol >= 29) {
+                return false;
+            }
+            size_t length = k_lengthBase[symbol] + m_reader.bits(k_lengthExtra[symbol]);
+            int distSymbol = distTable.decode(m_reader);
+            if (distSymbol < 0 || distSymbol >= 30) {
+                return false;
+            }
+            size_t dist = k_distBase[distSymbol] + m_reader.bits(k_distExtra[distSymbol]);
+            if (dist > static_cast<size_t>(m_out - m_outBegin) ||
+                length > static_cast<size_t>(m_outEnd - m_out)) {
+                return false;
+            }
+            copyMatch(length, dist);
+        }
+    }
+
+    void copyMatch(size_t length, size_t dist) {
+        const unsigned char* src = m_out - dist;
+        unsigned char* dst       = m_out;
+        m_out += length;
+        if (dist >= sizeof(uint64_t)) {
+            // Words never overlap, may write up to 7 bytes past the match
+            do {
+                std::memcpy(dst, src, sizeof(uint64_t));
+                dst += sizeof(uint64_t);
+                src += sizeof(uint64_t);
+            } while (dst < m_out);
+        } else if (dist == 1) {
+            std::memset(dst, *src, length);
+        } else {
+            for (; dst < m_out; ++dst, ++src) { *dst = *src; }
+        }
+    }
+
+    BitReader m_reader;
+    std::span<const unsigned char> m_in;
+    unsigned char* m_out;
+    unsigned char* m_outEnd;
+    unsigned char* m_outBegin;
+};
+
+enum class Filter : unsigned char {
+    None  = 0,
+    Sub   = 1,
+    Up    = 2,
+    Avg   = 3,
+    Paeth = 4
+};
+
+unsigned char paethPredictor(int a, int b, int c) {
+    int pa = std::abs(b - c);
+    int pb = std::abs(a - c);
+    int pc = std::abs(a + b - c - c);
+    if (pc < pa && pc < pb) {
+        return static_cast<unsigned char>(c);
+    }
+    return static_cast<unsigned char>(pb < pa ? b : a);
+}
+
+/**
+ * @brief Reverses filter of single row in place (scalar version)
+ * @param prior The previous unfiltered row (zeros for the first row)
+ */
+void unfilterRowScalar(
+    Filter filter, unsigned char* row, const unsigned char* prior, size_t len, size_t bpp
+) {
+    switch (filter) {
+    case Filter::None: break;
+    case Filter::Sub:
+        for (size_t i = bpp; i < len; ++i) { row[i] += row[i - bpp]; }
+        break;
+    case Filter::Up:
+        for (size_t i = 0; i < len; ++i) { row[i] += prior[i]; }
+        break;
+    case Filter::Avg:
+        for (size_t i = 0; i < bpp; ++i) { row[i] += prior[i] >> 1; }
+        for (size_t i = bpp; i < len; ++i) {
+            row[i] += static_cast<unsigned char>((row[i - bpp] + prior[i]) >> 1);
+        }
+        break;
+    case Filter::Paeth:
+        for (size_t i = 0; i < bpp; ++i) { row[i] += prior[i]; }
+        for (size_t i = bpp; i < len; ++i) {
+            row[i] += paethPredictor(row[i - bpp], prior[i], prior[i - bpp]);
+        }
+        break;
+    }
+}
+
+#ifdef RE_SIMD_SSE2
+
+/**
+ * @brief Loads/stores a pixel of BPP bytes (3 or 4) to/from low lanes
+ */
+template<size_t BPP>
+__m128i loadPixel(const unsigned char* p) {
+    uint32_t value = 0;
+    std::memcpy(&value, p, BPP);
+    return _mm_cvtsi32_si128(static_cast<int>(value));
+}
+
+template<size_t BPP>
+void storePixel(unsigned char* p, __m128i v) {
+    auto value = static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+    std::memcpy(p, &value, BPP);
+}
+
+__m128i absI16(__m128i x) {
+    __m128i negative = _mm_cmplt_epi16(x, _mm_setzero_si128());
+    return _mm_sub_epi16(_mm_xor_si128(x, negative), negative);
+}
+
+__m128i select(__m128i condition, __m128i ifTrue, __m128i ifFalse) {
+    return _mm_or_si128(
+        _mm_and_si128(condition, ifTrue), _mm_andnot_si128(condition, ifFalse)
+    );
+}
+
+/**
+ * @brief Reverses filter of single row in place, the filters are applied
+ *        to whole pixels at once
+ */
+template<size_t BPP>
+void unfilterRowSSE2(
+    Filter filter, unsigned char* row, const unsigned char* prior, size_t len
+) {
+    const __m128i zero = _mm_setzero_si128();
+    switch (filter) {
+    case Filter::None: break;
+    case Filter::Sub: {
+        __m128i a = zero;
+        for (size_t i = 0; i < len; i += BPP) {
+            a = _mm_add_epi8(loadPixel<BPP>(&row[i]), a);
+            storePixel<BPP>(&row[i], a);
+        }
+        break;
+    }
+    case Filter::Up: {
+        size_t i = 0;
+        for (; i + 16 <= len; i += 16) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&row[i]));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&prior[i]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&row[i]), _mm_add_epi8(x, b));
+        }
+        for (; i < len; ++i) { row[i] += prior[i]; }
+        break;
+    }
+    case Filter::Avg: {
+        const __m128i one = _mm_set1_epi8(1);
+        __m128i a         = zero;
+        for (size_t i = 0; i < len; i += BPP) {
+            __m128i b = loadPixel<BPP>(&prior[i]);
+            // Average has to be truncated but _mm_avg_epu8 rounds up
+            __m128i avg = _mm_avg_epu8(a, b);
+            avg = _mm_sub_epi8(avg, _mm_and_si128(_mm_xor_si128(a, b), one));
+            a   = _mm_add_epi8(loadPixel<BPP>(&row[i]), avg);
+            storePixel<BPP>(&row[i], a);
+        }
+        break;
+    }
+    case Filter::Paeth: {
+        // Computed in 16-bit lanes to avoid overflow of the estimates
+        __m128i a = zero, b = zero, c = zero;
+        for (size_t i = 0; i < len; i += BPP) {
+            c          = b;
+            b          = _mm_unpacklo_epi8(loadPixel<BPP>(&prior[i]), zero);
+            __m128i x  = _mm_unpacklo_epi8(loadPixel<BPP>(&row[i]), zero);
+            __m128i pa = _mm_sub_epi16(b, c); // p - a
+            __m128i pb = _mm_sub_epi16(a, c); // p - b
+            __m128i pc = _mm_add_epi16(pa, pb); // p - c
+            pa         = absI16(pa);
+            pb         = absI16(pb);
+            pc         = absI16(pc);
+            __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+            // Ties are broken in favor of a, then b
+            __m128i predictor = select(
+                _mm_cmpeq_epi16(smallest, pa), a,
+                select(_mm_cmpeq_epi16(smallest, pb), b, c)
+            );
+            // Wraps modulo 256 in the low bytes, high bytes stay zero
+            a = _mm_add_epi8(x, predictor);
+            storePixel<BPP>(&row[i], _mm_packus_epi16(a, a));
+        }
+        break;
+    }
+    }
+}
+
+#endif // RE_SIMD_SSE2
+
+void unfilterRow(
+    Filter filter, unsigned char* row, const unsigned char* prior, size_t len, size_t bpp
+) {
+#ifdef RE_SIMD_SSE2
+    if (bpp == 4) {
+        return unfilterRowSSE2<4>(filter, row, prior, len);
+    } else if (bpp == 3) {
+        return unfilterRowSSE2<3>(filter, row, prior, len);
+    }
+#endif // RE_SIMD_SSE2
+    unfilterRowScalar(filter, row, prior, len, bpp);
+}
+
+/**
+ * @brief Expands unfiltered row of given color type to RGBA8
+ */
+void expandRow(
+    const unsigned char* row, unsigned char* out, size_t width, unsigned char colorType
+) {
+    switch (colorType) {
+    case 0: // Grayscale
+        for (size_t x = 0; x < width; ++x, out += 4) {
+            out[0] = out[1] = out[2] = row[x];
+            out[3]                   = 255;
+        }
+        break;
+    case 2: // RGB
+        for (size_t x = 0; x < width; ++x, out += 4, row += 3) {
+            out[0] = row[0];
+            out[1] = row[1];
+            out[2] = row[2];
+            out[3] = 255;
+        }
+        break;
+    case 4: // Grayscale + alpha
+        for (size_t x = 0; x < width; ++x, out += 4, row += 2) {
+            out[0] = out[1] = out[2] = row[0];
+            out[3]                   = row[1];
+        }
+        break;
+    case 6: // RGBA
+        std::memcpy(out, row, width * 4);
+        break;
+    }
+}
+
+size_t bytesPerPixel(unsigned char colorType) {
+    switch (colorType) {
+    case 0: return 1;
+    case 2: return 3;
+    case 4: return 2;
+    case 6: return 4;
+    default: return 0;
+    }
+}
+
+constexpr std::array<unsigned char, 8> k_signature{137, 80, 78, 71, 13, 10, 26, 10};
+
+/**
+ * @brief Images with more pixels are declined (decoded RGBA8 fits into 1 GiB)
+ * @details Also keeps sizes of the raw and decoded buffers representable by
+ *          32-bit size_t.
+ */
+constexpr size_t k_maxPixelCount = size_t{1} << 28;
+
+bool isChunk(const unsigned char* type, const char* expected) {
+    return std::memcmp(type, expected, 4) == 0;
+}
+
+} // namespace
+
+std::optional<FastPNGDecoder::Decoded> FastPNGDecoder::decode(
+    std::span<const unsigned char> encoded
+) {
+    if (encoded.size() < k_signature.size() ||
+        !std::equal(k_signature.begin(), k_signature.end(), encoded.begin())) {
+        return std::nullopt;
+    }
+
+    // Walk the chunks
+    Decoded decoded{};
+    unsigned char colorType = 0;
+    std::vector<unsigned char> compressed;
+    bool headerRead = false, endReached = false;
+    size_t pos      = k_signature.size();
+    while (!endReached) {
+        if (pos + 12 > encoded.size()) {
+            return std::nullopt;
+        }
+        size_t length             = readBE32(&encoded[pos]);
+        const unsigned char* type = &encoded[pos + 4];
+        const unsigned char* data = &encoded[pos + 8];
+        if (length > encoded.size() - pos - 12) {
+            return std::nullopt;
+        }
+        pos += length + 12;
+
+        if (isChunk(type, "IHDR")) {
+            if (headerRead || length != 13) {
+                return std::nullopt;
+            }
+            decoded.dims = {readBE32(&data[0]), readBE32(&data[4])};
+            colorType    = data[9];
+            if (decoded.dims.x == 0 || decoded.dims.y == 0 ||
+                decoded.dims.x > k_maxPixelCount / decoded.dims.y || data[8] != 8 ||
+                bytesPerPixel(colorType) == 0 || data[10] != 0 || data[11] != 0 ||
+                data[12] != 0) {
+                return std::nullopt; // Leave non-8-bit, palette and interlaced to lodepng
+            }
+            headerRead = true;
+        } else if (!headerRead) {
+            return std::nullopt; // IHDR must come first
+        } else if (isChunk(type, "IDAT")) {
+            compressed.insert(compressed.end(), data, data + length);
+        } else if (isChunk(type, "IEND")) {
+            endReached = true;
+        } else if (isChunk(type, "tRNS")) {
+            return std::nullopt; // Transparency key is left to lodepng
+        } else if (isChunk(type, "reAl")) {
+            if (decoded.realChunk.empty()) {
+                decoded.realChunk = {data, length};
+            }
+        } else if ((type[0] & 32) == 0 && !isChunk(type, "PLTE")) {
+            return std::nullopt; // Unknown critical chunk
+        }
+    }
+
+    // Inflate
+    size_t bpp       = bytesPerPixel(colorType);
+    size_t width     = decoded.dims.x;
+    size_t rowLength = width * bpp;
+    size_t stride    = rowLength + 1; // Filter type byte + pixels
+    std::vector<unsigned char> raw(stride * decoded.dims.y + Inflater::k_outputSlack);
+    if (!Inflater{compressed, raw}.inflate()) {
+        return std::nullopt;
+    }
+
+    // Unfilter and expand the rows
+    decoded.texels.resize(width * 4 * decoded.dims.y);
+    std::vector<unsigned char> zeroRow(rowLength, 0);
+    const unsigned char* prior = zeroRow.data();
+    for (size_t y = 0; y < decoded.dims.y; ++y) {
+        unsigned char* filtered = &raw[y * stride];
+        if (filtered[0] > static_cast<unsigned char>(Filter::Paeth)) {
+            return std::nullopt;
+        }
+        unsigned char* row = filtered + 1;
+        unfilterRow(static_cast<Filter>(filtered[0]), row, prior, rowLength, bpp);
+        expandRow(row, &decoded.texels[y * width * 4], width, colorType);
+        prior = row;
+    }
+    return decoded;
+}
+
+} // namespace re
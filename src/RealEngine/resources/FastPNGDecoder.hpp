@@ -0,0 +1,41 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+namespace re {
+
+/**
+ * @brief   Decodes the common kinds of PNGs faster than lodepng
+ * @details Handles non-interlaced 8-bit grayscale, grayscale-alpha, RGB and
+ *          RGBA images without transparency chunk and with at most 2^28
+ *          pixels. Row unfiltering is vectorized with SSE2 (where available)
+ *          for 3 and 4 bytes per pixel. The output is identical to that of
+ *          lodepng (converted to RGBA8), PNGDecoderCheck tool verifies this.
+ * @details CRCs of chunks are not checked, the image data are still
+ *          protected by the Adler-32 checksum of the zlib stream.
+ * @note    This is used internally by PNGLoader which falls back to lodepng
+ *          whenever this decoder declines the PNG.
+ */
+class FastPNGDecoder {
+public:
+    struct Decoded {
+        std::vector<unsigned char> texels; ///< RGBA8, tightly packed rows
+        glm::uvec2 dims{};
+        std::span<const unsigned char> realChunk; ///< Data of 'reAl' chunk, if any
+    };
+
+    /**
+     * @brief   Decodes the PNG
+     * @return  The decoded PNG or nullopt if the PNG is not supported by this
+     *          decoder or is malformed
+     */
+    static std::optional<Decoded> decode(std::span<const unsigned char> encoded);
+};
+
+} // namespace re
@@ -0,0 +1,134 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <format>
+#include <utility>
+
+#include <RealEngine/resources/MappedFile.hpp>
+#include <RealEngine/utility/Error.hpp>
+
+#if RE_BUILDING_FOR_WINDOWS
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <Windows.h>
+#elif RE_BUILDING_FOR_LINUX // ^^^ RE_BUILDING_FOR_WINDOWS
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#else
+#    error "Unhandled OS"
+#endif
+
+namespace re {
+
+#if RE_BUILDING_FOR_WINDOWS
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    HANDLE file = CreateFileW(
+        path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        throw Exception{std::format("Could not open file {}", path.string())};
+    }
+    m_file = file;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw Exception{std::format("Could not query size of file {}", path.string())};
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size == 0) {
+        return; // Empty files cannot be mapped
+    }
+
+    m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping) {
+        CloseHandle(file);
+        throw Exception{std::format("Could not map file {}", path.string())};
+    }
+    m_data = static_cast<const unsigned char*>(
+        MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0)
+    );
+    if (!m_data) {
+        CloseHandle(m_mapping);
+        CloseHandle(file);
+        throw Exception{std::format("Could not map file {}", path.string())};
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+    }
+    if (m_file) {
+        CloseHandle(m_file);
+    }
+}
+
+#elif RE_BUILDING_FOR_LINUX // ^^^ RE_BUILDING_FOR_WINDOWS
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw Exception{std::format("Could not open file {}", path.string())};
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw Exception{std::format("Could not query size of file {}", path.string())};
+    }
+    m_size = static_cast<size_t>(info.st_size);
+    if (m_size == 0) {
+        close(fd);
+        return; // Empty files cannot be mapped
+    }
+
+    void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps its own reference to the file
+    if (data == MAP_FAILED) {
+        throw Exception{std::format("Could not map file {}", path.string())};
+    }
+    madvise(data, m_size, MADV_RANDOM);
+    m_data = static_cast<const unsigned char*>(data);
+}
+
+MappedFile::~MappedFile() {
+    if (m_data) {
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+    }
+}
+
+#endif // RE_BUILDING_FOR_LINUX
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0))
+#if RE_BUILDING_FOR_WINDOWS
+    , m_file(std::exchange(other.m_file, nullptr))
+    , m_mapping(std::exchange(other.m_mapping, nullptr))
+#endif // RE_BUILDING_FOR_WINDOWS
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+#if RE_BUILDING_FOR_WINDOWS
+    std::swap(m_file, other.m_file);
+    std::swap(m_mapping, other.m_mapping);
+#endif // RE_BUILDING_FOR_WINDOWS
+    return *this;
+}
+
+} // namespace re
@@ -0,0 +1,44 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <filesystem>
+#include <span>
+
+#include <RealEngine/utility/BuildType.hpp>
+
+namespace re {
+
+/**
+ * @brief   Maps a whole file into memory for reading
+ * @details The contents are paged in by the operating system on demand so
+ *          only the parts that are actually accessed are read from disk.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Maps the file at given path
+     * @throws re::Exception When the file cannot be opened or mapped
+     */
+    explicit MappedFile(const std::filesystem::path& path);
+
+    MappedFile(const MappedFile&)            = delete; ///< Noncopyable
+    MappedFile& operator=(const MappedFile&) = delete; ///< Noncopyable
+
+    MappedFile(MappedFile&& other) noexcept;            ///< Movable
+    MappedFile& operator=(MappedFile&& other) noexcept; ///< Movable
+
+    ~MappedFile();
+
+    std::span<const unsigned char> bytes() const { return {m_data, m_size}; }
+
+private:
+    const unsigned char* m_data = nullptr;
+    size_t m_size               = 0;
+#if RE_BUILDING_FOR_WINDOWS
+    void* m_file    = nullptr; ///< HANDLE of the file
+    void* m_mapping = nullptr; ///< HANDLE of the file mapping object
+#endif // RE_BUILDING_FOR_WINDOWS
+};
+
+} // namespace re
@@ -3,6 +3,7 @@
  */
 #include <lodepng/lodepng.hpp>
 
+#include <RealEngine/resources/FastPNGDecoder.hpp>
 #include <RealEngine/resources/PNGLoader.hpp>
 #include <RealEngine/utility/Endianness.hpp>
 #include <RealEngine/utility/Error.hpp>
@@ -68,6 +69,24 @@ PNGLoader::PNGData PNGLoader::load(const std::string& filePathPNG) {
 }
 
 PNGLoader::PNGData PNGLoader::load(const std::vector<unsigned char>& encoded) {
+    if (decoder() == Decoder::Fast) {
+        if (auto fast = FastPNGDecoder::decode(encoded)) {
+            PNGData decoded{.texels = std::move(fast->texels), .dims = fast->dims};
+            if (!fast->realChunk.empty()) {
+                decoded.shape = decodeTextureShape(
+                    fast->realChunk.data(),
+                    static_cast<unsigned int>(fast->realChunk.size())
+                );
+            }
+            return decoded;
+        }
+    }
+    return loadWithLodepng(encoded); // Unsupported by the fast decoder
+}
+
+PNGLoader::PNGData PNGLoader::loadWithLodepng(
+    const std::vector<unsigned char>& encoded
+) {
     // Prepare variables
     lodepng::State state{};
     state.decoder.remember_unknown_chunks = 1;
@@ -2,6 +2,7 @@
  *  @author    Dubsky Tomas
  */
 #pragma once
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -23,6 +24,21 @@ public:
         TextureShape shape;
     };
 
+    /**
+     * @brief Specifies the implementation that decodes PNGs
+     */
+    enum class Decoder {
+        Fast,    ///< FastPNGDecoder, falls back to lodepng for unsupported PNGs
+        Lodepng  ///< Always lodepng
+    };
+
+    /**
+     * @brief Selects the implementation that decodes PNGs, Fast is the default
+     * @details Can be called from any thread, affects all subsequent loads.
+     */
+    static void setDecoder(Decoder decoder) { s_decoder.store(decoder); }
+    static Decoder decoder() { return s_decoder.load(); }
+
     /**
      * @brief   Loads texels and parameters from PNG file
      * @throws  Throws when the file cannot be opened/decoded
@@ -50,6 +66,11 @@ public:
     static void replaceParameters(
         const std::string& filePathPNG, const TextureShape& shape
     );
+
+private:
+    static PNGData loadWithLodepng(const std::vector<unsigned char>& encoded);
+
+    static inline std::atomic<Decoder> s_decoder = Decoder::Fast;
 };
 
 } // namespace re
@@ -9,6 +9,11 @@ namespace re {
 constexpr const char* k_packageKey  = "906def63237d";
 constexpr const char* k_packageName = "package.dat";
 
+/**
+ * @brief Default directory of cached font atlases, precomputed by ResourcePackager
+ */
+constexpr const char* k_fontAtlasCacheDir = "font_atlases";
+
 constexpr const char* default7ZipSharedLibLocation() {
     switch (k_buildOS) {
     case BuildOS::Windows: return "7z.dll";
@@ -0,0 +1,78 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+
+namespace re {
+
+/**
+ * @brief   Describes the layout of the engine-native package format
+ * @details The package starts with a header which points to a table of entries.
+ *          The table is indexed directly by ResourceID::id() so any resource
+ *          can be located without reading anything else from the package.
+ *          Each entry is compressed independently.
+ * @details All values are stored in little-endian byte order.
+ */
+namespace package {
+
+static_assert(
+    std::endian::native == std::endian::little,
+    "Engine-native packages are read in-place and require a little-endian host"
+);
+
+constexpr std::array<char, 4> k_magic{'r', 'e', 'P', 'K'};
+constexpr uint32_t k_version = 2;
+
+/**
+ * @brief Data of each entry are aligned to this number of bytes
+ */
+constexpr uint64_t k_entryAlignment = 16;
+
+/**
+ * @brief Specifies how data of an entry are stored
+ */
+enum class Compression : uint32_t {
+    Stored = 0, ///< The data are stored uncompressed
+    LZ4    = 1  ///< The data are compressed as a single LZ4 block
+};
+
+struct Header {
+    std::array<char, 4> magic = k_magic;
+    uint32_t version          = k_version;
+    uint32_t entryCount       = 0;
+    uint32_t reserved         = 0;
+    uint64_t tableOffset      = 0; ///< Offset of the entry table from start of the package
+};
+static_assert(sizeof(Header) == 24);
+
+struct Entry {
+    uint64_t offset       = 0; ///< Offset of the data from start of the package
+    uint64_t storedSize   = 0; ///< Size of the data within the package
+    uint64_t originalSize = 0; ///< Size of the data after decompression
+    Compression compression = Compression::Stored;
+    uint32_t reserved       = 0;
+    uint64_t contentHash    = 0; ///< Of the input, allows reuse of unchanged entries
+};
+static_assert(sizeof(Entry) == 40);
+
+/**
+ * @brief Hashes content of an input of the package (64-bit FNV-1a)
+ * @param seed Allows to continue hashing from previous result
+ */
+constexpr uint64_t hashContent(
+    std::span<const unsigned char> bytes, uint64_t seed = 0xcbf29ce484222325
+) {
+    constexpr uint64_t k_prime = 0x100000001b3;
+    for (unsigned char byte : bytes) {
+        seed = (seed ^ byte) * k_prime;
+    }
+    return seed;
+}
+
+} // namespace package
+
+} // namespace re
@@ -0,0 +1,83 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <cstring>
+#include <format>
+
+#include <RealEngine/resources/BlockCompression.hpp>
+#include <RealEngine/resources/PackageReader.hpp>
+#include <RealEngine/utility/Error.hpp>
+
+namespace re {
+
+bool PackageReader::isNativePackage(std::span<const unsigned char> bytes) {
+    if (bytes.size() < sizeof(package::Header)) {
+        return false;
+    }
+    package::Header header{};
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    return header.magic == package::k_magic;
+}
+
+PackageReader::PackageReader(MappedFile&& file)
+    : m_file(std::move(file)) {
+    auto bytes = m_file.bytes();
+    if (!isNativePackage(bytes)) {
+        throw Exception{"Package is not in the engine-native format"};
+    }
+    std::memcpy(&m_header, bytes.data(), sizeof(m_header));
+    if (m_header.version != package::k_version) {
+        throw Exception{std::format(
+            "Unsupported package version {} (expected {})", m_header.version,
+            package::k_version
+        )};
+    }
+    uint64_t tableSize = uint64_t{m_header.entryCount} * sizeof(package::Entry);
+    if (m_header.tableOffset > bytes.size() ||
+        tableSize > bytes.size() - m_header.tableOffset) {
+        throw Exception{"Package entry table is out of bounds"};
+    }
+}
+
+package::Entry PackageReader::entry(ResourceID::IDType id) const {
+    if (id >= m_header.entryCount) {
+        throw Exception{std::format("Package does not contain entry {}", id)};
+    }
+    package::Entry entry{};
+    std::memcpy(
+        &entry,
+        m_file.bytes().data() + m_header.tableOffset + id * sizeof(package::Entry),
+        sizeof(entry)
+    );
+    return entry;
+}
+
+std::span<const unsigned char> PackageReader::storedBytes(const package::Entry& entry
+) const {
+    auto bytes = m_file.bytes();
+    if (entry.offset > bytes.size() || entry.storedSize > bytes.size() - entry.offset) {
+        throw Exception{"Package entry is out of bounds"};
+    }
+    return bytes.subspan(entry.offset, entry.storedSize);
+}
+
+std::vector<unsigned char> PackageReader::extract(ResourceID::IDType id) const {
+    package::Entry ent = entry(id);
+    auto stored        = storedBytes(ent);
+    switch (ent.compression) {
+    case package::Compression::Stored:
+        return std::vector<unsigned char>(stored.begin(), stored.end());
+    case package::Compression::LZ4: {
+        std::vector<unsigned char> rval(ent.originalSize);
+        decompressLZ4Block(stored, rval);
+        return rval;
+    }
+    default:
+        throw Exception{std::format(
+            "Package entry {} uses unknown compression {}", id,
+            static_cast<uint32_t>(ent.compression)
+        )};
+    }
+}
+
+} // namespace re
@@ -0,0 +1,59 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <span>
+#include <vector>
+
+#include <RealEngine/resources/MappedFile.hpp>
+#include <RealEngine/resources/PackageFormat.hpp>
+#include <RealEngine/resources/ResourceID.hpp>
+
+namespace re {
+
+/**
+ * @brief   Provides random access to entries of an engine-native package
+ * @details The package is memory-mapped so opening it costs next to nothing
+ *          and extracting an entry touches only the pages of that entry.
+ * @note    Extraction does not modify the reader so it may be done from
+ *          multiple threads concurrently.
+ * @see     re::package namespace for description of the format
+ */
+class PackageReader {
+public:
+    /**
+     * @brief Checks whether given bytes start with a valid native package header
+     */
+    static bool isNativePackage(std::span<const unsigned char> bytes);
+
+    /**
+     * @brief Opens the package
+     * @throws re::Exception When the file is not a valid native package
+     */
+    explicit PackageReader(MappedFile&& file);
+
+    uint32_t entryCount() const { return m_header.entryCount; }
+
+    /**
+     * @brief Gets description of an entry
+     * @throws re::Exception When there is no such entry
+     */
+    package::Entry entry(ResourceID::IDType id) const;
+
+    /**
+     * @brief Gets the bytes of an entry exactly as they are stored in the package
+     */
+    std::span<const unsigned char> storedBytes(const package::Entry& entry) const;
+
+    /**
+     * @brief Extracts (and decompresses if needed) an entry
+     * @throws re::Exception When there is no such entry or it is corrupted
+     */
+    std::vector<unsigned char> extract(ResourceID::IDType id) const;
+
+private:
+    MappedFile m_file;
+    package::Header m_header{};
+};
+
+} // namespace re
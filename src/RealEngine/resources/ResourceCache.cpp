@@ -1,35 +1,197 @@
 ﻿/**
  *  @author    Dubsky Tomas
  */
+#include <RealEngine/program/Profiler.hpp>
 #include <RealEngine/resources/ResourceCache.hpp>
 
 namespace re {
 
-ResourceCache::ResourceCache(const ResourceLoader& resourceLoader)
-    : m_resourceLoader{resourceLoader} {
+namespace {
+
+size_t resourceSize(const DataResource& data) {
+    return data.size();
+}
+
+size_t resourceSize(const TextureShaped& texture) {
+    auto dims = texture.trueDims();
+    return static_cast<size_t>(dims.x) * dims.y * 4; // RGBA8
+}
+
+} // namespace
+
+ResourceCache::ResourceCache(
+    const ResourceLoader& resourceLoader, ResourceStreamer& resourceStreamer
+)
+    : m_resourceLoader{resourceLoader}
+    , m_resourceStreamer{resourceStreamer} {
 }
 
 template<typename T>
     requires IsResource<T>
 std::shared_ptr<T> ResourceCache::resource(ResourceID id) {
-    auto it = m_resourceMap.find(id);
-    std::shared_ptr<T> stored;
-    if (it != m_resourceMap.end() &&
-        (stored = std::get<std::weak_ptr<T>>(it->second).lock())) {
+    std::unique_lock lock{m_mutex};
+    if (auto stored = findLoaded<T>(id)) {
         // Resource present
+        ++m_stats.hits;
+        retain(id, stored);
         return stored;
+    } else if (auto it = m_streamedMap.find(id); it != m_streamedMap.end()) {
+        // Resource is being streamed in, wait for it instead of loading it twice
+        // (textures are finalized by the main thread even if this is not it)
+        ++m_stats.hits;
+        auto streamed = std::get<Streamed<T>>(it->second);
+        lock.unlock();
+        streamed->wait();
+        lock.lock();
+        it = m_streamedMap.find(id);
+        if (it != m_streamedMap.end()) {
+            auto* tracked = std::get_if<Streamed<T>>(&it->second);
+            if (tracked && *tracked == streamed) {
+                m_streamedMap.erase(it);
+            }
+        }
+        auto made = streamed->result();
+        insertLoaded(id, made);
+        return made;
     } else {
         // Resource never accessed before or it has expired
+        ++m_stats.misses;
+        lock.unlock();
         auto made = std::make_shared<T>(m_resourceLoader.load<T>(id));
-        m_resourceMap.insert_or_assign(id, made);
+        lock.lock();
+        if (auto stored = findLoaded<T>(id)) {
+            // Another thread has loaded the resource in the meantime
+            retain(id, stored);
+            return stored;
+        }
+        insertLoaded(id, made);
         return made;
     }
 }
 
+template<typename T>
+    requires IsResource<T>
+ResourceFuture<T> ResourceCache::resourceAsync(ResourceID id) {
+    std::lock_guard lock{m_mutex};
+    if (auto stored = findLoaded<T>(id)) {
+        // Resource present
+        ++m_stats.hits;
+        retain(id, stored);
+        return ResourceFuture<T>{
+            std::make_shared<details::StreamedResource<T>>(std::move(stored))
+        };
+    } else if (auto it = m_streamedMap.find(id); it != m_streamedMap.end()) {
+        // Resource is already being streamed in
+        ++m_stats.hits;
+        return ResourceFuture<T>{std::get<Streamed<T>>(it->second)};
+    } else {
+        // Start streaming in the resource
+        ++m_stats.misses;
+        auto streamed = m_resourceStreamer.stream<T>(id);
+        m_streamedMap.emplace(id, streamed);
+        return ResourceFuture<T>{std::move(streamed)};
+    }
+}
+
+void ResourceCache::finishStreamedLoads() {
+    ProfilerZone zone{"ResourceCache::finishStreamedLoads"};
+    std::vector<StrongResource> evicted; // Released after the lock is released
+    std::lock_guard lock{m_mutex};
+    std::erase_if(m_streamedMap, [&](const auto& pair) {
+        return std::visit(
+            [&](const auto& streamed) {
+                if (!streamed->finalize()) {
+                    return false; // Still being decoded
+                }
+                if (streamed->isFinished()) {
+                    insertLoaded(pair.first, streamed->result());
+                }
+                return true;
+            },
+            pair.second
+        );
+    });
+    evicted.swap(m_evicted);
+}
+
+void ResourceCache::setBudget(size_t bytes) {
+    std::lock_guard lock{m_mutex};
+    m_budget = bytes;
+    evictOverBudget();
+}
+
+size_t ResourceCache::budget() const {
+    std::lock_guard lock{m_mutex};
+    return m_budget;
+}
+
+void ResourceCache::releaseRetained() {
+    std::list<Retained> retained; // Released after the lock is released
+    std::vector<StrongResource> evicted;
+    std::lock_guard lock{m_mutex};
+    retained.swap(m_retained);
+    evicted.swap(m_evicted);
+    m_retainedIndex.clear();
+    m_stats.retainedCount = 0;
+    m_stats.retainedBytes = 0;
+}
+
+ResourceCacheStats ResourceCache::stats() const {
+    std::lock_guard lock{m_mutex};
+    return m_stats;
+}
+
+template<typename T>
+std::shared_ptr<T> ResourceCache::findLoaded(ResourceID id) const {
+    auto it = m_resourceMap.find(id);
+    return it != m_resourceMap.end() ? std::get<std::weak_ptr<T>>(it->second).lock()
+                                     : nullptr;
+}
+
+void ResourceCache::insertLoaded(ResourceID id, StrongResource resource) {
+    std::visit(
+        [&](const auto& res) { m_resourceMap.insert_or_assign(id, res); }, resource
+    );
+    retain(id, std::move(resource));
+}
+
+void ResourceCache::retain(ResourceID id, StrongResource resource) {
+    if (auto it = m_retainedIndex.find(id); it != m_retainedIndex.end()) {
+        // Already retained, just mark it as the most recently used
+        m_retained.splice(m_retained.begin(), m_retained, it->second);
+        return;
+    }
+    size_t bytes = std::visit([](const auto& res) { return resourceSize(*res); }, resource);
+    m_retained.emplace_front(id, std::move(resource), bytes);
+    m_retainedIndex.emplace(id, m_retained.begin());
+    ++m_stats.retainedCount;
+    m_stats.retainedBytes += bytes;
+    evictOverBudget();
+}
+
+void ResourceCache::evictOverBudget() {
+    while (m_stats.retainedBytes > m_budget) {
+        auto& lru = m_retained.back();
+        m_retainedIndex.erase(lru.id);
+        --m_stats.retainedCount;
+        m_stats.retainedBytes -= lru.bytes;
+        ++m_stats.evictions;
+        // Textures must not be released outside of the main thread
+        m_evicted.push_back(std::move(lru.resource));
+        m_retained.pop_back();
+    }
+}
+
 template<typename T>
 using Shrd = std::shared_ptr<T>;
 
 template Shrd<DataResource> ResourceCache::resource<DataResource>(ResourceID id);
 template Shrd<TextureShaped> ResourceCache::resource<TextureShaped>(ResourceID id);
 
+template<typename T>
+using Future = ResourceFuture<T>;
+
+template Future<DataResource> ResourceCache::resourceAsync<DataResource>(ResourceID id);
+template Future<TextureShaped> ResourceCache::resourceAsync<TextureShaped>(ResourceID id);
+
 } // namespace re
@@ -2,31 +2,111 @@
  *  @author    Dubsky Tomas
  */
 #pragma once
+#include <list>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
+#include <RealEngine/resources/ResourceFuture.hpp>
 #include <RealEngine/resources/ResourceLoader.hpp>
+#include <RealEngine/resources/ResourceStreamer.hpp>
 
 namespace re {
 
+/**
+ * @brief Counts accesses to ResourceCache
+ */
+struct ResourceCacheStats {
+    size_t hits          = 0; ///< Requests served without loading the resource
+    size_t misses        = 0; ///< Requests that had to load the resource
+    size_t evictions     = 0; ///< Resources dropped from the retention list
+    size_t retainedCount = 0; ///< Resources currently kept alive by the cache
+    size_t retainedBytes = 0; ///< Approximate size of the retained resources
+};
+
 /**
  * @brief Caches resources to avoid duplication
+ * @details Resources that are being streamed in are tracked too so that
+ *          repeated requests share a single load.
+ * @details Recently used resources are kept alive (in LRU order) even if
+ *          there are no other references to them, until their total size
+ *          exceeds the retention budget.
+ * @note    The cache is thread-safe, but textures must still be requested
+ *          from the main thread as they are GPU objects. The exception are
+ *          textures that are being streamed in - other threads block until
+ *          the main thread finalizes them in finishStreamedLoads().
  */
 class ResourceCache {
 public:
-    explicit ResourceCache(const ResourceLoader& resourceLoader);
+    static constexpr size_t k_defaultBudget = 64 * 1024 * 1024;
+
+    ResourceCache(const ResourceLoader& resourceLoader, ResourceStreamer& resourceStreamer);
 
     template<typename T>
         requires IsResource<T>
     std::shared_ptr<T> resource(ResourceID id);
 
+    template<typename T>
+        requires IsResource<T>
+    ResourceFuture<T> resourceAsync(ResourceID id);
+
+    /**
+     * @brief Finalizes streamed resources which have been decoded
+     * @details Must be called from the main thread
+     */
+    void finishStreamedLoads();
+
+    /**
+     * @brief Sets the maximum total size of retained resources
+     * @details Resources over the budget are released immediately.
+     */
+    void setBudget(size_t bytes);
+
+    size_t budget() const;
+
+    /**
+     * @brief Releases all retained resources, they stay cached if referenced elsewhere
+     * @details Must be called from the main thread
+     */
+    void releaseRetained();
+
+    ResourceCacheStats stats() const;
+
 private:
     const ResourceLoader& m_resourceLoader;
+    ResourceStreamer& m_resourceStreamer;
+    mutable std::mutex m_mutex;
 
     using WeakResource =
         std::variant<std::weak_ptr<DataResource>, std::weak_ptr<TextureShaped>>;
     std::unordered_map<ResourceID, WeakResource> m_resourceMap;
+
+    using StrongResource =
+        std::variant<std::shared_ptr<DataResource>, std::shared_ptr<TextureShaped>>;
+    struct Retained {
+        ResourceID id;
+        StrongResource resource;
+        size_t bytes;
+    };
+    std::list<Retained> m_retained; ///< Most recently used first
+    std::unordered_map<ResourceID, std::list<Retained>::iterator> m_retainedIndex;
+    std::vector<StrongResource> m_evicted; ///< Released on the main thread
+    size_t m_budget = k_defaultBudget;
+    ResourceCacheStats m_stats{};
+
+    template<typename T>
+    using Streamed = std::shared_ptr<details::StreamedResource<T>>;
+    using StreamedResource = std::variant<Streamed<DataResource>, Streamed<TextureShaped>>;
+    std::unordered_map<ResourceID, StreamedResource> m_streamedMap;
+
+    template<typename T>
+    std::shared_ptr<T> findLoaded(ResourceID id) const;
+
+    void insertLoaded(ResourceID id, StrongResource resource);
+    void retain(ResourceID id, StrongResource resource);
+    void evictOverBudget();
 };
 
 } // namespace re
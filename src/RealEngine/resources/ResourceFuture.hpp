@@ -0,0 +1,222 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <concepts>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include <RealEngine/resources/ResourceLoader.hpp>
+
+namespace re {
+
+namespace details {
+
+/**
+ * @brief Is the thread that initializes static objects (the main thread)
+ * @details GPU-backed streamed resources are finalized on it.
+ */
+inline const std::thread::id k_mainThread = std::this_thread::get_id();
+
+/**
+ * @brief Checks whether the calling thread is the main thread
+ */
+inline bool isMainThread() {
+    return std::this_thread::get_id() == k_mainThread;
+}
+
+/**
+ * @brief Is the shared state of a resource that is being streamed in
+ */
+template<typename T>
+    requires IsResource<T>
+class StreamedResource {
+public:
+    enum class State : uint8_t {
+        Pending,  ///< Waiting for or being decoded
+        Decoded,  ///< Decoded, waiting for finalization on the main thread
+        Finished, ///< The resource is ready
+        Failed    ///< Loading has failed, the exception is stored
+    };
+
+    /**
+     * @brief Finalization of GPU-backed resources (textures) creates GPU objects
+     *        and is done on the main thread only
+     */
+    static constexpr bool k_finalizedOnMainThread =
+        !std::same_as<T, DecodedResource<T>>;
+
+    /**
+     * @brief Constructs resource that is going to be decoded by decode()
+     */
+    StreamedResource(const ResourceLoader& loader, ResourceID id)
+        : m_loader(&loader)
+        , m_id(id) {}
+
+    /**
+     * @brief Constructs already finished resource
+     */
+    explicit StreamedResource(std::shared_ptr<T> finished)
+        : m_state(State::Finished)
+        , m_result(std::move(finished)) {
+        m_decodingClaimed.test_and_set();
+    }
+
+    /**
+     * @brief   Decodes the resource unless its decoding has already started
+     * @details Called by the streaming job and by wait(), whichever comes
+     *          first decodes the resource.
+     */
+    void decode() {
+        if (m_decodingClaimed.test_and_set(std::memory_order::acq_rel)) {
+            return;
+        }
+        try {
+            m_decoded = m_loader->decode<T>(m_id);
+            m_state.store(State::Decoded, std::memory_order::release);
+        } catch (...) {
+            m_exception = std::current_exception();
+            m_state.store(State::Failed, std::memory_order::release);
+        }
+        m_state.notify_all();
+    }
+
+    /**
+     * @brief   Creates the final resource from the decoded one if it is decoded
+     * @details Must be called from the main thread if k_finalizedOnMainThread
+     * @return  True if the resource is finished or failed
+     */
+    bool finalize() {
+        assert(
+            (!k_finalizedOnMainThread || isMainThread()) &&
+            "GPU-backed resources must be finalized on the main thread"
+        );
+        std::lock_guard lock{m_finalizationMutex};
+        switch (m_state.load(std::memory_order::acquire)) {
+        case State::Pending: return false;
+        case State::Decoded:
+            try {
+                if constexpr (std::same_as<T, DecodedResource<T>>) {
+                    m_result = std::make_shared<T>(std::move(*m_decoded));
+                } else {
+                    m_result = std::make_shared<T>(*m_decoded);
+                }
+                m_state.store(State::Finished, std::memory_order::release);
+            } catch (...) {
+                m_exception = std::current_exception();
+                m_state.store(State::Failed, std::memory_order::release);
+            }
+            m_decoded.reset();
+            m_state.notify_all();
+            return true;
+        default: return true;
+        }
+    }
+
+    /**
+     * @brief   Blocks until the resource is finished or failed
+     * @details If the streaming job has not started yet, the resource is
+     *          decoded by the calling thread. This way, a job that waits for
+     *          the resource cannot block the worker that would decode it.
+     * @details The resource is finalized by the calling thread unless it is
+     *          GPU-backed and the caller is not the main thread. The caller
+     *          then waits until the main thread finalizes it (see
+     *          ResourceCache::finishStreamedLoads()), so the main thread must
+     *          not wait for the caller meanwhile.
+     */
+    void wait() {
+        decode();
+        m_state.wait(State::Pending, std::memory_order::acquire);
+        if (!k_finalizedOnMainThread || isMainThread()) {
+            finalize();
+        } else {
+            m_state.wait(State::Decoded, std::memory_order::acquire);
+        }
+    }
+
+    /**
+     * @brief Gets the resource if it is finished, rethrows if it failed
+     */
+    std::shared_ptr<T> result() const {
+        if (m_state.load(std::memory_order::acquire) == State::Failed) {
+            std::rethrow_exception(m_exception);
+        }
+        return m_result;
+    }
+
+    bool isFinished() const {
+        return m_state.load(std::memory_order::acquire) == State::Finished;
+    }
+
+private:
+    const ResourceLoader* m_loader{};
+    ResourceID m_id{0, ""};
+    std::atomic_flag m_decodingClaimed;
+    std::atomic<State> m_state = State::Pending;
+    std::mutex m_finalizationMutex;
+    std::optional<DecodedResource<T>> m_decoded;
+    std::shared_ptr<T> m_result;
+    std::exception_ptr m_exception;
+};
+
+} // namespace details
+
+/**
+ * @brief   Is a handle to a resource that is being loaded asynchronously
+ * @details The resource is read and decoded by a worker thread. GPU objects
+ *          (e.g. textures) are then created on the main thread at the
+ *          beginning of the next frame.
+ * @note    The handle may be used from any thread. Waiting for a texture
+ *          from another thread blocks until the main thread finalizes it.
+ * @see     ResourceManager::textureAsync(), ResourceManager::dataAsync()
+ */
+template<typename T>
+    requires IsResource<T>
+class ResourceFuture {
+public:
+    /**
+     * @brief Constructs an empty handle that refers to no resource
+     */
+    ResourceFuture() = default;
+
+    explicit ResourceFuture(std::shared_ptr<details::StreamedResource<T>> streamed)
+        : m_streamed(std::move(streamed)) {}
+
+    /**
+     * @brief Checks whether the handle refers to a resource
+     */
+    bool valid() const { return m_streamed != nullptr; }
+
+    /**
+     * @brief Checks whether the resource has been loaded
+     */
+    bool isReady() const { return m_streamed && m_streamed->isFinished(); }
+
+    /**
+     * @brief   Gets the resource without blocking
+     * @return  The resource or nullptr if it has not been loaded yet
+     * @throws  Rethrows the exception if the loading has failed
+     */
+    std::shared_ptr<T> get() const { return m_streamed->result(); }
+
+    /**
+     * @brief   Blocks until the resource is loaded and gets it
+     * @details Must not be called for a texture from another thread while
+     *          the main thread waits for that thread.
+     * @throws  Rethrows the exception if the loading has failed
+     */
+    std::shared_ptr<T> wait() const {
+        m_streamed->wait();
+        return m_streamed->result();
+    }
+
+private:
+    std::shared_ptr<details::StreamedResource<T>> m_streamed;
+};
+
+} // namespace re
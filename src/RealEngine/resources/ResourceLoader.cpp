@@ -1,27 +1,112 @@
 ﻿/**
  *  @author    Dubsky Tomas
  */
+#include <RealEngine/program/Profiler.hpp>
+#include <RealEngine/resources/MappedFile.hpp>
 #include <RealEngine/resources/ResourceLoader.hpp>
 #include <RealEngine/utility/BuildType.hpp>
 
+#if RE_BUILDING_FOR_RELEASE
+#    include <mutex>
+
+#    include <bit7z/bitmemextractor.hpp>
+// bit7z may include Windows.h which introduces macros...
+#    ifdef MemoryBarrier
+#        undef MemoryBarrier
+#    endif
+
+#    include <RealEngine/resources/PackageReader.hpp>
+#endif // RE_BUILDING_FOR_RELEASE
+
 namespace re {
 
+#if RE_BUILDING_FOR_RELEASE
+struct ResourceLoader::SevenZipPackage {
+    explicit SevenZipPackage(std::span<const unsigned char> package)
+        : compressedPackage(package.begin(), package.end()) {}
+
+    std::vector<unsigned char> compressedPackage;
+    bit7z::Bit7zLibrary lib{default7ZipSharedLibLocation()};
+    bit7z::BitMemExtractor extractor{lib, bit7z::BitFormat::SevenZip};
+    [[no_unique_address]] struct Empty { // A hack to set password before
+    } _empty = [&]() {                   // inputArchive is constructed.
+        extractor.setPassword(k_packageKey); // BitMemExtractor has no constructor
+        return Empty{};                      // that would set the password.
+    }();
+    bit7z::BitInputArchive inputArchive{extractor, compressedPackage};
+    std::mutex mutex; ///< The archive does not support concurrent extraction
+};
+#endif // RE_BUILDING_FOR_RELEASE
+
+ResourceLoader::ResourceLoader() {
+#if RE_BUILDING_FOR_RELEASE
+    MappedFile file{k_packageName};
+    if (PackageReader::isNativePackage(file.bytes())) {
+        m_package = std::make_shared<PackageReader>(std::move(file));
+    } else {
+        m_sevenZipPackage = std::make_unique<SevenZipPackage>(file.bytes());
+    }
+#endif // RE_BUILDING_FOR_RELEASE
+}
+
+ResourceLoader::~ResourceLoader() = default;
+
 template<>
-DataResource ResourceLoader::load<DataResource>(ResourceID id) const {
+DataResource ResourceLoader::decode<DataResource>(ResourceID id) const {
+    ProfilerZone zone{"ResourceLoader::decode"};
 #if RE_BUILDING_FOR_DEBUG
     // Load the file directly
     return readBinaryFile(id.path());
 #elif RE_BUILDING_FOR_RELEASE // ^^^ RE_BUILDING_FOR_DEBUG
     // Extract from package
+    if (m_package) {
+        return m_package->extract(id);
+    }
     std::vector<unsigned char> rval;
-    m_inputArchive.extractTo(rval, id);
+    std::lock_guard lock{m_sevenZipPackage->mutex};
+    m_sevenZipPackage->inputArchive.extractTo(rval, id);
     return rval;
 #endif                        // RE_BUILDING_FOR_RELEASE
 }
 
+template<>
+TextureContainer ResourceLoader::decode<TextureShaped>(ResourceID id) const {
+    ProfilerZone zone{"ResourceLoader::decodeTexture"};
+    auto encoded = decode<DataResource>(id);
+    if (TextureContainer::isTextureContainer(encoded)) {
+        return TextureContainer{std::move(encoded)};
+    }
+    return TextureContainer{PNGLoader::load(encoded)};
+}
+
+DataView ResourceLoader::view(ResourceID id) const {
+#if RE_BUILDING_FOR_RELEASE
+    if (m_package) {
+        package::Entry entry = m_package->entry(id);
+        if (entry.compression == package::Compression::Stored) {
+            // View the package directly, it is kept mapped by the view
+            return DataView{std::as_bytes(m_package->storedBytes(entry)), m_package};
+        }
+    }
+    // The data have to be extracted, the view owns them
+    auto extracted = std::make_shared<const DataResource>(decode<DataResource>(id));
+    return DataView{std::as_bytes(std::span{*extracted}), extracted};
+#else  // ^^^ RE_BUILDING_FOR_RELEASE / vvv !RE_BUILDING_FOR_RELEASE
+    // Map the file directly
+    auto mapped = std::make_shared<const MappedFile>(id.path());
+    return DataView{std::as_bytes(mapped->bytes()), mapped};
+#endif // !RE_BUILDING_FOR_RELEASE
+}
+
+template<>
+DataResource ResourceLoader::load<DataResource>(ResourceID id) const {
+    return decode<DataResource>(id);
+}
+
 template<>
 TextureShaped ResourceLoader::load<TextureShaped>(ResourceID id) const {
-    return TextureShaped{PNGLoader::load(load<DataResource>(id))};
+    ProfilerZone zone{"ResourceLoader::loadTexture"};
+    return TextureShaped{decode<TextureShaped>(id)};
 }
 
 } // namespace re
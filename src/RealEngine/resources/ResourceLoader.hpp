@@ -2,19 +2,16 @@
  *  @author    Dubsky Tomas
  */
 #pragma once
+#include <memory>
 #include <string>
 #include <vector>
 
-#include <bit7z/bitmemextractor.hpp>
-// bit7z may include Windows.h which introduces macros...
-#ifdef MemoryBarrier
-#    undef MemoryBarrier
-#endif
-
 #include <RealEngine/graphics/textures/TextureShaped.hpp>
+#include <RealEngine/resources/DataView.hpp>
 #include <RealEngine/resources/FileIO.hpp>
 #include <RealEngine/resources/PackageConstants.hpp>
 #include <RealEngine/resources/ResourceID.hpp>
+#include <RealEngine/resources/TextureContainer.hpp>
 
 namespace re {
 
@@ -35,15 +32,35 @@ template<typename T>
 concept IsResource = details::IsAnyOf<T, DataResource, TextureShaped>;
 
 /**
- * @brief   Loads files from compressed 'encrypted' package.
+ * @brief   Is the CPU-side form of a resource
+ * @details Textures are decoded to texels (PNGs) or read as they are
+ *          (texture containers), data need no further processing.
+ */
+template<typename T>
+    requires IsResource<T>
+using DecodedResource =
+    std::conditional_t<std::same_as<T, TextureShaped>, TextureContainer, T>;
+
+class PackageReader;
+
+/**
+ * @brief   Loads files from the package.
  * @details Resource more less means a file in this context.
+ * @details The package is either in the engine-native format, which is
+ *          memory-mapped and decompressed per resource, or in the legacy
+ *          compressed 'encrypted' 7z format, which has to be loaded whole.
+ *          The format is detected when the package is opened.
  * @details In debug build, reads the original files instead to allow quick
  *          iteration without needing to run rerun packaging everytime.
  * @see     ResourcePackager executable (CMake target)
  */
 class ResourceLoader {
 public:
-    ResourceLoader() = default;
+    ResourceLoader();
+    ~ResourceLoader();
+
+    ResourceLoader(const ResourceLoader&)            = delete; ///< Noncopyable
+    ResourceLoader& operator=(const ResourceLoader&) = delete; ///< Noncopyable
 
     /**
      * @brief Loads resource from package (Release) or directly from file (Debug)
@@ -53,17 +70,29 @@ public:
         requires IsResource<T>
     T load(ResourceID id) const;
 
+    /**
+     * @brief Loads the CPU-side form of resource (Release: from package)
+     * @note  Unlike load(), this is thread-safe since it creates no GPU objects.
+     * @tparam T Any resource type
+     */
+    template<typename T>
+        requires IsResource<T>
+    DecodedResource<T> decode(ResourceID id) const;
+
+    /**
+     * @brief   Gets a view of the bytes of a resource without copying them if possible
+     * @details Uncompressed entries of the native package (Release) and files
+     *          (Debug) are mapped to memory and viewed directly. Other entries
+     *          are extracted and the view owns them.
+     * @note    This is thread-safe.
+     */
+    DataView view(ResourceID id) const;
+
 private:
 #if RE_BUILDING_FOR_RELEASE
-    std::vector<unsigned char> m_compressedPackage = readBinaryFile(k_packageName);
-    bit7z::Bit7zLibrary m_lib{default7ZipSharedLibLocation()};
-    bit7z::BitMemExtractor m_extractor{m_lib, bit7z::BitFormat::SevenZip};
-    [[no_unique_address]] struct Empty {       // A hack to set password before
-    } _empty = [&]() {                         // m_inputArchive is constructed.
-        m_extractor.setPassword(k_packageKey); // BitMemExtractor has no constructor
-        return Empty{};                        // that would set the password.
-    }();
-    bit7z::BitInputArchive m_inputArchive{m_extractor, m_compressedPackage};
+    std::shared_ptr<PackageReader> m_package; ///< Engine-native package
+    struct SevenZipPackage;
+    std::unique_ptr<SevenZipPackage> m_sevenZipPackage; ///< Legacy 7z package
 #endif // RE_BUILDING_FOR_RELEASE
 };
 
@@ -13,6 +13,10 @@ TextureShaped ResourceManager::textureUnmanaged(ResourceID id) {
     return s_resourceLoader.load<TextureShaped>(id);
 }
 
+ResourceFuture<TextureShaped> ResourceManager::textureAsync(ResourceID id) {
+    return s_resourceCache.resourceAsync<TextureShaped>(id);
+}
+
 std::shared_ptr<DataResource> ResourceManager::data(ResourceID id) {
     return s_resourceCache.resource<DataResource>(id);
 }
@@ -21,4 +25,28 @@ std::vector<unsigned char> ResourceManager::dataUnmanaged(ResourceID id) {
     return s_resourceLoader.load<std::vector<unsigned char>>(id);
 }
 
+ResourceFuture<DataResource> ResourceManager::dataAsync(ResourceID id) {
+    return s_resourceCache.resourceAsync<DataResource>(id);
+}
+
+DataView ResourceManager::dataView(ResourceID id) {
+    return s_resourceLoader.view(id);
+}
+
+void ResourceManager::setCacheBudget(size_t bytes) {
+    s_resourceCache.setBudget(bytes);
+}
+
+ResourceCacheStats ResourceManager::cacheStats() {
+    return s_resourceCache.stats();
+}
+
+void ResourceManager::finishStreamedLoads() {
+    s_resourceCache.finishStreamedLoads();
+}
+
+void ResourceManager::releaseRetainedResources() {
+    s_resourceCache.releaseRetained();
+}
+
 } // namespace re
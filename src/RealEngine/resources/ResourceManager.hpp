@@ -3,15 +3,22 @@
  */
 #pragma once
 #include <RealEngine/resources/ResourceCache.hpp>
+#include <RealEngine/resources/ResourceFuture.hpp>
 #include <RealEngine/resources/ResourceLoader.hpp>
+#include <RealEngine/resources/ResourceStreamer.hpp>
 
 namespace re {
 
 /**
  * @brief Ensures that there is at most one copy of shared resources.
  *
- * Resources managed by resource manager: textures (only so far).
- * Resources are released once there are no references to them.
+ * Resources managed by resource manager: textures and data.
+ * Recently used resources are retained within a memory budget,
+ * other resources are released once there are no references to them.
+ *
+ * Resources can also be loaded asynchronously. Reading and decoding is then
+ * done by worker threads and the main thread only creates the GPU objects,
+ * at the beginning of the next frame.
  *
  * @note This class is also accessible through re::RM abbreviation.
  */
@@ -30,6 +37,13 @@ public:
      */
     static TextureShaped textureUnmanaged(ResourceID id);
 
+    /**
+     * @brief   Loads a managed texture asynchronously
+     * @details Requesting a texture that is already being loaded does not
+     *          load it again - the returned handles share the single load.
+     */
+    static ResourceFuture<TextureShaped> textureAsync(ResourceID id);
+
     /**
      * @brief Loads managed data resource.
      */
@@ -42,9 +56,49 @@ public:
      */
     static DataResource dataUnmanaged(ResourceID id);
 
+    /**
+     * @brief   Loads managed data resource asynchronously
+     * @details Requesting data that are already being loaded does not
+     *          load them again - the returned handles share the single load.
+     */
+    static ResourceFuture<DataResource> dataAsync(ResourceID id);
+
+    /**
+     * @brief   Gets a view of data without copying them to heap (if possible)
+     * @details Uncompressed data are viewed directly in the mapped package
+     *          (or file in Debug build), which stays mapped while the view exists.
+     *          Views are not cached as they are cheap to create.
+     */
+    static DataView dataView(ResourceID id);
+
+    /**
+     * @brief   Sets how much memory may be occupied by recently used resources
+     *          that would be released otherwise
+     * @details Zero budget releases resources as soon as they are not referenced.
+     */
+    static void setCacheBudget(size_t bytes);
+
+    /**
+     * @brief Gets counters of cache hits, misses and evictions
+     */
+    static ResourceCacheStats cacheStats();
+
 private:
+    friend class MainProgram;
+
+    /**
+     * @brief Finishes asynchronously loaded resources, called once per frame
+     */
+    static void finishStreamedLoads();
+
+    /**
+     * @brief Releases retained resources, called before the renderer is destroyed
+     */
+    static void releaseRetainedResources();
+
     static inline ResourceLoader s_resourceLoader{};
-    static inline ResourceCache s_resourceCache{s_resourceLoader};
+    static inline ResourceStreamer s_resourceStreamer{s_resourceLoader};
+    static inline ResourceCache s_resourceCache{s_resourceLoader, s_resourceStreamer};
 };
 
 /**
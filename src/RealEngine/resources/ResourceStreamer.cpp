@@ -0,0 +1,12 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <RealEngine/resources/ResourceStreamer.hpp>
+
+namespace re {
+
+ResourceStreamer::ResourceStreamer(const ResourceLoader& resourceLoader)
+    : m_resourceLoader(resourceLoader) {
+}
+
+} // namespace re
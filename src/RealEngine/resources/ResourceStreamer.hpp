@@ -0,0 +1,41 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <RealEngine/jobs/JobSystem.hpp>
+#include <RealEngine/resources/ResourceFuture.hpp>
+
+namespace re {
+
+/**
+ * @brief   Reads and decodes resources on the workers of the job system
+ * @details The jobs are executed by JobSystem::shared(), which finishes them
+ *          before it is destroyed.
+ */
+class ResourceStreamer {
+public:
+    explicit ResourceStreamer(const ResourceLoader& resourceLoader);
+
+    ResourceStreamer(const ResourceStreamer&)            = delete; ///< Noncopyable
+    ResourceStreamer& operator=(const ResourceStreamer&) = delete; ///< Noncopyable
+
+    /**
+     * @brief   Starts decoding the resource on a worker thread
+     * @details A thread that waits for the resource before the job starts
+     *          decodes it itself (see details::StreamedResource::wait()).
+     */
+    template<typename T>
+        requires IsResource<T>
+    std::shared_ptr<details::StreamedResource<T>> stream(ResourceID id) {
+        auto streamed = std::make_shared<details::StreamedResource<T>>(
+            m_resourceLoader, id
+        );
+        JobSystem::shared().schedule([streamed] { streamed->decode(); });
+        return streamed;
+    }
+
+private:
+    const ResourceLoader& m_resourceLoader;
+};
+
+} // namespace re
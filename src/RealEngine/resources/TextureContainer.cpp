@@ -0,0 +1,134 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <format>
+
+#include <glm/common.hpp>
+
+#include <RealEngine/resources/TextureContainer.hpp>
+#include <RealEngine/utility/Error.hpp>
+
+namespace re {
+
+namespace {
+
+size_t levelSize(glm::uvec2 dims, size_t texelSize) {
+    return static_cast<size_t>(dims.x) * dims.y * texelSize;
+}
+
+glm::uvec2 nextLevelDims(glm::uvec2 dims) {
+    return glm::max(dims / 2u, glm::uvec2{1u});
+}
+
+/**
+ * @brief Appends next mip level of the RGBA8 level at srcOffset (box filtered)
+ */
+void appendNextLevel(
+    std::vector<unsigned char>& out, size_t srcOffset, glm::uvec2 srcDims
+) {
+    constexpr size_t k_texelSize = 4;
+    glm::uvec2 dstDims           = nextLevelDims(srcDims);
+    size_t dstOffset             = out.size();
+    out.resize(dstOffset + levelSize(dstDims, k_texelSize));
+    const unsigned char* src = out.data() + srcOffset;
+    unsigned char* dst       = out.data() + dstOffset;
+    auto srcTexel = [&](unsigned int x, unsigned int y) {
+        x = std::min(x, srcDims.x - 1);
+        y = std::min(y, srcDims.y - 1);
+        return &src[(static_cast<size_t>(y) * srcDims.x + x) * k_texelSize];
+    };
+    for (unsigned int y = 0; y < dstDims.y; ++y) {
+        for (unsigned int x = 0; x < dstDims.x; ++x) {
+            const unsigned char* a = srcTexel(x * 2, y * 2);
+            const unsigned char* b = srcTexel(x * 2 + 1, y * 2);
+            const unsigned char* c = srcTexel(x * 2, y * 2 + 1);
+            const unsigned char* d = srcTexel(x * 2 + 1, y * 2 + 1);
+            for (size_t i = 0; i < k_texelSize; ++i) {
+                int sum = a[i] + b[i] + c[i] + d[i];
+                *dst++  = static_cast<unsigned char>((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+} // namespace
+
+bool TextureContainer::isTextureContainer(std::span<const unsigned char> bytes) {
+    return bytes.size() >= sizeof(Header) &&
+           std::memcmp(bytes.data(), k_magic.data(), k_magic.size()) == 0;
+}
+
+std::vector<unsigned char> TextureContainer::encode(
+    const PNGLoader::PNGData& png, bool generateMips
+) {
+    Header header{
+        .mipLevelCount = generateMips ? fullMipLevelCount(png.dims) : 1u,
+        .dims          = png.dims,
+        .shape         = png.shape
+    };
+    if (png.texels.size() != levelSize(png.dims, k_texelSize)) {
+        throw Exception{"Texels do not match dimensions of the texture"};
+    }
+
+    // Write the header and the first level
+    std::vector<unsigned char> out(sizeof(Header));
+    std::memcpy(out.data(), &header, sizeof(Header));
+    out.insert(out.end(), png.texels.begin(), png.texels.end());
+
+    // Generate the other levels
+    size_t srcOffset = sizeof(Header);
+    glm::uvec2 dims  = png.dims;
+    for (uint32_t level = 1; level < header.mipLevelCount; ++level) {
+        size_t nextOffset = out.size();
+        appendNextLevel(out, srcOffset, dims);
+        srcOffset = nextOffset;
+        dims      = nextLevelDims(dims);
+    }
+    return out;
+}
+
+uint32_t TextureContainer::fullMipLevelCount(glm::uvec2 dims) {
+    return static_cast<uint32_t>(std::bit_width(std::max(dims.x, dims.y)));
+}
+
+TextureContainer::TextureContainer(std::vector<unsigned char>&& encoded)
+    : m_bytes(std::move(encoded))
+    , m_texelsOffset(sizeof(Header)) {
+    if (!isTextureContainer(m_bytes)) {
+        throw Exception{"Not a texture container"};
+    }
+    std::memcpy(&m_header, m_bytes.data(), sizeof(Header));
+    if (m_header.version != k_version) {
+        throw Exception{std::format(
+            "Unsupported texture container version {} (expected {})",
+            m_header.version, k_version
+        )};
+    }
+    if (m_header.format != TexelFormat::RGBA8) {
+        throw Exception{"Unsupported texel format of texture container"};
+    }
+    if (m_header.mipLevelCount == 0 ||
+        m_header.mipLevelCount > fullMipLevelCount(m_header.dims)) {
+        throw Exception{"Invalid mip level count of texture container"};
+    }
+    // Check that all levels are present
+    size_t expectedSize = 0;
+    glm::uvec2 dims     = m_header.dims;
+    for (uint32_t level = 0; level < m_header.mipLevelCount; ++level) {
+        expectedSize += levelSize(dims, k_texelSize);
+        dims = nextLevelDims(dims);
+    }
+    if (m_bytes.size() - sizeof(Header) != expectedSize) {
+        throw Exception{"Texture container is truncated"};
+    }
+}
+
+TextureContainer::TextureContainer(PNGLoader::PNGData&& png)
+    : m_bytes(std::move(png.texels))
+    , m_header{.dims = png.dims, .shape = png.shape} {
+}
+
+} // namespace re
@@ -0,0 +1,106 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include <RealEngine/graphics/textures/TextureShape.hpp>
+#include <RealEngine/resources/PNGLoader.hpp>
+
+namespace re {
+
+/**
+ * @brief   Holds texels of a texture in the form that can be copied
+ *          directly to the GPU, along with its shape
+ * @details The container is either read from the engine's texture container
+ *          format (which is produced by ResourcePackager from PNGs), or made
+ *          from a decoded PNG.
+ * @details The format consists of a header followed by all mip levels of the
+ *          texture, largest first, tightly packed. All values are stored in
+ *          little-endian byte order.
+ */
+class TextureContainer {
+public:
+    static_assert(
+        std::endian::native == std::endian::little,
+        "Texture containers are stored little-endian and require a little-endian host"
+    );
+
+    static constexpr std::array<char, 4> k_magic{'r', 'e', 'T', 'X'};
+    static constexpr uint32_t k_version = 1;
+
+    /**
+     * @brief Specifies the format of the stored texels
+     */
+    enum class TexelFormat : uint32_t {
+        RGBA8 = 0 ///< 8-bit unsigned normalized red, green, blue and alpha
+    };
+
+    struct Header {
+        std::array<char, 4> magic = k_magic;
+        uint32_t version          = k_version;
+        TexelFormat format        = TexelFormat::RGBA8;
+        uint32_t mipLevelCount    = 1;
+        glm::uvec2 dims{};
+        TextureShape shape{};
+    };
+    static_assert(sizeof(Header) == 48);
+
+    /**
+     * @brief Checks whether the bytes begin with the texture container magic
+     */
+    static bool isTextureContainer(std::span<const unsigned char> bytes);
+
+    /**
+     * @brief Encodes decoded PNG into the texture container format
+     * @param generateMips Generates full mip chain (by box filtering) if true
+     */
+    static std::vector<unsigned char> encode(
+        const PNGLoader::PNGData& png, bool generateMips
+    );
+
+    /**
+     * @brief Gets number of levels of full mip chain of texture with given dimensions
+     */
+    static uint32_t fullMipLevelCount(glm::uvec2 dims);
+
+    /**
+     * @brief   Reads texture container from its encoded form
+     * @details The encoded bytes are moved into the container, which owns
+     *          them. Note that the bytes have been copied out of the package
+     *          by ResourceLoader.
+     * @throws  Throws if the bytes do not form a valid texture container
+     */
+    explicit TextureContainer(std::vector<unsigned char>&& encoded);
+
+    /**
+     * @brief Makes container with the single mip level from decoded PNG
+     */
+    explicit TextureContainer(PNGLoader::PNGData&& png);
+
+    glm::uvec2 dims() const { return m_header.dims; }
+    uint32_t mipLevelCount() const { return m_header.mipLevelCount; }
+    const TextureShape& shape() const { return m_header.shape; }
+
+    /**
+     * @brief Gets texels of all mip levels, largest first, tightly packed
+     */
+    std::span<const unsigned char> texels() const {
+        return std::span{m_bytes}.subspan(m_texelsOffset);
+    }
+
+private:
+    static constexpr size_t k_texelSize = 4; ///< Of the only supported format
+
+    std::vector<unsigned char> m_bytes;
+    size_t m_texelsOffset = 0;
+    Header m_header{};
+};
+
+} // namespace re
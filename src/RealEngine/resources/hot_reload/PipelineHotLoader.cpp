@@ -1,12 +1,14 @@
 /**
  *  @author    Dubsky Tomas
  */
+#include <cassert>
 #include <set>
+#include <thread>
 
 #include <filewatch/FileWatch.hpp>
 
 #include <RealEngine/graphics/pipelines/Pipeline.hpp>
-#include <RealEngine/graphics/synchronization/DoubleBuffered.hpp>
+#include <RealEngine/graphics/synchronization/MultiBuffered.hpp>
 #include <RealEngine/program/MainProgram.hpp>
 #include <RealEngine/resources/FileIO.hpp>
 #include <RealEngine/resources/hot_reload/PipelineHotLoader.hpp>
@@ -85,9 +87,21 @@ struct PipelineHotLoader::Impl {
               }
           } {}
 
+    /**
+     * @brief The register is not synchronized, pipelines must be created and
+     *        destroyed on the main thread (the one that constructed this)
+     */
+    void assertMainThread() const {
+        assert(
+            std::this_thread::get_id() == mainThread &&
+            "Pipelines must be created and destroyed on the main thread"
+        );
+    }
+
     DeletionQueue& deletionQueue;
+    std::thread::id mainThread = std::this_thread::get_id();
     std::vector<PipelineReloadInfo> pipelineRegister;
-    FrameDoubleBuffered<std::set<std::string>> pathsToReload;
+    FrameMultiBuffered<std::set<std::string>> pathsToReload;
     std::string recompileShadersCommand;
     std::string binaryDir;
     filewatch::FileWatch<std::string> sourceDirWatch;
@@ -159,6 +173,7 @@ void PipelineHotLoader::registerPipelineForReloading(
 ) {
     if (!m_impl)
         return;
+    m_impl->assertMainThread();
     m_impl->pipelineRegister.emplace_back(initial, createInfo, srcs);
 }
 
@@ -168,6 +183,7 @@ void PipelineHotLoader::registerPipelineForReloading(
 ) {
     if (!m_impl)
         return;
+    m_impl->assertMainThread();
     m_impl->pipelineRegister.emplace_back(initial, createInfo, srcs);
 }
 
@@ -176,6 +192,7 @@ void PipelineHotLoader::moveRegisteredPipeline(
 ) {
     if (!m_impl)
         return;
+    m_impl->assertMainThread();
     auto it = m_impl->findInRegister(original);
     if (it != m_impl->pipelineRegister.end()) {
         it->updateTargetPipeline(moved);
@@ -243,6 +260,7 @@ size_t PipelineHotLoader::reloadChangedPipelines(
 void PipelineHotLoader::unregisterPipelineForReloading(vk::Pipeline& pipeline) {
     if (!m_impl)
         return;
+    m_impl->assertMainThread();
     auto it = m_impl->findInRegister(pipeline);
     if (it != m_impl->pipelineRegister.end()) {
         m_impl->pipelineRegister.erase(it); // O(n) shift
@@ -15,6 +15,8 @@ namespace re {
 /**
  * @brief   Allows recompilation of Vulkan pipelines during runtime (present in
  *          debug builds only)
+ * @note    Not thread-safe, pipelines must be created and destroyed on the
+ *          main thread.
  */
 class PipelineHotLoader {
 public:
@@ -42,6 +42,38 @@ public:
 
     virtual ~Room() = default;
 
+    /**
+     * @brief Prepares the room for a session that is going to start
+     *
+     * This is called on a worker thread when a transition to this room is
+     * scheduled, while the current room keeps running. The transition happens
+     * only once the preload has completed. Do the CPU-side loading here so
+     * that sessionStart() does not stall the program. The preload may:
+     * - read and decode resources: ResourceManager::data(), dataView(),
+     *   dataUnmanaged() and any CPU-only processing of their contents,
+     * - start streaming textures via ResourceManager::textureAsync() and
+     *   keep the futures, sessionStart() then waits for them (the textures
+     *   are created on the main thread).
+     *
+     * The preload must not:
+     * - create or destroy any GPU objects (textures, buffers, pipelines,
+     *   fonts...), nor call ResourceManager::texture() or textureUnmanaged().
+     *   Create them in sessionStart() instead.
+     * - wait for futures of textures, they are finalized by the main thread
+     *   which may be waiting for the preload.
+     * - record or submit any commands, nor touch FrameMultiBuffered objects,
+     *   the renderer or the window (the same as for a pipelined step()).
+     *
+     * Further notes:
+     * - The preload may be followed by another preload instead of
+     *   sessionStart() if a transition to another room is scheduled meanwhile.
+     * - If the room is re-entered (it is the current room), the preload
+     *   is called synchronously by the thread that scheduled the transition.
+     *
+     * @param args      Arguments that the session is going to start with
+     */
+    virtual void preload(const RoomTransitionArguments& args) {}
+
     /**
      * @brief Informs the room that a new session happens inside it.
      * @param args      Arguments to initialize the session. These are
@@ -62,6 +94,23 @@ public:
      *
      * This function is called at fixed rate per second.
      * The rate can be changed via Synchronizer.
+     *
+     * If RoomDisplaySettings::pipelinedStepping is enabled, the last step
+     * before each frame runs on a separate thread while the frame is rendered
+     * on the main thread. The step and render() then share the data as follows:
+     * - The step writes its results to StepDoubleBuffered objects via write(),
+     *   render() may only use read(), i.e. results of the previous step.
+     *   The rendered frame thus lags one step behind the simulation.
+     * - The step must not touch FrameMultiBuffered objects, the renderer
+     *   or the window, nor record or submit any commands (this includes
+     *   creating buffers or textures with initial data or initial layout
+     *   and waiting for uploads).
+     * - The step may destroy GPU objects, they are deleted on the step timeline.
+     * - The step may read input, schedule room transition or exit and change
+     *   display settings. Changed display settings are adopted once the step
+     *   finishes.
+     * - Any other data that are shared by step() and render() must be
+     *   synchronized by the room.
      */
     virtual void step() = 0;
 
@@ -98,6 +147,16 @@ public:
         const WindowFlags& oldFlags, const WindowFlags& newFlags
     ) {}
 
+    /**
+     * @brief   Used to notify that the step rate has been adapted
+     * @details This happens only if the room's catch-up policy allows adaptive
+     *          step rate (see Synchronizer::CatchUpPolicy). The callback is
+     *          invoked before the steps of the frame.
+     */
+    virtual void stepRateChangedCallback(
+        unsigned int oldStepsPerSecond, unsigned int newStepsPerSecond
+    ) {}
+
     /**
      * @brief Gets a proxy that can be used to read/modify
      * many parameters and variables of the RealEngine
@@ -5,6 +5,7 @@
 #include <span>
 
 #include <RealEngine/graphics/output_control/RenderPass.hpp>
+#include <RealEngine/program/Synchronizer.hpp>
 
 namespace re {
 
@@ -85,6 +86,18 @@ struct RoomDisplaySettings {
      * within this room
      */
     uint32_t imGuiSubpassIndex = k_notUsingImGui;
+    /**
+     * @brief Runs the last step of each frame on a separate thread, concurrently
+     * with rendering of the frame
+     * @details This hides the cost of the step behind the recording of the frame
+     * but the step has to follow the rules described at Room::step().
+     */
+    bool pipelinedStepping = false;
+    /**
+     * @brief Specifies how steps catch up with the time after slow frames
+     * @details The default policy does not limit the steps.
+     */
+    Synchronizer::CatchUpPolicy stepCatchUp{};
 };
 
 } // namespace re
@@ -13,6 +13,15 @@ Room* RoomManager::currentRoom() const {
     return m_currentRoom;
 }
 
+Room* RoomManager::room(size_t name) const {
+    for (const auto& room : m_rooms) {
+        if (room->name() == name) {
+            return room.get();
+        }
+    }
+    return nullptr;
+}
+
 Room* RoomManager::goToRoom(size_t name, const RoomTransitionArguments& args) {
     for (auto& room : m_rooms) { // If name is valid
         if (room->name() == name) {
@@ -32,6 +32,12 @@ public:
      */
     Room* currentRoom() const;
 
+    /**
+     * @brief Gets the room with the name
+     * @return Pointer to the room, nullptr if there is no room with the name
+     */
+    Room* room(size_t name) const;
+
     /**
      * @brief Changes the current room.
      * @details Session of current room is ended and then session
@@ -47,6 +47,10 @@ glm::ivec2 RoomToEngineAccess::cursorRel() const {
     return m_inputManager.cursorRel();
 }
 
+std::span<const InputEvent> RoomToEngineAccess::inputEvents() const {
+    return m_inputManager.events();
+}
+
 #pragma endregion
 
 #pragma region Synchronizer
@@ -67,6 +71,34 @@ Synchronizer::Duration RoomToEngineAccess::maxFrameTime() const {
     return m_synchronizer.maxFrameTime();
 }
 
+void RoomToEngineAccess::setFramePacing(Synchronizer::FramePacing framePacing) {
+    m_synchronizer.setFramePacing(framePacing);
+}
+
+Synchronizer::Duration RoomToEngineAccess::inputToSubmitLatency() const {
+    return m_synchronizer.inputToSubmitLatency();
+}
+
+Synchronizer::Duration RoomToEngineAccess::gpuWaitTime() const {
+    return m_synchronizer.gpuWaitTime();
+}
+
+unsigned int RoomToEngineAccess::stepsPerSecond() const {
+    return m_synchronizer.stepsPerSecond();
+}
+
+Synchronizer::Overruns RoomToEngineAccess::stepOverruns() const {
+    return m_synchronizer.overruns();
+}
+
+uint64_t RoomToEngineAccess::totalDroppedSteps() const {
+    return m_synchronizer.totalDroppedSteps();
+}
+
+const FrameStatistics& RoomToEngineAccess::frameStatistics() const {
+    return m_synchronizer.frameStatistics();
+}
+
 #pragma endregion
 
 #pragma region Window
@@ -171,6 +203,14 @@ void RoomToEngineAccess::mainRenderPassEnd() {
     m_renderer.mainRenderPassEnd();
 }
 
+void RoomToEngineAccess::captureFrame(std::string pathPNG) {
+    m_renderer.captureFrame(std::move(pathPNG));
+}
+
+bool RoomToEngineAccess::isHeadless() const {
+    return m_renderer.isHeadless();
+}
+
 #pragma endregion
 
 } // namespace re
@@ -2,6 +2,7 @@
  *  @author    Dubsky Tomas
  */
 #pragma once
+#include <RealEngine/jobs/JobSystem.hpp>
 #include <RealEngine/program/Synchronizer.hpp>
 #include <RealEngine/renderer/VulkanRenderer.hpp>
 #include <RealEngine/rooms/RoomManager.hpp>
@@ -27,14 +28,15 @@ public:
     RoomToEngineAccess(
         MainProgram& mainProgram, InputManager& inputManager,
         Synchronizer& synchronizer, Window& window, VulkanRenderer& renderer,
-        RoomManager& roomManager
+        RoomManager& roomManager, JobSystem& jobSystem
     )
         : m_mainProgram{mainProgram}
         , m_inputManager{inputManager}
         , m_synchronizer{synchronizer}
         , m_window{window}
         , m_renderer{renderer}
-        , m_roomManager{roomManager} {}
+        , m_roomManager{roomManager}
+        , m_jobSystem{jobSystem} {}
 
 #pragma region MainProgram
 
@@ -82,6 +84,11 @@ public:
      */
     glm::ivec2 cursorRel() const;
 
+    /**
+     * @copydoc InputManager::events
+     */
+    std::span<const InputEvent> inputEvents() const;
+
 #pragma endregion
 
 #pragma region Synchronizer
@@ -106,6 +113,41 @@ public:
      */
     Synchronizer::Duration maxFrameTime() const;
 
+    /**
+     * @copydoc Synchronizer::setFramePacing
+     */
+    void setFramePacing(Synchronizer::FramePacing framePacing);
+
+    /**
+     * @copydoc Synchronizer::inputToSubmitLatency
+     */
+    Synchronizer::Duration inputToSubmitLatency() const;
+
+    /**
+     * @copydoc Synchronizer::gpuWaitTime
+     */
+    Synchronizer::Duration gpuWaitTime() const;
+
+    /**
+     * @copydoc Synchronizer::stepsPerSecond
+     */
+    unsigned int stepsPerSecond() const;
+
+    /**
+     * @copydoc Synchronizer::overruns
+     */
+    Synchronizer::Overruns stepOverruns() const;
+
+    /**
+     * @copydoc Synchronizer::totalDroppedSteps
+     */
+    uint64_t totalDroppedSteps() const;
+
+    /**
+     * @copydoc Synchronizer::frameStatistics
+     */
+    const FrameStatistics& frameStatistics() const;
+
 #pragma endregion
 
 #pragma region Window
@@ -219,6 +261,25 @@ public:
      */
     void mainRenderPassEnd();
 
+    /**
+     * @copydoc VulkanRenderer::captureFrame
+     */
+    void captureFrame(std::string pathPNG);
+
+    /**
+     * @copydoc VulkanRenderer::isHeadless
+     */
+    bool isHeadless() const;
+
+#pragma endregion
+
+#pragma region JobSystem
+
+    /**
+     * @brief Gets the job system that can be used to execute work in parallel
+     */
+    JobSystem& jobSystem() { return m_jobSystem; }
+
 #pragma endregion
 
 private:
@@ -228,6 +289,7 @@ private:
     Window& m_window;
     VulkanRenderer& m_renderer;
     RoomManager& m_roomManager;
+    JobSystem& m_jobSystem;
 };
 
 } // namespace re
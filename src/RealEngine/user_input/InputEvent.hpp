@@ -0,0 +1,43 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+#include <glm/vec2.hpp>
+
+#include <RealEngine/user_input/Key.hpp>
+
+namespace re {
+
+enum class InputEventType : uint8_t {
+    Press,     ///< The key has been pressed (times-times)
+    Release,   ///< The key has been released
+    CursorMove ///< The cursor has moved
+};
+
+/**
+ * @brief Is a single change of input, timestamped when the program received it
+ */
+struct InputEvent {
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    TimePoint time{};
+    InputEventType type{};
+    Key key = Key::UnknownKey; ///< Of Press and Release
+    int times{};               ///< Of Press (clicks or steps of the wheel)
+    glm::ivec2 cursorAbs{};    ///< Of CursorMove
+    glm::ivec2 cursorRel{};    ///< Of CursorMove
+
+    /**
+     * @brief Checks whether the event comes from the mouse
+     */
+    bool isMouseEvent() const {
+        return type == InputEventType::CursorMove ||
+               (static_cast<int>(key) >= static_cast<int>(Key::LMB) &&
+                static_cast<int>(key) <= static_cast<int>(Key::RMW));
+    }
+};
+
+} // namespace re
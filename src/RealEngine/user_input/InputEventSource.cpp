@@ -0,0 +1,84 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <cstdlib>
+
+#include <SDL_events.h>
+
+#include <RealEngine/user_input/InputEventSource.hpp>
+
+namespace re {
+
+InputEventSource::InputEventSource() {
+    SDL_AddEventWatch(&eventWatch, this);
+}
+
+InputEventSource::~InputEventSource() {
+    SDL_DelEventWatch(&eventWatch, this);
+}
+
+void InputEventSource::popUntil(
+    InputEvent::TimePoint time, std::vector<InputEvent>& events
+) {
+    for (const auto* event = m_queue.front(); event && event->time <= time;
+         event             = m_queue.front()) {
+        events.push_back(*m_queue.pop());
+    }
+}
+
+void InputEventSource::discard() {
+    while (m_queue.pop()) {}
+}
+
+int InputEventSource::eventWatch(void* userData, SDL_Event* evnt) {
+    auto& source = *static_cast<InputEventSource*>(userData);
+    InputEvent event{.time = InputEvent::TimePoint::clock::now()};
+    switch (evnt->type) {
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+        if (evnt->key.repeat == 0) {
+            event.type  = evnt->type == SDL_KEYDOWN ? InputEventType::Press
+                                                    : InputEventType::Release;
+            event.key   = toKey(evnt->key.keysym.sym);
+            event.times = 1;
+            source.push(event);
+        }
+        break;
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        event.type  = evnt->type == SDL_MOUSEBUTTONDOWN ? InputEventType::Press
+                                                        : InputEventType::Release;
+        event.key   = toKey(evnt->button.button);
+        event.times = evnt->button.clicks;
+        source.push(event);
+        break;
+    case SDL_MOUSEMOTION:
+        event.type      = InputEventType::CursorMove;
+        event.cursorAbs = {evnt->motion.x, evnt->motion.y};
+        event.cursorRel = {evnt->motion.xrel, evnt->motion.yrel};
+        source.push(event);
+        break;
+    case SDL_MOUSEWHEEL:
+        event.type = InputEventType::Press;
+        if (evnt->wheel.y != 0) {
+            event.key   = (evnt->wheel.y > 0) ? (Key::UMW) : (Key::DMW);
+            event.times = std::abs(evnt->wheel.y);
+            source.push(event);
+        }
+        if (evnt->wheel.x != 0) {
+            event.key   = (evnt->wheel.x > 0) ? (Key::RMW) : (Key::LMW);
+            event.times = std::abs(evnt->wheel.x);
+            source.push(event);
+        }
+        break;
+    }
+    return 0; // The return value of event watches is ignored
+}
+
+void InputEventSource::push(const InputEvent& event) {
+    if (!m_queue.push(event)) {
+        m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace re
@@ -0,0 +1,70 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <RealEngine/user_input/InputEvent.hpp>
+#include <RealEngine/utility/SPSCQueue.hpp>
+
+union SDL_Event;
+
+namespace re {
+
+/**
+ * @brief   Collects timestamped input events from SDL into a lock-free queue
+ * @details Events are translated and timestamped by an SDL event watch, i.e.
+ *          as soon as SDL pumps them (which SDL allows only in the thread that
+ *          has created the window). SDL calls event watches under its lock
+ *          so pushes never overlap, even if another thread pushes an event.
+ *          The thread that samples input of steps is the single consumer.
+ * @details Cursor positions are in SDL's window coordinates (Y points down).
+ * @note    Events are dropped if the queue is full (which counts them).
+ */
+class InputEventSource {
+public:
+    static constexpr size_t k_capacity = 4096;
+
+    /**
+     * @brief Starts collecting events (adds the event watch)
+     */
+    InputEventSource();
+
+    InputEventSource(const InputEventSource&)            = delete; ///< Noncopyable
+    InputEventSource& operator=(const InputEventSource&) = delete; ///< Noncopyable
+
+    InputEventSource(InputEventSource&&)            = delete;      ///< Nonmovable
+    InputEventSource& operator=(InputEventSource&&) = delete;      ///< Nonmovable
+
+    ~InputEventSource();
+
+    /**
+     * @brief   Moves events that have been received until the time to the vector
+     * @details Events are appended in the order they have been received.
+     */
+    void popUntil(InputEvent::TimePoint time, std::vector<InputEvent>& events);
+
+    /**
+     * @brief Discards all events that have been received so far
+     */
+    void discard();
+
+    /**
+     * @brief Gets number of events that have been dropped because the queue was full
+     */
+    uint64_t droppedCount() const {
+        return m_droppedCount.load(std::memory_order_relaxed);
+    }
+
+private:
+    static int eventWatch(void* userData, SDL_Event* event);
+
+    void push(const InputEvent& event);
+
+    SPSCQueue<InputEvent, k_capacity> m_queue;
+    std::atomic<uint64_t> m_droppedCount = 0;
+};
+
+} // namespace re
@@ -0,0 +1,100 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <cstring>
+#include <format>
+#include <iterator>
+
+#include <RealEngine/user_input/InputLog.hpp>
+#include <RealEngine/utility/Error.hpp>
+
+namespace re {
+
+InputLogWriter::InputLogWriter(const std::filesystem::path& path)
+    : m_file{path, std::ios::binary | std::ios::trunc} {
+    InputLogFormat::Header header{};
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!m_file) {
+        throw Exception{std::format("Could not open input log {}", path.string())};
+    }
+}
+
+void InputLogWriter::writeStep(const InputManager& inputManager) {
+    auto changed     = inputManager.changedKeys();
+    auto cursorAbs   = inputManager.cursorAbs();
+    auto cursorRel   = inputManager.cursorRel();
+    bool cursorMoved = cursorAbs != m_cursorAbs || cursorRel != glm::ivec2{};
+
+    // Assemble the record first so that it is written at once
+    std::vector<char> record;
+    record.reserve(
+        3 + changed.size() * InputLogFormat::k_keyRecordSize +
+        (cursorMoved ? sizeof(InputLogFormat::CursorRecord) : 0)
+    );
+    auto append = [&](const auto& value) {
+        const auto* bytes = reinterpret_cast<const char*>(&value);
+        record.insert(record.end(), bytes, bytes + sizeof(value));
+    };
+    append(static_cast<uint8_t>(cursorMoved ? InputLogFormat::k_cursorMovedFlag : 0));
+    append(static_cast<uint16_t>(changed.size()));
+    for (const auto& keyState : changed) {
+        append(static_cast<uint16_t>(keyState.key));
+        append(static_cast<int32_t>(keyState.state));
+    }
+    if (cursorMoved) {
+        append(InputLogFormat::CursorRecord{.abs = cursorAbs, .rel = cursorRel});
+        m_cursorAbs = cursorAbs;
+    }
+    m_file.write(record.data(), static_cast<std::streamsize>(record.size()));
+    m_stepCount++;
+}
+
+InputLogReader::InputLogReader(const std::filesystem::path& path) {
+    std::ifstream file{path, std::ios::binary};
+    if (!file) {
+        throw Exception{std::format("Could not open input log {}", path.string())};
+    }
+    m_bytes.assign(
+        std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}
+    );
+    auto header = read<InputLogFormat::Header>();
+    if (header.magic != InputLogFormat::k_magic ||
+        header.version != InputLogFormat::k_version) {
+        throw Exception{std::format("{} is not a compatible input log", path.string())};
+    }
+}
+
+bool InputLogReader::readStep(InputManager& inputManager) {
+    if (m_pos == m_bytes.size()) {
+        return false;
+    }
+    auto flags    = read<uint8_t>();
+    auto keyCount = read<uint16_t>();
+    for (uint16_t i = 0; i < keyCount; ++i) {
+        auto key   = read<uint16_t>();
+        auto state = read<int32_t>();
+        if (key >= static_cast<uint16_t>(Key::NumberOfKeys)) {
+            throw Exception{"Input log contains an unknown key"};
+        }
+        inputManager.setState({.key = static_cast<Key>(key), .state = state});
+    }
+    if (flags & InputLogFormat::k_cursorMovedFlag) {
+        auto cursor = read<InputLogFormat::CursorRecord>();
+        inputManager.setCursor(cursor.abs, cursor.rel);
+    }
+    m_stepCount++;
+    return true;
+}
+
+template<typename T>
+T InputLogReader::read() {
+    if (m_bytes.size() - m_pos < sizeof(T)) {
+        throw Exception{"Input log is truncated"};
+    }
+    T value;
+    std::memcpy(&value, &m_bytes[m_pos], sizeof(T));
+    m_pos += sizeof(T);
+    return value;
+}
+
+} // namespace re
@@ -0,0 +1,119 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include <RealEngine/user_input/InputManager.hpp>
+
+namespace re {
+
+/**
+ * @brief   Describes the binary log of input of steps
+ * @details The log consists of a header and records of consecutive steps.
+ *          A record begins with flags and the number of changed keys, then
+ *          the changed keys follow and then the cursor (only if it has moved).
+ *          A step without input takes 3 bytes. All values are stored
+ *          in little-endian byte order.
+ */
+struct InputLogFormat {
+    static_assert(
+        std::endian::native == std::endian::little,
+        "Input logs are read and written in-place and require a little-endian host"
+    );
+
+    static constexpr std::array<char, 4> k_magic{'r', 'e', 'I', 'L'};
+    static constexpr uint32_t k_version = 1;
+
+    struct Header {
+        std::array<char, 4> magic = k_magic;
+        uint32_t version          = k_version;
+    };
+    static_assert(sizeof(Header) == 8);
+
+    static constexpr uint8_t k_cursorMovedFlag = 1;
+
+    /**
+     * @brief A changed key is stored as uint16_t key followed by int32_t state
+     */
+    static constexpr size_t k_keyRecordSize = sizeof(uint16_t) + sizeof(int32_t);
+
+    struct CursorRecord {
+        glm::ivec2 abs{};
+        glm::ivec2 rel{};
+    };
+    static_assert(sizeof(CursorRecord) == 16);
+};
+
+/**
+ * @brief Writes input of steps into a log that can be replayed by InputLogReader
+ */
+class InputLogWriter {
+public:
+    /**
+     * @brief   Creates the log (or truncates it)
+     * @throws  Throws if the file cannot be opened
+     */
+    explicit InputLogWriter(const std::filesystem::path& path);
+
+    /**
+     * @brief   Appends input of the step that has just been sampled
+     * @details Must be called after the input of each step has been sampled,
+     *          i.e. after InputManager::step() and all presses and releases.
+     */
+    void writeStep(const InputManager& inputManager);
+
+    /**
+     * @brief Gets number of steps written so far
+     */
+    uint64_t stepCount() const { return m_stepCount; }
+
+private:
+    std::ofstream m_file;
+    glm::ivec2 m_cursorAbs{};
+    uint64_t m_stepCount = 0;
+};
+
+/**
+ * @brief Replays input of steps recorded by InputLogWriter
+ * @details The whole log is read when constructed so that the replay
+ *          performs no I/O.
+ */
+class InputLogReader {
+public:
+    /**
+     * @brief   Reads the log
+     * @throws  Throws if the file cannot be read or is not an input log
+     */
+    explicit InputLogReader(const std::filesystem::path& path);
+
+    /**
+     * @brief   Applies input of the next recorded step
+     * @details Must be called right after InputManager::step().
+     * @return  False if the log has ended (the input manager is not changed)
+     * @throws  Throws if the record is truncated
+     */
+    bool readStep(InputManager& inputManager);
+
+    /**
+     * @brief Gets number of steps replayed so far
+     */
+    uint64_t stepCount() const { return m_stepCount; }
+
+private:
+    template<typename T>
+    T read();
+
+    std::vector<unsigned char> m_bytes;
+    size_t m_pos         = 0;
+    uint64_t m_stepCount = 0;
+};
+
+} // namespace re
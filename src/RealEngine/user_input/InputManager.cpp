@@ -42,6 +42,7 @@ glm::ivec2 InputManager::cursorRel() const {
 
 void InputManager::step() {
     m_cursorRel = glm::ivec2(0, 0);
+    m_events.clear();
     release(Key::UMW);
     release(Key::DMW);
     release(Key::LMW);
@@ -58,6 +59,7 @@ void InputManager::step() {
     m_stateMap[cast(Key::AnyKey)]     = longestHeld > 0;
     m_stateMapPrev[cast(Key::NoKey)]  = m_stateMap[cast(Key::NoKey)];
     m_stateMap[cast(Key::NoKey)]      = longestHeld == 0;
+    m_stateMapStepped                 = m_stateMap;
 }
 
 void InputManager::setCursor(glm::ivec2 abs, glm::ivec2 rel) {
@@ -75,4 +77,32 @@ void InputManager::release(Key key) {
     m_stateMap[cast(key)] = 0;
 }
 
+void InputManager::apply(const InputEvent& event) {
+    switch (event.type) {
+    case InputEventType::Press:   press(event.key, event.times); break;
+    case InputEventType::Release: release(event.key); break;
+    case InputEventType::CursorMove:
+        // All movements since the previous step are accumulated
+        m_cursorAbs = event.cursorAbs;
+        m_cursorRel += event.cursorRel;
+        break;
+    }
+    m_events.push_back(event);
+}
+
+std::vector<InputManager::KeyState> InputManager::changedKeys() const {
+    std::vector<KeyState> changed;
+    for (int i = 0; i < cast(Key::NumberOfKeys); ++i) {
+        if (m_stateMap[i] != m_stateMapStepped[i]) {
+            changed.emplace_back(static_cast<Key>(i), m_stateMap[i]);
+        }
+    }
+    return changed;
+}
+
+void InputManager::setState(KeyState keyState) {
+    assert(!isSpecialKey(keyState.key) || keyState.key == Key::UnknownKey);
+    m_stateMap[cast(keyState.key)] = keyState.state;
+}
+
 } // namespace re
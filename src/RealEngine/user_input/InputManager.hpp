@@ -3,9 +3,12 @@
  */
 #pragma once
 #include <array>
+#include <span>
+#include <vector>
 
 #include <glm/vec2.hpp>
 
+#include <RealEngine/user_input/InputEvent.hpp>
 #include <RealEngine/user_input/Key.hpp>
 
 namespace re {
@@ -47,6 +50,13 @@ public:
      */
     glm::ivec2 cursorRel() const;
 
+    /**
+     * @brief Gets events that have arrived right before this step, oldest first
+     * @details Unlike the state, the events keep every movement of the cursor
+     * and the time of each change within the step.
+     */
+    std::span<const InputEvent> events() const { return m_events; }
+
 #pragma region AccessForMainProgram
 
     void step();
@@ -54,6 +64,28 @@ public:
     void press(Key key, int times = 1);
     void release(Key key);
 
+    /**
+     * @brief Applies the event to the state and appends it to events()
+     */
+    void apply(const InputEvent& event);
+
+    struct KeyState {
+        Key key{};
+        int state{}; ///< @see isDown()
+    };
+
+    /**
+     * @brief Gets keys whose states have been changed by press() or release()
+     * since the last step()
+     * @details Together with the cursor, this is all input of the step.
+     */
+    std::vector<KeyState> changedKeys() const;
+
+    /**
+     * @brief Overwrites state of the key, this is used to replay changedKeys()
+     */
+    void setState(KeyState keyState);
+
 #pragma endregion
 
 private:
@@ -67,9 +99,12 @@ private:
     using StateMap = std::array<int, static_cast<size_t>(Key::NumberOfKeys)>;
     mutable StateMap m_stateMap{};
     mutable StateMap m_stateMapPrev{};
+    StateMap m_stateMapStepped{}; ///< The state right after the last step()
 
     glm::ivec2 m_cursorAbs = glm::ivec2(0u, 0u);
     glm::ivec2 m_cursorRel = glm::ivec2(0u, 0u);
+
+    std::vector<InputEvent> m_events; ///< Of the current step
 };
 
 } // namespace re
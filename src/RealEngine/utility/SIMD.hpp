@@ -0,0 +1,13 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+
+/**
+ * @brief RE_SIMD_SSE2 is defined (and the intrinsics are included)
+ *        if SSE2 is available on the target
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define RE_SIMD_SSE2
+#    include <emmintrin.h>
+#endif
@@ -0,0 +1,70 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+namespace re {
+
+/**
+ * @brief   Is a lock-free bounded queue for a single producer and a single consumer
+ * @details push() may only be called by the producer thread, front() and pop()
+ *          only by the consumer thread. Neither ever blocks.
+ * @tparam  k_capacity Maximum number of elements, must be a power of two
+ */
+template<typename T, size_t k_capacity>
+class SPSCQueue {
+    static_assert(k_capacity > 0 && (k_capacity & (k_capacity - 1)) == 0);
+
+public:
+    /**
+     * @brief Appends the element (producer only)
+     * @return False if the queue is full (the element is not appended)
+     */
+    bool push(const T& element) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == k_capacity) {
+            return false;
+        }
+        m_slots[tail % k_capacity] = element;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Gets the oldest element without removing it (consumer only)
+     * @return Pointer to the element or nullptr if the queue is empty
+     */
+    const T* front() const {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &m_slots[head % k_capacity];
+    }
+
+    /**
+     * @brief Removes the oldest element (consumer only)
+     * @return The element or nullopt if the queue is empty
+     */
+    std::optional<T> pop() {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+        std::optional<T> element = m_slots[head % k_capacity];
+        m_head.store(head + 1, std::memory_order_release);
+        return element;
+    }
+
+private:
+    std::array<T, k_capacity> m_slots{};
+    // The indices only grow, they are on separate cache lines to avoid false sharing
+    alignas(64) std::atomic<size_t> m_head = 0; ///< Written by the consumer
+    alignas(64) std::atomic<size_t> m_tail = 0; ///< Written by the producer
+};
+
+} // namespace re
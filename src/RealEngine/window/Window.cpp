@@ -13,7 +13,7 @@ namespace re {
 
 Window::Window(const WindowSettings& settings, const std::string& title)
     : WindowSettings{settings}
-    , m_subsystems{}
+    , m_subsystems{m_flags.headless}
     , m_SDLwindow{createSDLWindow()}
     , m_windowTitle{title} {
 
@@ -35,6 +35,11 @@ bool Window::passSDLEvent(const SDL_Event& evnt) {
     }
 }
 
+bool Window::isCapturedByImGui(const InputEvent& event) const {
+    auto& io = ImGui::GetIO();
+    return event.isMouseEvent() ? io.WantCaptureMouse : io.WantCaptureKeyboard;
+}
+
 void Window::setFullscreen(bool fullscreen, bool save) {
     m_flags.fullscreen = fullscreen;
     SDL_SetWindowFullscreen(sdlWindow(), (fullscreen) ? SDL_WINDOW_FULLSCREEN : 0);
@@ -78,7 +83,8 @@ void Window::setDims(glm::ivec2 newDims, bool save) {
 
 Window::SDL_WindowRAII Window::createSDLWindow() {
     // Prepare window flags
-    Uint32 SDL_flags = SDL_WINDOW_VULKAN;
+    // Headless windows are never rendered to (see VulkanInitInfo::headlessExtent)
+    Uint32 SDL_flags = m_flags.headless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_VULKAN;
     if (m_flags.invisible)
         SDL_flags |= SDL_WINDOW_HIDDEN;
     if (m_flags.fullscreen)
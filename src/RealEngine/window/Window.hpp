@@ -8,6 +8,7 @@
 #include <SDL_video.h>
 #include <glm/vec2.hpp>
 
+#include <RealEngine/user_input/InputEvent.hpp>
 #include <RealEngine/utility/UniqueCPtr.hpp>
 #include <RealEngine/window/WindowSettings.hpp>
 #include <RealEngine/window/WindowSubsystems.hpp>
@@ -42,6 +43,11 @@ public:
      */
     bool passSDLEvent(const SDL_Event& evnt);
 
+    /**
+     * @brief Checks whether ImGui wants to consume the input event
+     */
+    bool isCapturedByImGui(const InputEvent& event) const;
+
     /**
      * @brief Switches fullscreen on and off.
      * @param fullscreen True if the window should be fullscreen, false otherwise.
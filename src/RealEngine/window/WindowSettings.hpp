@@ -19,6 +19,10 @@ struct WindowFlags {
 
     unsigned char invisible : 1 {}, fullscreen : 1 {}, borderless : 1 {},
         vSync : 1 {};
+    /**
+     * @brief The window exists only nominally, there is no display (not saved)
+     */
+    unsigned char headless : 1 {};
 };
 
 /**
@@ -14,8 +14,12 @@
 
 namespace re {
 
-WindowSubsystems::WindowSubsystems() {
+WindowSubsystems::WindowSubsystems(bool headless /* = false*/) {
     // SDL2
+    if (headless) {
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+        SDL_SetHint(SDL_HINT_AUDIODRIVER, "dummy");
+    }
     if (auto err = SDL_Init(SDL_INIT_EVERYTHING)) {
         const char* errorStr = SDL_GetError();
         error(errorStr);
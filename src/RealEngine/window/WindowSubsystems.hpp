@@ -45,9 +45,11 @@ class WindowSubsystems {
 public:
     /**
      * @brief Initializes RealEngine's subsystems
+     * @param headless Uses dummy video and audio drivers so that no display
+     * (or audio device) is required
      * @throws std::runtime_error When a system failed to initialize.
      */
-    WindowSubsystems();
+    explicit WindowSubsystems(bool headless = false);
 
     WindowSubsystems(const WindowSubsystems&) = delete; ///< Noncopyable
     WindowSubsystems& operator=(const WindowSubsystems&) = delete; ///< Noncopyable
@@ -0,0 +1,88 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <RealEngine/resources/FastPNGDecoder.hpp>
+#include <RealEngine/resources/FileIO.hpp>
+#include <RealEngine/resources/PNGLoader.hpp>
+
+using namespace re;
+
+namespace {
+
+bool operator==(const TextureShape& a, const TextureShape& b) {
+    return a.subimageDims == b.subimageDims && a.pivot == b.pivot &&
+           a.subimagesSpritesCount == b.subimagesSpritesCount;
+}
+
+/**
+ * @brief Decodes the PNG by both decoders and compares the results
+ * @return True if the results are identical
+ */
+bool check(const std::filesystem::path& path) {
+    std::vector<unsigned char> encoded = readBinaryFile(path);
+    bool handledByFast = FastPNGDecoder::decode(encoded).has_value();
+
+    PNGLoader::setDecoder(PNGLoader::Decoder::Fast);
+    PNGLoader::PNGData fast = PNGLoader::load(encoded);
+    PNGLoader::setDecoder(PNGLoader::Decoder::Lodepng);
+    PNGLoader::PNGData lodepng = PNGLoader::load(encoded);
+
+    std::string mismatch;
+    if (fast.dims != lodepng.dims) {
+        mismatch = "dimensions differ";
+    } else if (fast.texels != lodepng.texels) {
+        mismatch = "texels differ";
+    } else if (!(fast.shape == lodepng.shape)) {
+        mismatch = "texture shapes differ";
+    }
+    std::cout << path.generic_string() << ": "
+              << (mismatch.empty() ? "OK" : "MISMATCH, " + mismatch)
+              << (handledByFast ? "" : " (declined by the fast decoder)") << '\n';
+    return mismatch.empty();
+}
+
+} // namespace
+
+/**
+ * @brief Checks that FastPNGDecoder decodes PNGs identically to lodepng
+ * @details Accepts PNG files and directories that are searched recursively
+ *          for PNG files. Returns nonzero if any of the PNGs are decoded
+ *          differently or cannot be decoded.
+ */
+int main(int argc, char* argv[]) {
+    std::vector<std::filesystem::path> pngs;
+    for (int i = 1; i < argc; ++i) {
+        std::filesystem::path arg{argv[i]};
+        if (std::filesystem::is_directory(arg)) {
+            for (const auto& entry :
+                 std::filesystem::recursive_directory_iterator{arg}) {
+                if (entry.is_regular_file() && entry.path().extension() == ".png") {
+                    pngs.push_back(entry.path());
+                }
+            }
+        } else {
+            pngs.push_back(arg);
+        }
+    }
+    if (pngs.empty()) {
+        std::cerr << "Usage: PNGDecoderCheck <png_file_or_directory>...\n";
+        return 1;
+    }
+
+    int failed = 0;
+    for (const auto& png : pngs) {
+        try {
+            failed += !check(png);
+        } catch (const std::exception& err) {
+            std::cout << png.generic_string() << ": ERROR, " << err.what() << '\n';
+            ++failed;
+        }
+    }
+    std::cout << pngs.size() - failed << '/' << pngs.size() << " PNGs identical\n";
+    return failed == 0 ? 0 : 1;
+}
@@ -32,8 +32,7 @@ private:
 
     re::SpriteBatch m_sb{re::SpriteBatchCreateInfo{
         .renderPassSubpass = mainRenderPass().subpass(0),
-        .maxSprites        = 1,
-        .maxTextures       = 1
+        .maxSprites        = 1
     }};
     re::GeometryBatch m_gb{re::GeometryBatchCreateInfo{
         .topology          = vk::PrimitiveTopology::eLineList,
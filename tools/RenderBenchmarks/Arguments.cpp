@@ -0,0 +1,82 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#include <iostream>
+
+#include <argparse/argparse.hpp>
+
+#include <RenderBenchmarks/Arguments.hpp>
+
+CLIArguments parseArguments(int argc, char* argv[]) { // NOLINT(*-avoid-c-arrays)
+    argparse::ArgumentParser parser("RenderBenchmarks", "0.1.0");
+
+    parser.add_argument("scenario")
+        .choices("sprites", "pipelined", "uploads")
+        .help("the benchmarked scenario");
+    parser.add_argument("--headless")
+        .default_value(false)
+        .implicit_value(true)
+        .help("render offscreen without a window");
+    parser.add_argument("--steps")
+        .scan<'u', uint64_t>()
+        .default_value(uint64_t{1000})
+        .help("number of simulated steps, one step is done in each frame");
+    parser.add_argument("--csv")
+        .metavar("statistics_csv")
+        .default_value(std::string{})
+        .help("file where statistics of the frames will be written");
+    parser.add_argument("--max-frame-p99")
+        .metavar("milliseconds")
+        .scan<'g', double>()
+        .help("fail unless frames were recorded and their 99th percentile is lower");
+    parser.add_argument("--sprites")
+        .scan<'u', unsigned int>()
+        .default_value(100000u)
+        .help("[sprites, pipelined] number of sprites drawn in each frame");
+    parser.add_argument("--backend")
+        .default_value(std::string{"instanced"})
+        .choices("instanced", "tessellation")
+        .help("[sprites] how SpriteBatch expands sprites into quads");
+    parser.add_argument("--pipelined")
+        .default_value(false)
+        .implicit_value(true)
+        .help("[pipelined] run the last step of each frame concurrently with rendering");
+    parser.add_argument("--textures")
+        .scan<'u', unsigned int>()
+        .default_value(64u)
+        .help("[uploads] number of textures created in each frame");
+    parser.add_argument("--texture-size")
+        .scan<'u', unsigned int>()
+        .default_value(256u)
+        .help("[uploads] width and height of the textures");
+    parser.add_argument("--upload-path")
+        .default_value(std::string{"queue"})
+        .choices("queue", "one-time-submit")
+        .help("[uploads] upload through UploadQueue or by blocking one-time submits");
+
+    try {
+        parser.parse_args(argc, argv);
+    } catch (const std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        std::cerr << parser;
+        std::exit(1);
+    }
+
+    return CLIArguments{
+        .scenario          = parser.get<>("scenario"),
+        .headless          = parser.get<bool>("--headless"),
+        .stepCount         = parser.get<uint64_t>("--steps"),
+        .statisticsCSVPath = parser.get<>("--csv"),
+        .maxFrameP99Ms     = parser.present<double>("--max-frame-p99"),
+        .spriteCount       = parser.get<unsigned int>("--sprites"),
+        .backend = parser.get<>("--backend") == "tessellation"
+                       ? re::SpriteBatchBackend::Tessellation
+                       : re::SpriteBatchBackend::Instanced,
+        .pipelinedStepping = parser.get<bool>("--pipelined"),
+        .textureCount      = parser.get<unsigned int>("--textures"),
+        .textureSize       = parser.get<unsigned int>("--texture-size"),
+        .uploadPath = parser.get<>("--upload-path") == "one-time-submit"
+                          ? TextureUploadPath::OneTimeSubmit
+                          : TextureUploadPath::UploadQueue
+    };
+}
@@ -0,0 +1,27 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <RealEngine/graphics/batches/SpriteBatch.hpp>
+
+#include <RenderBenchmarks/TextureUploadRoom.hpp>
+
+struct CLIArguments {
+    std::string scenario;
+    bool headless{};
+    uint64_t stepCount{};
+    std::string statisticsCSVPath;
+    std::optional<double> maxFrameP99Ms;
+    unsigned int spriteCount{};
+    re::SpriteBatchBackend backend{};
+    bool pipelinedStepping{};
+    unsigned int textureCount{};
+    unsigned int textureSize{};
+    TextureUploadPath uploadPath{};
+};
+
+CLIArguments parseArguments(int argc, char* argv[]); // NOLINT(*-avoid-c-arrays)
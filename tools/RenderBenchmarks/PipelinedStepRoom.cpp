@@ -0,0 +1,88 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#include <array>
+#include <cmath>
+#include <iostream>
+
+#include <glm/geometric.hpp>
+
+#include <RenderBenchmarks/PipelinedStepRoom.hpp>
+
+namespace {
+
+constexpr glm::vec2 k_viewDims{1280.0f, 720.0f};
+constexpr float k_particleSize   = 2.0f;
+constexpr int k_substepCount     = 16;
+constexpr std::array<unsigned char, 4> k_whiteTexel{255, 255, 255, 255};
+
+} // namespace
+
+PipelinedStepRoom::PipelinedStepRoom(unsigned int particleCount, bool pipelinedStepping)
+    : Room(0, re::RoomDisplaySettings{.pipelinedStepping = pipelinedStepping})
+    , m_velocities(particleCount)
+    , m_sb(re::SpriteBatchCreateInfo{
+          .renderPassSubpass = mainRenderPass().subpass(0),
+          .maxSprites        = particleCount,
+          .backend           = re::SpriteBatchBackend::Instanced
+      })
+    , m_texture(re::TextureCreateInfo{
+          .extent    = {1, 1, 1},
+          .texels    = k_whiteTexel,
+          .debugName = "PipelinedStepRoom::texture"
+      })
+    , m_view(k_viewDims) {
+    m_view.setPosition(k_viewDims * 0.5f);
+    // Particles start on a grid
+    std::vector<glm::vec2> positions(particleCount);
+    auto columns = static_cast<unsigned int>(std::sqrt(particleCount)) + 1;
+    for (unsigned int i = 0; i < particleCount; ++i) {
+        glm::vec2 cell{i % columns, i / columns};
+        positions[i] = (cell + 0.5f) / static_cast<float>(columns) * k_viewDims;
+    }
+    m_positions.forEach([&](std::vector<glm::vec2>& buffer) { buffer = positions; });
+}
+
+void PipelinedStepRoom::sessionStart(const re::RoomTransitionArguments& args) {
+    std::cout << "Pipelined step: " << m_velocities.size() << " particles, "
+              << (displaySettings().pipelinedStepping ? "pipelined" : "sequential")
+              << " stepping\n";
+}
+
+void PipelinedStepRoom::sessionEnd() {
+}
+
+void PipelinedStepRoom::step() {
+    const auto& prev = m_positions.read();
+    auto& next       = m_positions.write();
+    constexpr float k_dt = 1.0f / k_substepCount;
+    for (size_t i = 0; i < prev.size(); ++i) {
+        glm::vec2 pos = prev[i];
+        glm::vec2 vel = m_velocities[i];
+        for (int s = 0; s < k_substepCount; ++s) {
+            // Swirl around the center of the view
+            glm::vec2 toCenter = k_viewDims * 0.5f - pos;
+            float dist         = glm::length(toCenter);
+            glm::vec2 dir      = toCenter / (dist + 1.0f);
+            vel += (glm::vec2{-dir.y, dir.x} * 0.5f + dir * std::sin(dist * 0.01f)) * k_dt;
+            pos += vel * k_dt;
+        }
+        m_velocities[i] = vel * 0.99f;
+        next[i]         = pos;
+    }
+}
+
+void PipelinedStepRoom::render(const re::CommandBuffer& cb, double interpolationFactor) {
+    vk::ClearValue clearVal = vk::ClearColorValue{0.0f, 0.0f, 0.0f, 1.0f};
+    engine().mainRenderPassBegin({&clearVal, 1});
+    m_sb.clearAndBeginFirstBatch();
+    // The step may be writing the other buffer concurrently
+    for (const auto& pos : m_positions.read()) {
+        m_sb.add(
+            m_texture, glm::vec4{pos, k_particleSize, k_particleSize},
+            glm::vec4{0.0f, 0.0f, 1.0f, 1.0f}
+        );
+    }
+    m_sb.drawBatch(cb, m_view.viewMatrix());
+    engine().mainRenderPassEnd();
+}
@@ -0,0 +1,36 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include <RealEngine/graphics/batches/SpriteBatch.hpp>
+#include <RealEngine/graphics/cameras/View2D.hpp>
+#include <RealEngine/graphics/synchronization/MultiBuffered.hpp>
+#include <RealEngine/graphics/textures/Texture.hpp>
+#include <RealEngine/rooms/Room.hpp>
+
+/**
+ * @brief Simulates particles in a single-threaded step and draws them
+ * @details Both the step and the recording of the frame are expensive
+ *          so the frame time shows how much of the step is hidden behind
+ *          the recording when pipelined stepping is enabled.
+ */
+class PipelinedStepRoom: public re::Room {
+public:
+    PipelinedStepRoom(unsigned int particleCount, bool pipelinedStepping);
+
+    void sessionStart(const re::RoomTransitionArguments& args) override;
+    void sessionEnd() override;
+    void step() override;
+    void render(const re::CommandBuffer& cb, double interpolationFactor) override;
+
+private:
+    re::StepDoubleBuffered<std::vector<glm::vec2>> m_positions;
+    std::vector<glm::vec2> m_velocities; ///< Used only by the step
+    re::SpriteBatch m_sb;
+    re::Texture m_texture;
+    re::View2D m_view;
+};
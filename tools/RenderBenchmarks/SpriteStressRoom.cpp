@@ -0,0 +1,94 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#include <array>
+#include <cmath>
+#include <iostream>
+
+#include <RenderBenchmarks/SpriteStressRoom.hpp>
+
+namespace {
+
+constexpr glm::vec2 k_viewDims{1280.0f, 720.0f};
+constexpr float k_spriteSize      = 4.0f;
+constexpr size_t k_spritesPerJob  = 4096;
+constexpr std::array<unsigned char, 4> k_whiteTexel{255, 255, 255, 255};
+
+/**
+ * @brief Gets a pseudorandom number in [0, 1) that is stable for the index
+ */
+float hashToUnit(uint32_t i) {
+    i ^= i >> 16;
+    i *= 0x7feb352dU;
+    i ^= i >> 15;
+    i *= 0x846ca68bU;
+    i ^= i >> 16;
+    return static_cast<float>(i >> 8) / static_cast<float>(1 << 24);
+}
+
+} // namespace
+
+SpriteStressRoom::SpriteStressRoom(
+    unsigned int spriteCount, re::SpriteBatchBackend backend
+)
+    : Room(0)
+    , m_spriteCount(spriteCount)
+    , m_backend(backend)
+    , m_sb(re::SpriteBatchCreateInfo{
+          .renderPassSubpass = mainRenderPass().subpass(0),
+          .maxSprites        = spriteCount,
+          .backend           = backend
+      })
+    , m_texture(re::TextureCreateInfo{
+          .extent    = {1, 1, 1},
+          .texels    = k_whiteTexel,
+          .debugName = "SpriteStressRoom::texture"
+      })
+    , m_view(k_viewDims) {
+    m_view.setPosition(k_viewDims * 0.5f);
+}
+
+void SpriteStressRoom::sessionStart(const re::RoomTransitionArguments& args) {
+    std::cout << "Sprite stress: " << m_spriteCount << " sprites, "
+              << (m_backend == re::SpriteBatchBackend::Instanced ? "instanced"
+                                                                 : "tessellation")
+              << " backend\n";
+}
+
+void SpriteStressRoom::sessionEnd() {
+}
+
+void SpriteStressRoom::step() {
+    ++m_stepN;
+}
+
+void SpriteStressRoom::render(const re::CommandBuffer& cb, double interpolationFactor) {
+    vk::ClearValue clearVal = vk::ClearColorValue{0.0f, 0.0f, 0.0f, 1.0f};
+    engine().mainRenderPassBegin({&clearVal, 1});
+    m_sb.clearAndBeginFirstBatch();
+    float time = static_cast<float>(m_stepN) * 0.02f;
+    engine().jobSystem().parallelFor(
+        0, m_spriteCount, k_spritesPerJob,
+        [&](size_t first, size_t last) {
+            auto range = m_sb.reserve(static_cast<unsigned int>(last - first));
+            for (size_t i = first; i < last; ++i) {
+                auto index  = static_cast<uint32_t>(i);
+                float phase = hashToUnit(index * 2u) * 6.2831853f;
+                glm::vec2 center{hashToUnit(index * 2u + 1u), hashToUnit(index * 3u)};
+                glm::vec2 pos = center * k_viewDims +
+                                glm::vec2{std::cos(time + phase), std::sin(time + phase)} *
+                                    32.0f;
+                re::Color col{
+                    static_cast<uint8_t>(index), static_cast<uint8_t>(index >> 8),
+                    static_cast<uint8_t>(index >> 16), 255
+                };
+                range.add(
+                    m_texture, glm::vec4{pos, k_spriteSize, k_spriteSize},
+                    glm::vec4{0.0f, 0.0f, 1.0f, 1.0f}, col
+                );
+            }
+        }
+    );
+    m_sb.drawBatch(cb, m_view.viewMatrix());
+    engine().mainRenderPassEnd();
+}
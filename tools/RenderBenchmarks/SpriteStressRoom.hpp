@@ -0,0 +1,31 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <RealEngine/graphics/batches/SpriteBatch.hpp>
+#include <RealEngine/graphics/cameras/View2D.hpp>
+#include <RealEngine/graphics/textures/Texture.hpp>
+#include <RealEngine/rooms/Room.hpp>
+
+/**
+ * @brief Draws many moving sprites each frame
+ * @details Positions of the sprites are computed in parallel while they are
+ *          added to the batch, so both adding and drawing are measured.
+ */
+class SpriteStressRoom: public re::Room {
+public:
+    SpriteStressRoom(unsigned int spriteCount, re::SpriteBatchBackend backend);
+
+    void sessionStart(const re::RoomTransitionArguments& args) override;
+    void sessionEnd() override;
+    void step() override;
+    void render(const re::CommandBuffer& cb, double interpolationFactor) override;
+
+private:
+    unsigned int m_spriteCount;
+    re::SpriteBatchBackend m_backend;
+    re::SpriteBatch m_sb;
+    re::Texture m_texture;
+    re::View2D m_view;
+    unsigned int m_stepN = 0;
+};
@@ -0,0 +1,100 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#include <cstring>
+#include <iostream>
+
+#include <RealEngine/graphics/buffers/BufferMapped.hpp>
+#include <RealEngine/graphics/commands/BarrierHelperFuncs.hpp>
+#include <RealEngine/graphics/commands/CommandBuffer.hpp>
+
+#include <RenderBenchmarks/TextureUploadRoom.hpp>
+
+TextureUploadRoom::TextureUploadRoom(
+    unsigned int texturesPerFrame, unsigned int textureSize, TextureUploadPath path
+)
+    : Room(0)
+    , m_texturesPerFrame(texturesPerFrame)
+    , m_textureSize(textureSize)
+    , m_path(path)
+    , m_texels(size_t{textureSize} * textureSize * 4) {
+    for (size_t i = 0; i < m_texels.size(); ++i) {
+        m_texels[i] = static_cast<unsigned char>(i * 7);
+    }
+    m_textures.reserve(texturesPerFrame);
+}
+
+void TextureUploadRoom::sessionStart(const re::RoomTransitionArguments& args) {
+    std::cout << "Texture upload: " << m_texturesPerFrame << " textures of "
+              << m_textureSize << "x" << m_textureSize << " texels per frame, "
+              << (m_path == TextureUploadPath::UploadQueue ? "upload queue"
+                                                           : "one-time submits")
+              << '\n';
+}
+
+void TextureUploadRoom::sessionEnd() {
+    m_textures.clear();
+}
+
+void TextureUploadRoom::step() {
+}
+
+void TextureUploadRoom::render(const re::CommandBuffer& cb, double interpolationFactor) {
+    m_textures.clear(); // Deleted once the frames that use them finish
+    for (unsigned int i = 0; i < m_texturesPerFrame; ++i) {
+        m_textures.push_back(createTexture());
+    }
+
+    vk::ClearValue clearVal = vk::ClearColorValue{0.0f, 0.0f, 0.0f, 1.0f};
+    engine().mainRenderPassBegin({&clearVal, 1});
+    engine().mainRenderPassEnd();
+}
+
+re::Texture TextureUploadRoom::createTexture() const {
+    using enum vk::ImageUsageFlagBits;
+    re::TextureCreateInfo createInfo{
+        .extent     = {m_textureSize, m_textureSize, 1},
+        .usage      = eSampled | eTransferDst,
+        .hasSampler = false,
+        .debugName  = "TextureUploadRoom::textures"
+    };
+    if (m_path == TextureUploadPath::UploadQueue) {
+        createInfo.texels = m_texels;
+        return re::Texture{createInfo};
+    }
+
+    createInfo.initialLayout = vk::ImageLayout::eUndefined;
+    re::Texture tex{createInfo};
+    re::BufferMapped<std::byte> stagingBuffer{re::BufferCreateInfo{
+        .allocFlags = vma::AllocationCreateFlagBits::eHostAccessSequentialWrite |
+                      vma::AllocationCreateFlagBits::eMapped,
+        .memoryUsage = vma::MemoryUsage::eAutoPreferHost,
+        .sizeInBytes = m_texels.size(),
+        .usage       = vk::BufferUsageFlagBits::eTransferSrc
+    }};
+    std::memcpy(stagingBuffer.mapped(), m_texels.data(), m_texels.size());
+    re::CommandBuffer::doOneTimeSubmit([&](const re::CommandBuffer& cb) {
+        using enum vk::PipelineStageFlagBits2;
+        using enum vk::ImageLayout;
+        using Access       = vk::AccessFlagBits2;
+        auto toTransferDst = re::imageMemoryBarrier(
+            {}, {}, eCopy, Access::eTransferWrite, eUndefined, eTransferDstOptimal,
+            tex.image()
+        );
+        cb->pipelineBarrier2(vk::DependencyInfo{{}, {}, {}, toTransferDst});
+        cb->copyBufferToImage(
+            stagingBuffer.buffer(), tex.image(), eTransferDstOptimal,
+            vk::BufferImageCopy{
+                0u, 0u, 0u,
+                vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, 0u, 0u, 1u},
+                vk::Offset3D{0, 0, 0}, vk::Extent3D{m_textureSize, m_textureSize, 1u}
+            }
+        );
+        auto toShaderRead = re::imageMemoryBarrier(
+            eCopy, Access::eTransferWrite, eFragmentShader, Access::eShaderSampledRead,
+            eTransferDstOptimal, eShaderReadOnlyOptimal, tex.image()
+        );
+        cb->pipelineBarrier2(vk::DependencyInfo{{}, {}, {}, toShaderRead});
+    });
+    return tex;
+}
@@ -0,0 +1,44 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <vector>
+
+#include <RealEngine/graphics/textures/Texture.hpp>
+#include <RealEngine/rooms/Room.hpp>
+
+/**
+ * @brief Selects how TextureUploadRoom initializes texels of the textures
+ */
+enum class TextureUploadPath {
+    UploadQueue,    ///< Texels are passed to the constructor of Texture
+    OneTimeSubmit   ///< Each texture is uploaded by its own blocking submission
+};
+
+/**
+ * @brief Creates textures with initial texels every frame
+ * @details TextureUploadPath::OneTimeSubmit reproduces how textures were
+ *          initialized before the UploadQueue: through a staging buffer
+ *          and CommandBuffer::doOneTimeSubmit, which waits for the device
+ *          to become idle.
+ */
+class TextureUploadRoom: public re::Room {
+public:
+    TextureUploadRoom(
+        unsigned int texturesPerFrame, unsigned int textureSize, TextureUploadPath path
+    );
+
+    void sessionStart(const re::RoomTransitionArguments& args) override;
+    void sessionEnd() override;
+    void step() override;
+    void render(const re::CommandBuffer& cb, double interpolationFactor) override;
+
+private:
+    re::Texture createTexture() const;
+
+    unsigned int m_texturesPerFrame;
+    unsigned int m_textureSize;
+    TextureUploadPath m_path;
+    std::vector<unsigned char> m_texels;
+    std::vector<re::Texture> m_textures; ///< Created in the last frame
+};
@@ -0,0 +1,112 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <iostream>
+
+#include <RealEngine/program/MainProgram.hpp>
+#include <RealEngine/rooms/Room.hpp>
+
+#include <RenderBenchmarks/Arguments.hpp>
+#include <RenderBenchmarks/PipelinedStepRoom.hpp>
+#include <RenderBenchmarks/SpriteStressRoom.hpp>
+#include <RenderBenchmarks/TextureUploadRoom.hpp>
+
+namespace {
+
+/**
+ * @brief Writes input log of steps without any input
+ * @details Benchmark mode ends when the replayed input ends so the log
+ *          determines the length of the benchmark.
+ */
+std::filesystem::path writeEmptyInputLog(uint64_t stepCount) {
+    auto path = std::filesystem::temp_directory_path() /
+                std::format("RenderBenchmarks_{}.input", stepCount);
+    re::InputManager inputManager;
+    re::InputLogWriter writer{path};
+    for (uint64_t i = 0; i < stepCount; ++i) {
+        inputManager.step();
+        writer.writeStep(inputManager);
+    }
+    return path;
+}
+
+/**
+ * @brief Checks percentiles of the frames of the finished benchmark
+ * @return True if the percentiles are consistent and within the limit
+ */
+bool checkFrameStatistics(double maxP99Ms) {
+    using enum re::FrameStatistics::Metric;
+    auto p  = re::Room::engine().frameStatistics().percentiles(FrameTotal);
+    auto ms = [](re::FrameStatistics::Duration duration) {
+        return std::chrono::duration<double, std::milli>{duration}.count();
+    };
+    if (p.sampleCount == 0) {
+        std::cerr << "Check failed: no frames were recorded\n";
+        return false;
+    }
+    if (!(p.p50 <= p.p95 && p.p95 <= p.p99 && p.p99 <= p.p999 && p.p999 <= p.max)) {
+        std::cerr << "Check failed: frame percentiles are not ordered\n";
+        return false;
+    }
+    if (ms(p.p99) > maxP99Ms) {
+        std::cerr << std::format(
+            "Check failed: frame p99 {:.3f} ms exceeds {:.3f} ms\n", ms(p.p99), maxP99Ms
+        );
+        return false;
+    }
+    std::cout << std::format(
+        "Check passed: frame p99 {:.3f} ms over {} frames\n", ms(p.p99), p.sampleCount
+    );
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief Runs a rendering scenario in benchmark mode
+ * @details Statistics of the frames are reported when the benchmark ends.
+ */
+int main(int argc, char* argv[]) {
+    try {
+        CLIArguments args  = parseArguments(argc, argv);
+        auto inputLogPath  = writeEmptyInputLog(args.stepCount).string();
+        re::HeadlessInitInfo headless{};
+        re::BenchmarkInitInfo benchmark{
+            .inputLogPath      = inputLogPath.c_str(),
+            .stepsPerFrame     = 1,
+            .statisticsCSVPath = args.statisticsCSVPath.empty()
+                                     ? nullptr
+                                     : args.statisticsCSVPath.c_str()
+        };
+        re::MainProgram::initialize({
+            .headless  = args.headless ? &headless : nullptr,
+            .benchmark = &benchmark
+        });
+        re::Room* room = nullptr;
+        if (args.scenario == "pipelined") {
+            room = re::MainProgram::addRoom<PipelinedStepRoom>(
+                args.spriteCount, args.pipelinedStepping
+            );
+        } else if (args.scenario == "uploads") {
+            room = re::MainProgram::addRoom<TextureUploadRoom>(
+                args.textureCount, args.textureSize, args.uploadPath
+            );
+        } else {
+            room = re::MainProgram::addRoom<SpriteStressRoom>(
+                args.spriteCount, args.backend
+            );
+        }
+        int exitCode = re::MainProgram::run(room->name(), {});
+        if (exitCode == EXIT_SUCCESS && args.maxFrameP99Ms &&
+            !checkFrameStatistics(*args.maxFrameP99Ms)) {
+            exitCode = EXIT_FAILURE;
+        }
+        return exitCode;
+    } catch (const std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,102 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#include <algorithm>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <RealEngine/resources/FileIO.hpp>
+#include <RealEngine/resources/PNGLoader.hpp>
+#include <RealEngine/resources/TextureContainer.hpp>
+#include <RealEngine/utility/Error.hpp>
+
+#include <ResourceBenchmarks/DecodeBenchmark.hpp>
+#include <ResourceBenchmarks/Measurements.hpp>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int k_repetitionCount = 3; ///< The fastest repetition is reported
+
+using Encoded = std::vector<std::vector<unsigned char>>;
+
+/**
+ * @brief Decodes copies of the encoded images by the function
+ * @return Milliseconds of the fastest repetition, copying is not measured
+ */
+double measureDecoding(
+    const Encoded& encoded,
+    const std::function<re::TextureContainer(std::vector<unsigned char>&&)>& decode
+) {
+    double fastestMs = std::numeric_limits<double>::max();
+    for (int r = 0; r < k_repetitionCount; ++r) {
+        Encoded copies = encoded; // Like the bytes extracted by ResourceLoader
+        auto start     = Clock::now();
+        for (auto& bytes : copies) {
+            if (decode(std::move(bytes)).texels().empty()) {
+                throw re::Exception{"Decoded texture has no texels"};
+            }
+        }
+        fastestMs = std::min(fastestMs, millisecondsSince(start));
+    }
+    return fastestMs;
+}
+
+} // namespace
+
+void benchmarkDecoding(const fs::path& workDir, const SyntheticAssetsInfo& assets) {
+    // Encode the images in all forms
+    fs::path dir = workDir / "decode";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    Encoded pngs;
+    Encoded containers;
+    Encoded containersWithMips;
+    for (size_t i = 0; i < assets.imageCount; ++i) {
+        auto png  = syntheticImage(assets.imageSize, static_cast<uint32_t>(i));
+        auto path = dir / std::format("image{:05}.png", i);
+        re::PNGLoader::save(path.string(), png);
+        pngs.push_back(re::readBinaryFile(path));
+        containers.push_back(re::TextureContainer::encode(png, false));
+        containersWithMips.push_back(re::TextureContainer::encode(png, true));
+    }
+    double texelMiB = static_cast<double>(assets.imageCount) * assets.imageSize *
+                      assets.imageSize * 4 / (1024.0 * 1024.0);
+    std::cout << std::format(
+        "{} images of {}x{} texels, {:.1f} MiB of texels\n\n", assets.imageCount,
+        assets.imageSize, assets.imageSize, texelMiB
+    );
+
+    auto decodePNG = [](std::vector<unsigned char>&& bytes) {
+        return re::TextureContainer{re::PNGLoader::load(bytes)};
+    };
+    auto readContainer = [](std::vector<unsigned char>&& bytes) {
+        return re::TextureContainer{std::move(bytes)};
+    };
+    auto report = [&](const char* name, const Encoded& encoded, double ms) {
+        uint64_t encodedSize = 0;
+        for (const auto& bytes : encoded) { encodedSize += bytes.size(); }
+        std::cout << std::format(
+            "{:<22}{:>12}{:>12.3f} ms{:>12.3f} ms/MiB\n", name,
+            formatBytes(static_cast<int64_t>(encodedSize)), ms, ms / texelMiB
+        );
+    };
+    std::cout << std::format(
+        "{:<22}{:>12}{:>15}{:>19}\n", "Stored as", "Size", "Decoding", "Per texel MiB"
+    );
+    auto decoder = re::PNGLoader::decoder();
+    re::PNGLoader::setDecoder(re::PNGLoader::Decoder::Fast);
+    report("PNG (fast decoder)", pngs, measureDecoding(pngs, decodePNG));
+    re::PNGLoader::setDecoder(re::PNGLoader::Decoder::Lodepng);
+    report("PNG (lodepng)", pngs, measureDecoding(pngs, decodePNG));
+    re::PNGLoader::setDecoder(decoder);
+    report("container", containers, measureDecoding(containers, readContainer));
+    report(
+        "container with mips", containersWithMips,
+        measureDecoding(containersWithMips, readContainer)
+    );
+}
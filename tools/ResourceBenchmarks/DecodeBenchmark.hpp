@@ -0,0 +1,17 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <filesystem>
+
+#include <ResourceBenchmarks/SyntheticAssets.hpp>
+
+/**
+ * @brief   Compares decoding of PNGs and texture containers
+ * @details Decodes the synthetic images in each form that a packaged texture
+ *          can have, the way ResourceLoader does. Reports the time per MiB
+ *          of decoded texels (of the largest mip level).
+ */
+void benchmarkDecoding(
+    const std::filesystem::path& workDir, const SyntheticAssetsInfo& assets
+);
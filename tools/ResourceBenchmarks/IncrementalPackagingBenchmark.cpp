@@ -0,0 +1,63 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <RealEngine/utility/Error.hpp>
+
+#include <ResourceBenchmarks/IncrementalPackagingBenchmark.hpp>
+#include <ResourceBenchmarks/Measurements.hpp>
+#include <ResourcePackager/Package.hpp>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr size_t k_changedFileRatio = 100; ///< Every n-th data file is changed
+
+} // namespace
+
+void benchmarkIncrementalPackaging(
+    const fs::path& workDir, const SyntheticAssetsInfo& assets
+) {
+    fs::path inputDir = workDir / "input" / "assets";
+    fs::path dir      = workDir / "incremental";
+    std::cout << "Generating synthetic assets...\n";
+    uint64_t inputSize = generateSyntheticAssets(inputDir, assets);
+    std::cout << std::format(
+        "{} data files and {} images, {}\n\n", assets.dataFileCount, assets.imageCount,
+        formatBytes(static_cast<int64_t>(inputSize))
+    );
+
+    std::vector<std::string> inputDirs{inputDir.string()};
+    auto package = [&](const char* name) {
+        auto start = Clock::now();
+        re::rp::composePackage(inputDirs, dir.string(), (dir / "index.hpp").string(), {});
+        std::cout << std::format("{:<32}{:>12.1f} ms\n", name, millisecondsSince(start));
+    };
+
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    package("Full packaging");
+    package("Repackaging without changes");
+
+    // Change some of the data files, only their entries have to be packed again
+    size_t changedCount = 0;
+    for (const auto& entry : fs::recursive_directory_iterator{inputDir}) {
+        if (entry.path().extension() != ".bin" || changedCount++ % k_changedFileRatio) {
+            continue;
+        }
+        std::fstream file{entry.path(), std::ios::binary | std::ios::in | std::ios::out};
+        char first = static_cast<char>(file.get());
+        file.seekp(0);
+        file.put(static_cast<char>(~first)); // Changes the content hash
+        if (!file) {
+            throw re::Exception{std::format("Could not modify {}", entry.path().string())};
+        }
+    }
+    package(std::format("Repackaging with 1/{} changed", k_changedFileRatio).c_str());
+}
@@ -0,0 +1,16 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <filesystem>
+
+#include <ResourceBenchmarks/SyntheticAssets.hpp>
+
+/**
+ * @brief   Measures incremental packaging of a native package
+ * @details Packages the synthetic assets from scratch, then again without
+ *          any changes and then after a part of the data files has changed.
+ */
+void benchmarkIncrementalPackaging(
+    const std::filesystem::path& workDir, const SyntheticAssetsInfo& assets
+);
@@ -0,0 +1,61 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#include <array>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+
+#include <RealEngine/utility/BuildType.hpp>
+
+#if RE_BUILDING_FOR_WINDOWS
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <Windows.h>
+// Windows.h has to be included first
+#    include <Psapi.h>
+#elif RE_BUILDING_FOR_LINUX // ^^^ RE_BUILDING_FOR_WINDOWS
+#    include <unistd.h>
+#else
+#    error "Unhandled OS"
+#endif
+
+#include <ResourceBenchmarks/Measurements.hpp>
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>{Clock::now() - start}.count();
+}
+
+uint64_t residentSetSize() {
+#if RE_BUILDING_FOR_WINDOWS
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.WorkingSetSize;
+#elif RE_BUILDING_FOR_LINUX // ^^^ RE_BUILDING_FOR_WINDOWS
+    // The second field is the number of resident pages
+    std::ifstream statm{"/proc/self/statm"};
+    uint64_t totalPages    = 0;
+    uint64_t residentPages = 0;
+    if (!(statm >> totalPages >> residentPages)) {
+        return 0;
+    }
+    return residentPages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#endif // RE_BUILDING_FOR_LINUX
+}
+
+std::string formatBytes(int64_t bytes) {
+    constexpr std::array k_units{"B", "KiB", "MiB", "GiB"};
+    auto value  = static_cast<double>(bytes);
+    size_t unit = 0;
+    while (std::abs(value) >= 1024.0 && unit + 1 < k_units.size()) {
+        value /= 1024.0;
+        ++unit;
+    }
+    return std::format("{:.1f} {}", value, k_units[unit]);
+}
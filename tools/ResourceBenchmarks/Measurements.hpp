@@ -0,0 +1,24 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Gets milliseconds that have elapsed since the time point
+ */
+double millisecondsSince(Clock::time_point start);
+
+/**
+ * @brief Gets resident set size of this process in bytes, 0 if it is unknown
+ */
+uint64_t residentSetSize();
+
+/**
+ * @brief Formats number of bytes in the most fitting binary unit
+ */
+std::string formatBytes(int64_t bytes);
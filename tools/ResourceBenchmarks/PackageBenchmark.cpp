@@ -0,0 +1,135 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#include <format>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <bit7z/bitmemextractor.hpp>
+// bit7z may include Windows.h which introduces macros...
+#ifdef MemoryBarrier
+#    undef MemoryBarrier
+#endif
+
+#include <RealEngine/resources/MappedFile.hpp>
+#include <RealEngine/resources/PackageConstants.hpp>
+#include <RealEngine/resources/PackageReader.hpp>
+#include <RealEngine/utility/Error.hpp>
+
+#include <ResourceBenchmarks/Measurements.hpp>
+#include <ResourceBenchmarks/PackageBenchmark.hpp>
+#include <ResourcePackager/Package.hpp>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/**
+ * @brief Opens the package and extracts its entries like ResourceLoader does
+ */
+class PackageLoader {
+public:
+    explicit PackageLoader(const fs::path& path) {
+        re::MappedFile file{path};
+        if (re::PackageReader::isNativePackage(file.bytes())) {
+            m_native = std::make_unique<re::PackageReader>(std::move(file));
+        } else {
+            m_sevenZip = std::make_unique<SevenZipPackage>(file.bytes());
+        }
+    }
+
+    uint32_t entryCount() const {
+        return m_native ? m_native->entryCount()
+                        : m_sevenZip->inputArchive.itemsCount();
+    }
+
+    std::vector<unsigned char> extract(uint32_t id) const {
+        if (m_native) {
+            return m_native->extract(id);
+        }
+        std::vector<unsigned char> extracted;
+        m_sevenZip->inputArchive.extractTo(extracted, id);
+        return extracted;
+    }
+
+private:
+    /**
+     * @brief Mirrors ResourceLoader's 7z package, which is loaded whole
+     */
+    struct SevenZipPackage {
+        explicit SevenZipPackage(std::span<const unsigned char> package)
+            : compressedPackage(package.begin(), package.end()) {}
+
+        std::vector<unsigned char> compressedPackage;
+        bit7z::Bit7zLibrary lib{re::default7ZipSharedLibLocation()};
+        bit7z::BitMemExtractor extractor{lib, bit7z::BitFormat::SevenZip};
+        [[no_unique_address]] struct Empty {
+        } _empty = [&]() {
+            extractor.setPassword(re::k_packageKey);
+            return Empty{};
+        }();
+        bit7z::BitInputArchive inputArchive{extractor, compressedPackage};
+    };
+
+    std::unique_ptr<re::PackageReader> m_native;
+    std::unique_ptr<SevenZipPackage> m_sevenZip;
+};
+
+} // namespace
+
+void benchmarkPackageFormats(const fs::path& workDir, const SyntheticAssetsInfo& assets) {
+    fs::path inputDir = workDir / "input" / "assets";
+    std::cout << "Generating synthetic assets...\n";
+    uint64_t inputSize = generateSyntheticAssets(inputDir, assets);
+    std::cout << std::format(
+        "{} data files and {} images, {}\n\n", assets.dataFileCount, assets.imageCount,
+        formatBytes(static_cast<int64_t>(inputSize))
+    );
+
+    std::cout << std::format(
+        "{:<8}{:>12}{:>14}{:>14}{:>14}{:>16}{:>16}\n", "Format", "Size", "Packaging",
+        "First load", "All loads", "RSS first load", "RSS all loads"
+    );
+    for (auto format : {re::rp::PackageFormat::Native, re::rp::PackageFormat::SevenZip}) {
+        bool native   = format == re::rp::PackageFormat::Native;
+        fs::path dir  = workDir / (native ? "native" : "7z");
+        fs::path path = dir / re::k_packageName;
+
+        // Package from scratch, the native package would be reused otherwise
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        std::vector<std::string> inputDirs{inputDir.string()};
+        auto start = Clock::now();
+        re::rp::composePackage(
+            inputDirs, dir.string(), (dir / "index.hpp").string(), {.format = format}
+        );
+        double packagingMs = millisecondsSince(start);
+
+        // Load the first resource, then all of them
+        auto rssBefore = static_cast<int64_t>(residentSetSize());
+        start          = Clock::now();
+        PackageLoader loader{path};
+        auto first          = loader.extract(0);
+        double firstLoadMs  = millisecondsSince(start);
+        auto rssFirstLoad   = static_cast<int64_t>(residentSetSize());
+        uint64_t loadedSize = first.size();
+        for (uint32_t id = 1; id < loader.entryCount(); ++id) {
+            loadedSize += loader.extract(id).size();
+        }
+        double allLoadsMs = millisecondsSince(start);
+        auto rssAllLoads  = static_cast<int64_t>(residentSetSize());
+        if (loadedSize != inputSize) {
+            throw re::Exception{"Loaded resources differ in size from the assets"};
+        }
+
+        std::cout << std::format(
+            "{:<8}{:>12}{:>11.1f} ms{:>11.3f} ms{:>11.1f} ms{:>16}{:>16}\n",
+            native ? "native" : "7z",
+            formatBytes(static_cast<int64_t>(fs::file_size(path))), packagingMs,
+            firstLoadMs, allLoadsMs, formatBytes(rssFirstLoad - rssBefore),
+            formatBytes(rssAllLoads - rssBefore)
+        );
+    }
+}
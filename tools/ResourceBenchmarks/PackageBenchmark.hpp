@@ -0,0 +1,18 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <filesystem>
+
+#include <ResourceBenchmarks/SyntheticAssets.hpp>
+
+/**
+ * @brief   Compares the native and the 7z package formats
+ * @details Packages synthetic assets into both formats and loads them back
+ *          the way ResourceLoader does. Reports time of packaging, time
+ *          to the first loaded resource, time to load all resources and
+ *          growth of the resident set size.
+ */
+void benchmarkPackageFormats(
+    const std::filesystem::path& workDir, const SyntheticAssetsInfo& assets
+);
@@ -0,0 +1,89 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#include <format>
+#include <fstream>
+#include <random>
+#include <string_view>
+
+#include <RealEngine/utility/Error.hpp>
+
+#include <ResourceBenchmarks/SyntheticAssets.hpp>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr size_t k_filesPerDir = 100;
+
+void writeFile(const fs::path& path, const std::vector<unsigned char>& bytes) {
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file.write(
+        reinterpret_cast<const char*>(bytes.data()),
+        static_cast<std::streamsize>(bytes.size())
+    );
+    if (!file) {
+        throw re::Exception{std::format("Could not write {}", path.string())};
+    }
+}
+
+} // namespace
+
+std::vector<unsigned char> syntheticData(size_t size, uint32_t seed) {
+    constexpr std::string_view k_words[] = {
+        "entity ", "position ", "velocity ", "texture ", "sprite ", "room ", "42 ", "\n"
+    };
+    std::mt19937 gen{seed};
+    std::vector<unsigned char> data;
+    data.reserve(size);
+    while (data.size() < size / 2) {
+        auto word = k_words[gen() % std::size(k_words)];
+        data.insert(data.end(), word.begin(), word.end());
+    }
+    data.resize(size / 2);
+    while (data.size() < size) { data.push_back(static_cast<unsigned char>(gen())); }
+    return data;
+}
+
+re::PNGLoader::PNGData syntheticImage(unsigned int size, uint32_t seed) {
+    std::mt19937 gen{seed};
+    re::PNGLoader::PNGData png{
+        .texels = std::vector<unsigned char>(size_t{size} * size * 4),
+        .dims   = {size, size},
+        .shape  = re::TextureShape{.subimageDims = glm::vec2{size, size}}
+    };
+    unsigned char* texel = png.texels.data();
+    for (unsigned int y = 0; y < size; ++y) {
+        for (unsigned int x = 0; x < size; ++x) {
+            auto noise = static_cast<unsigned char>(gen() % 16);
+            *texel++   = static_cast<unsigned char>(x * 255 / size + noise);
+            *texel++   = static_cast<unsigned char>(y * 255 / size + noise);
+            *texel++   = static_cast<unsigned char>((x ^ y) + noise);
+            *texel++   = 255;
+        }
+    }
+    return png;
+}
+
+uint64_t generateSyntheticAssets(const fs::path& dir, const SyntheticAssetsInfo& info) {
+    fs::remove_all(dir);
+    uint64_t totalSize = 0;
+    auto pathOf = [&](const char* prefix, size_t i, const char* extension) {
+        fs::path subdir = dir / std::format("{}{:03}", prefix, i / k_filesPerDir);
+        fs::create_directories(subdir);
+        return subdir / std::format("{}{:05}{}", prefix, i, extension);
+    };
+    for (size_t i = 0; i < info.dataFileCount; ++i) {
+        auto data = syntheticData(info.dataFileSize, static_cast<uint32_t>(i));
+        writeFile(pathOf("data", i, ".bin"), data);
+        totalSize += data.size();
+    }
+    for (size_t i = 0; i < info.imageCount; ++i) {
+        auto path = pathOf("image", i, ".png");
+        re::PNGLoader::save(
+            path.string(), syntheticImage(info.imageSize, static_cast<uint32_t>(i))
+        );
+        totalSize += fs::file_size(path);
+    }
+    return totalSize;
+}
@@ -0,0 +1,40 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <RealEngine/resources/PNGLoader.hpp>
+
+/**
+ * @brief Describes the assets that are generated
+ */
+struct SyntheticAssetsInfo {
+    size_t dataFileCount{};   ///< Binary files, half compressible, half random
+    size_t dataFileSize{};    ///< In bytes
+    size_t imageCount{};      ///< PNG images
+    unsigned int imageSize{}; ///< Width and height of the images
+};
+
+/**
+ * @brief Generates data that are half compressible text and half random bytes
+ * @details The same seed always generates the same data.
+ */
+std::vector<unsigned char> syntheticData(size_t size, uint32_t seed);
+
+/**
+ * @brief Generates image with gradients and noise
+ * @details The same seed always generates the same image.
+ */
+re::PNGLoader::PNGData syntheticImage(unsigned int size, uint32_t seed);
+
+/**
+ * @brief   Replaces contents of the directory by generated assets
+ * @details The files are spread across subdirectories of at most 100 files.
+ * @return  Total size of the generated files in bytes
+ */
+uint64_t generateSyntheticAssets(
+    const std::filesystem::path& dir, const SyntheticAssetsInfo& info
+);
@@ -0,0 +1,112 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <RealEngine/jobs/JobSystem.hpp>
+
+#include <ResourceBenchmarks/Measurements.hpp>
+#include <ResourceBenchmarks/WorkerCountBenchmark.hpp>
+#include <ResourcePackager/Package.hpp>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr size_t k_elementCount = 1 << 22;
+constexpr size_t k_batchSize    = 1 << 12;
+
+/**
+ * @brief Makes the job system the shared one for its lifetime
+ */
+class SharedJobSystem {
+public:
+    explicit SharedJobSystem(re::JobSystem& jobSystem) {
+        re::JobSystem::setShared(&jobSystem);
+    }
+    ~SharedJobSystem() { re::JobSystem::setShared(nullptr); }
+
+    SharedJobSystem(const SharedJobSystem&)            = delete; ///< Noncopyable
+    SharedJobSystem& operator=(const SharedJobSystem&) = delete; ///< Noncopyable
+};
+
+/**
+ * @brief Mixes the bits of the value several times to have some work per element
+ */
+uint64_t mix(uint64_t x) {
+    for (int i = 0; i < 32; ++i) {
+        x += 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        x ^= x >> 31;
+    }
+    return x;
+}
+
+double timeParallelFor(re::JobSystem& jobSystem, std::vector<uint64_t>& values) {
+    auto start = Clock::now();
+    jobSystem.parallelFor(0, values.size(), k_batchSize, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            values[i] = mix(values[i] + i);
+        }
+    });
+    return millisecondsSince(start);
+}
+
+double timePackaging(
+    re::JobSystem& jobSystem, const std::vector<std::string>& inputDirs,
+    const fs::path& dir
+) {
+    SharedJobSystem shared{jobSystem};
+    fs::remove_all(dir); // Nothing can be reused from the previous package
+    fs::create_directories(dir);
+    auto start = Clock::now();
+    re::rp::composePackage(inputDirs, dir.string(), (dir / "index.hpp").string(), {});
+    return millisecondsSince(start);
+}
+
+} // namespace
+
+void benchmarkWorkerCounts(const fs::path& workDir, const SyntheticAssetsInfo& assets) {
+    fs::path inputDir = workDir / "input" / "assets";
+    std::cout << "Generating synthetic assets...\n";
+    generateSyntheticAssets(inputDir, assets);
+    std::vector<std::string> inputDirs{inputDir.string()};
+
+    unsigned int maxWorkers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    std::vector<unsigned int> workerCounts;
+    for (unsigned int count = 1; count < maxWorkers; count *= 2) {
+        workerCounts.push_back(count);
+    }
+    workerCounts.push_back(maxWorkers);
+
+    std::cout << std::format(
+        "\n{:<10}{:>18}{:>10}{:>18}{:>10}\n", "Workers", "parallelFor", "Speedup",
+        "Packaging", "Speedup"
+    );
+    std::vector<uint64_t> values(k_elementCount);
+    double baseParallelFor = 0.0;
+    double basePackaging   = 0.0;
+    for (unsigned int count : workerCounts) {
+        re::JobSystem jobSystem{re::JobSystemCreateInfo{.workerCount = count}};
+        timeParallelFor(jobSystem, values); // Warm-up
+        double parallelFor = timeParallelFor(jobSystem, values);
+        double packaging   = timePackaging(jobSystem, inputDirs, workDir / "workers");
+        if (count == workerCounts.front()) {
+            baseParallelFor = parallelFor;
+            basePackaging   = packaging;
+        }
+        std::cout << std::format(
+            "{:<10}{:>15.1f} ms{:>9.2f}x{:>15.1f} ms{:>9.2f}x\n", count, parallelFor,
+            baseParallelFor / parallelFor, packaging, basePackaging / packaging
+        );
+    }
+    // Keeps the results observable so that the work is not optimized out
+    std::cout << std::format("Checksum: {:016x}\n", values[values.size() / 2]);
+}
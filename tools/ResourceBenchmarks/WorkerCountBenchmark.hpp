@@ -0,0 +1,17 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <filesystem>
+
+#include <ResourceBenchmarks/SyntheticAssets.hpp>
+
+/**
+ * @brief   Measures how parallelFor and native packaging scale with workers
+ * @details Runs both with job systems of 1, 2, 4, ... workers up to one less
+ *          than the number of hardware threads and reports the speedups
+ *          relative to the single worker.
+ */
+void benchmarkWorkerCounts(
+    const std::filesystem::path& workDir, const SyntheticAssetsInfo& assets
+);
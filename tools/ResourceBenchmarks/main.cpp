@@ -0,0 +1,76 @@
+﻿/**
+ *  @author    Dubsky Tomas
+ */
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include <argparse/argparse.hpp>
+
+#include <ResourceBenchmarks/DecodeBenchmark.hpp>
+#include <ResourceBenchmarks/IncrementalPackagingBenchmark.hpp>
+#include <ResourceBenchmarks/PackageBenchmark.hpp>
+#include <ResourceBenchmarks/WorkerCountBenchmark.hpp>
+
+/**
+ * @brief Runs a benchmark of resource packaging and loading on synthetic assets
+ */
+int main(int argc, char* argv[]) {
+    argparse::ArgumentParser parser("ResourceBenchmarks", "0.1.0");
+
+    parser.add_argument("benchmark")
+        .choices("formats", "decode", "incremental", "workers")
+        .help("the benchmark to run");
+    parser.add_argument("--work-dir")
+        .default_value(
+            (std::filesystem::temp_directory_path() / "ResourceBenchmarks").string()
+        )
+        .help("directory for generated assets and packages, its contents are replaced");
+    parser.add_argument("--files")
+        .scan<'u', size_t>()
+        .default_value(size_t{2000})
+        .help("number of generated data files");
+    parser.add_argument("--file-size")
+        .scan<'u', size_t>()
+        .default_value(size_t{64})
+        .help("size of the generated data files in KiB");
+    parser.add_argument("--images")
+        .scan<'u', size_t>()
+        .default_value(size_t{64})
+        .help("number of generated PNG images");
+    parser.add_argument("--image-size")
+        .scan<'u', unsigned int>()
+        .default_value(512u)
+        .help("width and height of the generated images");
+
+    try {
+        parser.parse_args(argc, argv);
+    } catch (const std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    SyntheticAssetsInfo assets{
+        .dataFileCount = parser.get<size_t>("--files"),
+        .dataFileSize  = parser.get<size_t>("--file-size") * 1024,
+        .imageCount    = parser.get<size_t>("--images"),
+        .imageSize     = parser.get<unsigned int>("--image-size")
+    };
+    std::filesystem::path workDir = parser.get<>("--work-dir");
+    try {
+        auto benchmark = parser.get<>("benchmark");
+        if (benchmark == "decode") {
+            benchmarkDecoding(workDir, assets);
+        } else if (benchmark == "incremental") {
+            benchmarkIncrementalPackaging(workDir, assets);
+        } else if (benchmark == "workers") {
+            benchmarkWorkerCounts(workDir, assets);
+        } else {
+            benchmarkPackageFormats(workDir, assets);
+        }
+    } catch (const std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        return 1;
+    }
+}
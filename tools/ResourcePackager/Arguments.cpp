@@ -23,6 +23,20 @@ CLIArguments parseArguments(int argc, char* argv[]) { // NOLINT(*-avoid-c-arrays
         .metavar("output_index_file")
         .required()
         .help("filepath where C++ index file will be placed");
+    parser.add_argument("--format")
+        .metavar("package_format")
+        .default_value(std::string{"native"})
+        .choices("native", "7z")
+        .help("format of the package: memory-mappable native format or 7z archive");
+    parser.add_argument("--textures")
+        .metavar("texture_storage")
+        .default_value(std::string{"png"})
+        .choices("png", "container", "mips")
+        .help("how to store PNGs: as they are or GPU-ready container (opt. with mips)");
+    parser.add_argument("--timings")
+        .default_value(false)
+        .implicit_value(true)
+        .help("print time spent on each file");
 
     try {
         parser.parse_args(argc, argv);
@@ -32,10 +46,19 @@ CLIArguments parseArguments(int argc, char* argv[]) { // NOLINT(*-avoid-c-arrays
         std::exit(1);
     }
 
+    auto textures = parser.get<>("--textures");
     return CLIArguments{
         .inputDirs     = parser.get<std::vector<std::string>>("--in"),
         .outputDir     = parser.get<>("-o"),
-        .indexFilepath = parser.get<>("--index")
+        .indexFilepath = parser.get<>("--index"),
+        .options       = PackageOptions{
+            .format = parser.get<>("--format") == "7z" ? PackageFormat::SevenZip
+                                                       : PackageFormat::Native,
+            .textureStorage = textures == "container" ? TextureStorage::Container
+                              : textures == "mips"    ? TextureStorage::ContainerWithMips
+                                                      : TextureStorage::PNG,
+            .reportTimings = parser.get<bool>("--timings")
+        }
     };
 }
 
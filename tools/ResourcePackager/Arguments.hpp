@@ -5,12 +5,15 @@
 #include <string>
 #include <vector>
 
+#include <ResourcePackager/Package.hpp>
+
 namespace re::rp {
 
 struct CLIArguments {
     std::vector<std::string> inputDirs;
     std::string outputDir;
     std::string indexFilepath;
+    PackageOptions options;
 };
 
 CLIArguments parseArguments(int argc, char* argv[]); // NOLINT(*-avoid-c-arrays)
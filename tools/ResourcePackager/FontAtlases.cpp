@@ -0,0 +1,106 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+#include <SDL_ttf.h>
+
+#include <RealEngine/graphics/fonts/FontAtlas.hpp>
+#include <RealEngine/resources/FileIO.hpp>
+#include <RealEngine/resources/PackageConstants.hpp>
+#include <RealEngine/utility/Error.hpp>
+
+#include <ResourcePackager/FontAtlases.hpp>
+
+namespace fs = std::filesystem;
+
+namespace re::rp {
+
+namespace {
+
+/**
+ * @brief Initializes SDL_ttf for the lifetime of the object
+ */
+class TTFLibrary {
+public:
+    TTFLibrary() {
+        if (TTF_Init() != 0) {
+            throw Exception{
+                std::format("Could not initialize SDL_ttf: {}", TTF_GetError())
+            };
+        }
+    }
+
+    TTFLibrary(const TTFLibrary&)            = delete; ///< Noncopyable
+    TTFLibrary& operator=(const TTFLibrary&) = delete; ///< Noncopyable
+
+    ~TTFLibrary() { TTF_Quit(); }
+};
+
+void precomputeAtlases(const fs::path& sidecar, const fs::path& cacheDir) {
+    std::string fontName = sidecar.filename().string();
+    fontName.resize(fontName.size() - k_fontAtlasesSuffix.size());
+    std::vector<unsigned char> ttf = readBinaryFile(sidecar.parent_path() / fontName);
+
+    auto variants = nlohmann::json::parse(readTextFile(sidecar));
+    for (const auto& variant : variants) {
+        std::vector<UnicodeRange> ranges;
+        if (variant.contains("ranges")) {
+            for (const auto& range : variant["ranges"]) {
+                ranges.emplace_back(
+                    range.at(0).get<char32_t>(), range.at(1).get<char32_t>()
+                );
+            }
+        } else {
+            ranges.assign(
+                k_asciiPrintableUnicodeRanges.begin(), k_asciiPrintableUnicodeRanges.end()
+            );
+        }
+        RasterizedFontCreateInfo createInfo{
+            .ttfBytes  = ttf,
+            .pointSize = variant.at("pointSize").get<int>(),
+            .faceIndex = variant.value("faceIndex", 0),
+            .ranges    = ranges
+        };
+        uint64_t key = FontAtlas::key(createInfo);
+        if (fs::exists(FontAtlas::cachePath(cacheDir.string(), key))) {
+            continue; // Already precomputed
+        }
+        FontAtlas::rasterize(createInfo).storeCached(cacheDir.string(), key);
+    }
+}
+
+} // namespace
+
+void precomputeFontAtlases(
+    std::span<const std::string> inputDirs, const std::string& outputDir
+) {
+    std::vector<fs::path> sidecars;
+    for (fs::path inputDir : inputDirs) {
+        for (const auto& entry : fs::recursive_directory_iterator{inputDir}) {
+            if (entry.is_regular_file() &&
+                entry.path().filename().string().ends_with(k_fontAtlasesSuffix)) {
+                sidecars.push_back(entry.path());
+            }
+        }
+    }
+    if (sidecars.empty()) {
+        return;
+    }
+
+    TTFLibrary ttfLibrary{};
+    fs::path cacheDir = fs::path{outputDir} / k_fontAtlasCacheDir;
+    for (const auto& sidecar : sidecars) {
+        try {
+            precomputeAtlases(sidecar, cacheDir);
+        } catch (const std::exception& e) {
+            throw Exception{std::format("{}: {}", sidecar.string(), e.what())};
+        }
+    }
+}
+
+} // namespace re::rp
@@ -0,0 +1,30 @@
+/**
+ *  @author    Dubsky Tomas
+ */
+#pragma once
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace re::rp {
+
+/**
+ * @brief Files with this suffix describe which atlases of the font should be
+ *        precomputed, the font is the file with the suffix removed
+ * @details The file contains a JSON array of objects with 'pointSize',
+ *          optional 'faceIndex' (0 by default) and optional 'ranges'
+ *          (printable ASCII by default) which is an array of inclusive
+ *          [first, last] pairs of Unicode code points.
+ */
+constexpr std::string_view k_fontAtlasesSuffix = ".atlases.json";
+
+/**
+ * @brief   Rasterizes the font atlases described by the sidecar files
+ *          in the input directories into the atlas cache in output directory
+ * @details Atlases that are already present in the cache are not rasterized again.
+ */
+void precomputeFontAtlases(
+    std::span<const std::string> inputDirs, const std::string& outputDir
+);
+
+} // namespace re::rp
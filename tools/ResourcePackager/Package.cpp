@@ -1,16 +1,38 @@
 ﻿/**
  *  @author    Dubsky Tomas
  */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <deque>
+#include <exception>
 #include <filesystem>
+#include <format>
 #include <fstream>
+#include <iostream>
+#include <optional>
+#include <unordered_map>
 
 #include <bit7z/bitfilecompressor.hpp>
 
+#include <RealEngine/jobs/JobSystem.hpp>
+#include <RealEngine/resources/BlockCompression.hpp>
+#include <RealEngine/resources/FileIO.hpp>
 #include <RealEngine/resources/PackageConstants.hpp>
+#include <RealEngine/resources/PackageFormat.hpp>
+#include <RealEngine/resources/PackageReader.hpp>
+#include <RealEngine/resources/PNGLoader.hpp>
+#include <RealEngine/resources/TextureContainer.hpp>
+#include <RealEngine/utility/Error.hpp>
+#include <RealEngine/utility/Math.hpp>
 
+#include <ResourcePackager/FontAtlases.hpp>
 #include <ResourcePackager/Package.hpp>
 
-namespace fs = std::filesystem;
+namespace fs  = std::filesystem;
+using Clock = std::chrono::steady_clock;
 
 namespace re::rp {
 
@@ -54,45 +76,399 @@ std::string toForwardSlash(const std::string& in) {
     return rval;
 }
 
-void composePackage(
-    std::span<const std::string> inputDirs, const std::string& outputDir,
-    const std::string& indexFilepath
-) {
-    // Prepare 7z
-    bit7z::Bit7zLibrary lib{default7ZipSharedLibLocation()};
-    bit7z::BitFileCompressor compressor{lib, bit7z::BitFormat::SevenZip};
-    compressor.setPassword(k_packageKey, true);
-    bit7z::BitOutputArchive outputArchive{compressor};
-    std::vector<std::string> index;
+/**
+ * @brief Compressed data is kept only if it is smaller by at least 1/this
+ */
+constexpr size_t k_minCompressionGain = 16;
+
+/**
+ * @brief Workers may prepare at most this many entries ahead of the writer
+ * @details Limits the memory occupied by prepared entries.
+ */
+constexpr size_t k_maxPreparedAhead = 64;
+
+struct InputFile {
+    fs::path path;
+    std::string indexedPath; ///< Relative path with forward slashes
+};
 
-    // Collect files the files
+std::vector<InputFile> collectInputFiles(std::span<const std::string> inputDirs) {
+    std::vector<InputFile> files;
     for (fs::path inputDir : inputDirs) {
         fs::path parentDir = inputDir.parent_path();
         for (const auto& entry : fs::recursive_directory_iterator{inputDir}) {
-            if (entry.is_regular_file()) {
-                // Replace path with index to obfuscate (path will not be used
-                // by runtime).
-                // It also ensures that the ordering within the zip stays the same.
-                std::string archivePath = std::format("{:0>6}", index.size());
-                // Add the file to archive
-                outputArchive.addFile(entry.path().string(), archivePath);
+            // Font atlas sidecars are consumed by the packager, not packaged
+            if (entry.is_regular_file() &&
+                !entry.path().filename().string().ends_with(k_fontAtlasesSuffix)) {
                 // Index path (with forward slashes as separator for consistency)
-                index.push_back(
+                files.emplace_back(
+                    entry.path(),
                     toForwardSlash(fs::relative(entry.path(), parentDir).string())
                 );
             }
         }
     }
+    // Directory iteration order is unspecified, sort to get deterministic IDs
+    std::ranges::sort(files, {}, &InputFile::indexedPath);
+    return files;
+}
+
+bool isPNG(const fs::path& path) {
+    std::string extension = path.extension().string();
+    std::ranges::transform(extension, extension.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return extension == ".png";
+}
+
+bool shouldTranscode(const InputFile& file, TextureStorage textureStorage) {
+    return textureStorage != TextureStorage::PNG && isPNG(file.path);
+}
+
+/**
+ * @brief Transcodes the contents of the file if it is a PNG that should be transcoded
+ */
+std::vector<unsigned char> transcode(
+    const InputFile& file, std::vector<unsigned char>&& bytes,
+    TextureStorage textureStorage
+) {
+    if (!shouldTranscode(file, textureStorage)) {
+        return std::move(bytes);
+    }
+    try {
+        return TextureContainer::encode(
+            PNGLoader::load(bytes),
+            textureStorage == TextureStorage::ContainerWithMips
+        );
+    } catch (const std::exception& e) {
+        throw Exception{std::format("{}: {}", file.path.string(), e.what())};
+    }
+}
+
+std::vector<unsigned char> readInputFile(
+    const InputFile& file, TextureStorage textureStorage
+) {
+    return transcode(file, readBinaryFile(file.path), textureStorage);
+}
+
+/**
+ * @brief Hashes the input file along with everything that affects its entry
+ */
+uint64_t hashInput(
+    const InputFile& file, std::span<const unsigned char> bytes,
+    TextureStorage textureStorage
+) {
+    uint64_t hash = package::hashContent(bytes);
+    if (shouldTranscode(file, textureStorage)) {
+        // The same PNG produces different entries if transcoded differently
+        std::array<uint32_t, 2> params{
+            static_cast<uint32_t>(textureStorage), TextureContainer::k_version
+        };
+        hash = package::hashContent(
+            {reinterpret_cast<const unsigned char*>(params.data()), sizeof(params)},
+            hash
+        );
+    }
+    return hash;
+}
+
+void writePadding(std::ofstream& out, uint64_t& pos, uint64_t alignment) {
+    for (uint64_t aligned = roundToMultiple(pos, alignment); pos < aligned; ++pos) {
+        out.put('\0');
+    }
+}
+
+/**
+ * @brief Holds entries of the previous package to reuse those of unchanged inputs
+ */
+class PreviousPackage {
+public:
+    explicit PreviousPackage(const fs::path& filepath) {
+        if (!fs::exists(filepath)) {
+            return;
+        }
+        try {
+            MappedFile file{filepath};
+            if (!PackageReader::isNativePackage(file.bytes())) {
+                return;
+            }
+            m_reader.emplace(std::move(file));
+            for (uint32_t i = 0; i < m_reader->entryCount(); ++i) {
+                package::Entry entry = m_reader->entry(i);
+                m_entries.emplace(entry.contentHash, entry);
+            }
+        } catch (const std::exception&) {
+            // Outdated or corrupted package, everything is packed from scratch
+            m_reader.reset();
+            m_entries.clear();
+        }
+    }
+
+    /**
+     * @brief Finds entry made from an input with given hash
+     * @return The entry and its stored bytes, or nothing if there is no such entry
+     */
+    std::optional<std::pair<package::Entry, std::span<const unsigned char>>> find(
+        uint64_t contentHash
+    ) const {
+        auto it = m_entries.find(contentHash);
+        if (it == m_entries.end()) {
+            return std::nullopt;
+        }
+        return std::pair{it->second, m_reader->storedBytes(it->second)};
+    }
+
+    /**
+     * @brief Unmaps the package so that it can be replaced
+     */
+    void close() {
+        m_entries.clear();
+        m_reader.reset();
+    }
+
+private:
+    std::optional<PackageReader> m_reader;
+    std::unordered_map<uint64_t, package::Entry> m_entries;
+};
+
+struct PreparedEntry {
+    package::Entry entry{};
+    std::vector<unsigned char> storedOwned;       ///< Newly made stored bytes
+    std::span<const unsigned char> storedReused; ///< From the previous package
+    bool reused = false;
+    Clock::duration duration{};
+    std::exception_ptr exception;
+    std::atomic<bool> ready = false;
+
+    std::span<const unsigned char> stored() const {
+        return reused ? storedReused : std::span{storedOwned};
+    }
+};
+
+void prepareEntry(
+    PreparedEntry& prepared, const InputFile& file, TextureStorage textureStorage,
+    const PreviousPackage& previous
+) {
+    auto start = Clock::now();
+    std::vector<unsigned char> input = readBinaryFile(file.path);
+    uint64_t hash                    = hashInput(file, input, textureStorage);
+    if (auto reusable = previous.find(hash)) {
+        // The input has not changed, reuse its entry
+        std::tie(prepared.entry, prepared.storedReused) = *reusable;
+        prepared.reused                                 = true;
+    } else {
+        std::vector<unsigned char> original =
+            transcode(file, std::move(input), textureStorage);
+        std::vector<unsigned char> compressed = compressLZ4Block(original);
+        // Already compressed formats (e.g. PNG) are better left stored
+        bool keepCompressed = compressed.size() + original.size() / k_minCompressionGain <
+                              original.size();
+        prepared.entry = package::Entry{
+            .storedSize   = keepCompressed ? compressed.size() : original.size(),
+            .originalSize = original.size(),
+            .compression  = keepCompressed ? package::Compression::LZ4
+                                           : package::Compression::Stored,
+            .contentHash = hash
+        };
+        prepared.storedOwned = keepCompressed ? std::move(compressed) : std::move(original);
+    }
+    prepared.duration = Clock::now() - start;
+}
+
+struct FileTiming {
+    Clock::duration duration{};
+    bool reused = false;
+};
+
+void reportTimings(
+    std::span<const InputFile> files, std::span<const FileTiming> timings,
+    Clock::duration total
+) {
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    Clock::duration work{};
+    size_t reusedCount = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        std::cout << std::format(
+            "{:>10.3f} ms  {}  {}\n", Milliseconds{timings[i].duration}.count(),
+            timings[i].reused ? "reused" : "packed", files[i].indexedPath
+        );
+        work += timings[i].duration;
+        reusedCount += timings[i].reused;
+    }
+    std::cout << std::format(
+        "Packaged {} files ({} reused) in {:.3f} ms, {:.3f} ms of work "
+        "({:.2f}x parallel speedup)\n",
+        files.size(), reusedCount, Milliseconds{total}.count(),
+        Milliseconds{work}.count(),
+        total.count() > 0 ? Milliseconds{work} / Milliseconds{total} : 1.0
+    );
+}
+
+void composeNativePackage(
+    std::span<const InputFile> files, const fs::path& outputFilepath,
+    const PackageOptions& options
+) {
+    auto start = Clock::now();
+    PreviousPackage previous{outputFilepath};
+
+    // The previous package stays mapped so the new one is written aside
+    fs::path tempFilepath = outputFilepath;
+    tempFilepath += ".tmp";
+    std::ofstream out{tempFilepath, std::ios::binary | std::ios::trunc};
+    if (!out) {
+        throw Exception{std::format("Could not open {}", tempFilepath.string())};
+    }
+
+    // The temporary file is removed if the package cannot be composed
+    std::vector<FileTiming> timings(files.size());
+    try {
+        // The header is rewritten at the end, once the table offset is known
+        package::Header header{.entryCount = static_cast<uint32_t>(files.size())};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        std::vector<package::Entry> table;
+        table.reserve(files.size());
+        uint64_t pos = sizeof(header);
+
+        // Workers prepare the entries in parallel, this thread writes them in order
+        std::vector<PreparedEntry> prepared(files.size());
+        std::atomic<size_t> nextToPrepare = 0;
+        std::atomic<size_t> written       = 0;
+        auto work = [&] {
+            for (size_t i = nextToPrepare++; i < files.size(); i = nextToPrepare++) {
+                // Do not get too far ahead of the writer
+                for (size_t w = written; i >= w + k_maxPreparedAhead; w = written) {
+                    written.wait(w);
+                }
+                try {
+                    prepareEntry(prepared[i], files[i], options.textureStorage, previous);
+                } catch (...) { prepared[i].exception = std::current_exception(); }
+                prepared[i].ready = true;
+                prepared[i].ready.notify_one();
+            }
+        };
+        JobSystem& jobSystem = JobSystem::shared();
+        JobCounter workers;
+        for (unsigned int i = 0; i < jobSystem.workerCount(); ++i) {
+            jobSystem.schedule(work, &workers);
+        }
+
+        try {
+            for (size_t i = 0; i < files.size(); ++i) {
+                PreparedEntry& entry = prepared[i];
+                entry.ready.wait(false);
+                if (entry.exception) {
+                    std::rethrow_exception(entry.exception);
+                }
+
+                writePadding(out, pos, package::k_entryAlignment);
+                auto stored        = entry.stored();
+                entry.entry.offset = pos;
+                table.push_back(entry.entry);
+                out.write(
+                    reinterpret_cast<const char*>(stored.data()),
+                    static_cast<std::streamsize>(stored.size())
+                );
+                pos += stored.size();
+                timings[i] = FileTiming{entry.duration, entry.reused};
+
+                // Release the memory and let the workers continue
+                entry.storedOwned = {};
+                written           = i + 1;
+                written.notify_all();
+            }
+        } catch (...) {
+            // Make the workers finish as soon as possible
+            nextToPrepare = files.size();
+            written       = files.size();
+            written.notify_all();
+            jobSystem.wait(workers);
+            throw;
+        }
+        jobSystem.wait(workers);
+
+        // Write the entry table
+        writePadding(out, pos, alignof(package::Entry));
+        header.tableOffset = pos;
+        out.write(
+            reinterpret_cast<const char*>(table.data()),
+            static_cast<std::streamsize>(table.size() * sizeof(package::Entry))
+        );
+
+        // Write the header
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.close();
+        if (!out) {
+            throw Exception{std::format("Could not write {}", tempFilepath.string())};
+        }
+    } catch (...) {
+        out.close();
+        std::error_code ec;
+        fs::remove(tempFilepath, ec);
+        throw;
+    }
+
+    // Replace the previous package
+    previous.close();
+    fs::rename(tempFilepath, outputFilepath);
+
+    if (options.reportTimings) {
+        reportTimings(files, timings, Clock::now() - start);
+    }
+}
+
+void composeSevenZipPackage(
+    std::span<const InputFile> files, const fs::path& outputFilepath,
+    TextureStorage textureStorage
+) {
+    // Prepare 7z
+    bit7z::Bit7zLibrary lib{default7ZipSharedLibLocation()};
+    bit7z::BitFileCompressor compressor{lib, bit7z::BitFormat::SevenZip};
+    compressor.setPassword(k_packageKey, true);
+    bit7z::BitOutputArchive outputArchive{compressor};
+    std::deque<std::vector<bit7z::byte_t>> transcoded; // Must outlive the compression
+
+    for (size_t i = 0; i < files.size(); ++i) {
+        // Replace path with index to obfuscate (path will not be used
+        // by runtime).
+        // It also ensures that the ordering within the zip stays the same.
+        std::string archivePath = std::format("{:0>6}", i);
+        // Add the file to archive
+        if (textureStorage != TextureStorage::PNG && isPNG(files[i].path)) {
+            auto& bytes = transcoded.emplace_back(readInputFile(files[i], textureStorage));
+            outputArchive.addFile(bytes, archivePath);
+        } else {
+            outputArchive.addFile(files[i].path.string(), archivePath);
+        }
+    }
 
     // Delete previous package and create the new package
-    auto outputFilepath = fs::path{outputDir} / k_packageName;
     fs::remove(outputFilepath);
     outputArchive.compressTo(outputFilepath.string());
+}
+
+void composePackage(
+    std::span<const std::string> inputDirs, const std::string& outputDir,
+    const std::string& indexFilepath, const PackageOptions& options
+) {
+    // Collect the files
+    std::vector<InputFile> files = collectInputFiles(inputDirs);
+
+    // Create the package
+    auto outputFilepath = fs::path{outputDir} / k_packageName;
+    switch (options.format) {
+    case PackageFormat::Native:
+        composeNativePackage(files, outputFilepath, options);
+        break;
+    case PackageFormat::SevenZip:
+        composeSevenZipPackage(files, outputFilepath, options.textureStorage);
+        break;
+    }
 
     // Compose C++ index
     std::string idsString;
-    for (uint32_t i = 0; i < static_cast<uint32_t>(index.size()); ++i) {
-        idsString += std::format(k_textureIDFormatString, index[i], i);
+    for (uint32_t i = 0; i < static_cast<uint32_t>(files.size()); ++i) {
+        idsString += std::format(k_textureIDFormatString, files[i].indexedPath, i);
     }
     std::string indexContents = std::format(k_indexFileFormatString, idsString);
 
@@ -7,9 +7,39 @@
 
 namespace re::rp {
 
+/**
+ * @brief Formats of the package that can be composed
+ */
+enum class PackageFormat {
+    Native,  ///< Engine-native, memory-mappable format (see re::package)
+    SevenZip ///< Legacy compressed and 'encrypted' 7z archive
+};
+
+/**
+ * @brief Specifies how PNG images are stored in the package
+ */
+enum class TextureStorage {
+    PNG,              ///< Stored as they are, decoded at runtime
+    Container,        ///< Transcoded to GPU-ready re::TextureContainer
+    ContainerWithMips ///< Transcoded to re::TextureContainer with full mip chain
+};
+
+struct PackageOptions {
+    PackageFormat format          = PackageFormat::Native;
+    TextureStorage textureStorage = TextureStorage::PNG;
+    bool reportTimings = false; ///< Prints time spent on each file
+};
+
+/**
+ * @brief   Packages all files from the input directories and writes their index
+ * @details Files are packaged in order of their indexed paths so the IDs are
+ *          deterministic. Native packages are composed incrementally - entries
+ *          of unchanged files are copied from the previous package, other
+ *          files are compressed in parallel.
+ */
 void composePackage(
     std::span<const std::string> inputDirs, const std::string& outputDir,
-    const std::string& indexFilepath
+    const std::string& indexFilepath, const PackageOptions& options
 );
 
 } // namespace re::rp